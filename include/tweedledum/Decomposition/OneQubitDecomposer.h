@@ -58,7 +58,7 @@ private:
     static inline double add_rx(
       Circuit& circuit, Instruction const& inst, double angle, double atol);
 
-    static inline void add_ry(
+    static inline double add_ry(
       Circuit& circuit, Instruction const& inst, double angle, double atol);
 
     static inline double add_rz(
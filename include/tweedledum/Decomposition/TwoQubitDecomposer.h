@@ -0,0 +1,54 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../IR/Circuit.h"
+#include "../IR/Instruction.h"
+#include "../Utils/Matrix.h"
+#include "OneQubitDecomposer.h"
+
+#include <nlohmann/json.hpp>
+
+namespace tweedledum {
+
+/*! \brief Decomposes two-qubit unitaries into, at most three, CX operators.
+ *
+ * A 4x4 unitary U is written, using the KAK (Cartan) decomposition, as
+ *
+ *     U = e^{i phase} (A1 x A0) exp(i(a XX + b YY + c ZZ)) (B1 x B0)
+ *
+ * with (a, b, c) in the Weyl chamber: pi/4 >= a >= b >= |c|.  These
+ * coordinates determine the number of CX operators needed: 0 for (0, 0, 0),
+ * 1 for (pi/4, 0, 0), 2 when c = 0, and 3 otherwise.  The interaction is
+ * implemented with a fixed circuit of that many CX operators and the
+ * one-qubit operators are decomposed with `OneQubitDecomposer` (configured
+ * with the same `config`.)
+ */
+class TwoQubitDecomposer {
+public:
+    struct Config {
+        // Tolerance used when comparing the coordinates, and checking the
+        // final circuit.
+        double atol;
+
+        Config(nlohmann::json const& config);
+    };
+    Config config;
+
+    TwoQubitDecomposer(nlohmann::json const& config = {})
+        : config(config)
+        , one_qubit_decomposer_(config)
+    {}
+
+    // Number of CX operators needed to implement the 4x4 `matrix`.
+    uint32_t num_cx(UMatrix const& matrix) const;
+
+    bool decompose(Circuit& circuit, Instruction const& inst);
+
+private:
+    OneQubitDecomposer one_qubit_decomposer_;
+};
+
+} // namespace tweedledum
@@ -197,10 +197,10 @@ inline Circuit carry_ripple_adder_inplace(uint32_t n)
     std::vector<Qubit> a_qubits;
     std::vector<Qubit> b_qubits;
     for (uint32_t i = 0; i < n; ++i) {
-        a_qubits.push_back(circuit.create_qubit(fmt::format("a{}", i)));
+        a_qubits.push_back(circuit.create_qubit("a", i));
     }
     for (uint32_t i = 0; i < n; ++i) {
-        b_qubits.push_back(circuit.create_qubit(fmt::format("b{}", i)));
+        b_qubits.push_back(circuit.create_qubit("b", i));
     }
     Qubit carry = circuit.create_qubit();
     carry_ripple_adder_inplace_ttk(circuit, a_qubits, b_qubits, carry);
@@ -110,10 +110,10 @@ inline Circuit less_than(uint32_t n)
     std::vector<Qubit> a_qubits;
     std::vector<Qubit> b_qubits;
     for (uint32_t i = 0; i < n; ++i) {
-        a_qubits.push_back(circuit.create_qubit(fmt::format("a{}", i)));
+        a_qubits.push_back(circuit.create_qubit("a", i));
     }
     for (uint32_t i = 0; i < n; ++i) {
-        b_qubits.push_back(circuit.create_qubit(fmt::format("b{}", i)));
+        b_qubits.push_back(circuit.create_qubit("b", i));
     }
     Qubit carry = circuit.create_qubit();
     less_than(circuit, a_qubits, b_qubits, carry);
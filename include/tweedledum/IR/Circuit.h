@@ -4,14 +4,23 @@
 *-----------------------------------------------------------------------------*/
 #pragma once
 
+#include "../Utils/Allocators.h"
+#include "../Utils/ThreadPool.h"
 #include "Cbit.h"
 #include "Instruction.h"
+#include "InstructionColumns.h"
+#include "InstructionTable.h"
 #include "Qubit.h"
+#include "StructuralHash.h"
+#include "SuccessorIndex.h"
 #include "WireStorage.h"
 
 #include <cassert>
-#include <fmt/format.h>
+#include <algorithm>
+#include <initializer_list>
+#include <limits>
 #include <memory>
+#include <optional>
 #include <utility>
 #include <vector>
 
@@ -44,7 +53,15 @@ public:
         return num_instructions();
     }
 
+    // Number of (non-removed) instructions.  See in-place editing.
     uint32_t num_instructions() const
+    {
+        return instructions_.size() - (edits_ ? edits_->num_removed : 0u);
+    }
+
+    // Upper bound (exclusive) of the references to instructions.  Same as
+    // `num_instructions()` unless the circuit was edited in place.
+    uint32_t num_refs() const
     {
         return instructions_.size();
     }
@@ -54,30 +71,188 @@ public:
         return free_ancillae_.size();
     }
 
+    // Columnar storage
+    //
+    // When enabled, the circuit keeps a structure-of-arrays mirror of its
+    // instructions (see `InstructionColumns`) in sync as new instructions are
+    // added.  Traversals that only need instruction references, such as
+    // `foreach_child` with a `InstRef` callback, will then use the columns.
+    //
+    // Editing a circuit in place suspends the columns until `compact()`.
+    void enable_columns()
+    {
+        if (edits_) {
+            edits_->rebuild_columns = true;
+            return;
+        }
+        if (columns_) {
+            return;
+        }
+        columns_.emplace();
+        columns_->reserve(instructions_.capacity());
+        for (Instruction const& inst : instructions_) {
+            columns_->push_back(inst);
+        }
+    }
+
+    void disable_columns()
+    {
+        if (edits_) {
+            edits_->rebuild_columns = false;
+        }
+        columns_.reset();
+    }
+
+    bool has_columns() const
+    {
+        return columns_.has_value();
+    }
+
+    InstructionColumns const& columns() const
+    {
+        assert(columns_);
+        return *columns_;
+    }
+
+    // Incremental layers
+    //
+    // When enabled, the circuit keeps the ASAP layer of each instruction (see
+    // `compute_asap_layers`) and the number of instructions in each layer up
+    // to date, so that `depth()` is O(1).  Appending an instruction costs
+    // O(#wires).  In-place edits update the layers of the instructions that
+    // follow the edit, walking forward in program order until the last
+    // instruction whose layer changed.
+    void enable_layers()
+    {
+        if (layers_) {
+            return;
+        }
+        layers_.emplace();
+        layers_->layer.resize(num_refs(), 0u);
+        foreach_instruction(
+          [&](InstRef const ref) { layers_->add(ref, compute_layer(ref)); });
+    }
+
+    void disable_layers()
+    {
+        layers_.reset();
+    }
+
+    bool has_layers() const
+    {
+        return layers_.has_value();
+    }
+
+    uint32_t layer(InstRef ref) const
+    {
+        assert(layers_);
+        return layers_->layer.at(ref);
+    }
+
+    // Number of layers
+    uint32_t depth() const
+    {
+        assert(layers_);
+        return layers_->depth;
+    }
+
+    // Number of layers up to the last instruction on a wire.
+    uint32_t depth(Qubit qubit) const
+    {
+        return wire_depth(last_instruction_.at(wire_index(qubit)));
+    }
+
+    uint32_t depth(Cbit cbit) const
+    {
+        return wire_depth(last_instruction_.at(wire_index(cbit)));
+    }
+
+    // Instruction attributes
+    //
+    // Named per-instruction tables (see `InstructionTable`), e.g., layers,
+    // durations or fidelities, which are computed once and then shared among
+    // passes.  The circuit keeps the tables sized to `num_refs()`: entries of
+    // new instructions get the table's default value, and `compact()` moves
+    // the entries along with their instructions.  Other edits don't change
+    // the values, it is up to the passes to keep them meaningful.
+    //
+    // A table can only be accessed with the type it was created with, trying
+    // another type throws `std::invalid_argument`.
+    template<typename T>
+    InstructionTable<T>& attribute(
+      std::string_view name, T const& default_value = T())
+    {
+        return attributes_.get_or_create<T>(name, num_refs(), default_value);
+    }
+
+    // Returns `nullptr` if the circuit has no such attribute.
+    template<typename T>
+    InstructionTable<T> const* find_attribute(std::string_view name) const
+    {
+        return attributes_.find<T>(name);
+    }
+
+    void remove_attribute(std::string_view name)
+    {
+        attributes_.erase(name);
+    }
+
+    // Operator arena
+    //
+    // When enabled, operators that are too big to be stored inline in an
+    // instruction (e.g. `Op::TruthTable`) are allocated from an arena owned by
+    // the circuit, instead of one heap allocation per operator.  The memory is
+    // released in bulk when the circuit is destroyed.  Instructions that were
+    // added before enabling the arena are not affected.
+    //
+    // Copies of a circuit get their own (empty) arena.
+    void enable_arena()
+    {
+        arena_.enable();
+    }
+
+    bool has_arena() const
+    {
+        return arena_.get() != nullptr;
+    }
+
+    BumpAllocator const* arena() const
+    {
+        return arena_.get();
+    }
+
     // Wires
+    //
+    // Names are stored compressed, as a register name and an index, e.g.,
+    // `create_qubit("a", 3)` creates a qubit named `a3`.  Names given in full
+    // are split at their trailing digits (see `detail::WireNames`.)
     Qubit create_qubit(std::string_view name)
     {
-        last_instruction_.emplace(
-          last_instruction_.begin() + num_qubits(), InstRef::invalid());
+        add_qubit();
         return do_create_qubit(name);
     }
 
+    Qubit create_qubit(std::string_view register_name, uint32_t index)
+    {
+        add_qubit();
+        return do_create_qubit(register_name, index);
+    }
+
     Qubit create_qubit()
     {
-        std::string const name = fmt::format("__q{}", num_qubits());
-        return create_qubit(name);
+        return create_qubit("__q", num_qubits());
     }
 
     void create_ancilla()
     {
-        Qubit const qubit = create_qubit(fmt::format("__a{}", num_qubits()));
+        Qubit const qubit = create_qubit("__a", num_qubits());
         free_ancillae_.push_back(qubit);
     }
 
     Qubit request_ancilla()
     {
         if (free_ancillae_.empty()) {
-            return create_qubit(fmt::format("__a{}", num_qubits()));
+            return create_qubit("__a", num_qubits());
         } else {
             Qubit qubit = free_ancillae_.back();
             free_ancillae_.pop_back();
@@ -93,41 +268,69 @@ public:
 
     Cbit create_cbit(std::string_view name)
     {
-        last_instruction_.emplace_back(InstRef::invalid());
+        add_cbit();
         return do_create_cbit(name);
     }
 
+    Cbit create_cbit(std::string_view register_name, uint32_t index)
+    {
+        add_cbit();
+        return do_create_cbit(register_name, index);
+    }
+
     Cbit create_cbit()
     {
-        std::string const name = fmt::format("__c{}", num_cbits());
-        return create_cbit(name);
+        return create_cbit("__c", num_cbits());
     }
 
     // Instructions
+    //
+    // Wires can be given as vectors, as braced lists, e.g.
+    // `apply_operator(Op::X(), {q0, q1})`, or as spans over any contiguous
+    // container.  The two latter forms do not allocate temporaries: the wires
+    // are copied directly into the instruction.
     template<typename OpT>
     InstRef apply_operator(OpT&& optor, std::vector<Qubit> const& qubits,
       std::vector<Cbit> const& cbits = {})
     {
-        Instruction& inst =
-          instructions_.emplace_back(std::forward<OpT>(optor), qubits, cbits);
+        return apply_operator(std::forward<OpT>(optor),
+          Span<Qubit const>(qubits), Span<Cbit const>(cbits));
+    }
+
+    template<typename OpT>
+    InstRef apply_operator(OpT&& optor, std::initializer_list<Qubit> qubits,
+      std::initializer_list<Cbit> cbits = {})
+    {
+        return apply_operator(std::forward<OpT>(optor),
+          Span<Qubit const>(qubits.begin(), qubits.size()),
+          Span<Cbit const>(cbits.begin(), cbits.size()));
+    }
+
+    template<typename OpT>
+    InstRef apply_operator(
+      OpT&& optor, Span<Qubit const> qubits, Span<Cbit const> cbits = {})
+    {
+        Instruction& inst = instructions_.emplace_back(
+          std::forward<OpT>(optor), qubits, cbits, arena_.get());
         connect_instruction(inst);
-        return InstRef(num_instructions() - 1);
+        return InstRef(num_refs() - 1);
     }
 
     InstRef apply_operator(Instruction const& optor,
       std::vector<Qubit> const& qubits, std::vector<Cbit> const& cbits = {})
     {
-        Instruction& inst = instructions_.emplace_back(optor, qubits, cbits);
+        Instruction& inst =
+          instructions_.emplace_back(optor, qubits, cbits, arena_.get());
         connect_instruction(inst);
-        return InstRef(num_instructions() - 1);
+        return InstRef(num_refs() - 1);
     }
 
     // FIXME: maybe remove this, if so need to change the python bindings!
     InstRef apply_operator(Instruction const& optor)
     {
-        Instruction& inst = instructions_.emplace_back(optor);
+        Instruction& inst = instructions_.emplace_back(optor, arena_.get());
         connect_instruction(inst);
-        return InstRef(num_instructions() - 1);
+        return InstRef(num_refs() - 1);
     }
 
     // Composition
@@ -138,20 +341,209 @@ public:
         assert(other.num_qubits() == qubits.size());
 
         other.foreach_instruction([&](Instruction const& inst) {
-            std::vector<Qubit> this_qubits;
+            // Copy the instruction and remap its wires in place.
+            Instruction& new_inst =
+              instructions_.emplace_back(inst, arena_.get());
+            for (auto& [qubit, _] : new_inst.qubits_conns_) {
+                qubit = qubit.polarity() == Qubit::Polarity::positive
+                        ? qubits.at(qubit)
+                        : !qubits.at(qubit);
+            }
+            for (auto& [cbit, _] : new_inst.cbits_conns_) {
+                cbit = cbits.at(cbit);
+            }
+            assert(new_inst.num_qubits() > 0);
+            connect_instruction(new_inst);
+        });
+    }
+
+    // In-place editing
+    //
+    // Instructions can be removed, replaced by a sequence of instructions, and
+    // new ones can be inserted before or after existing ones, without
+    // rebuilding the circuit.  Wire links (children, successors and outputs)
+    // are kept consistent, and references to instructions remain valid.
+    // Traversals follow the program order and skip removed instructions.
+    //
+    // An edited circuit is not compact: removed instructions are kept as
+    // tombstones and new ones are stored at the end.  `compact()` drops the
+    // tombstones and renumbers the instructions in program order.  Until then,
+    // references can be larger than `num_instructions()`, hence analyses and
+    // passes that index per-instruction data by `InstRef` size it with
+    // `num_refs()`.  (Views still require a compact circuit.)
+    //
+    // Edits are proportional to the number of wires of the instructions
+    // involved, except for inserting an instruction acting on a wire that
+    // the instruction at the insertion point does not act on.  In that case we
+    // walk backwards in program order to find the instruction's child.
+    bool is_compact() const
+    {
+        return !edits_.has_value();
+    }
+
+    bool is_removed(InstRef ref) const
+    {
+        return edits_ && edits_->removed.at(ref);
+    }
+
+    void remove_instruction(InstRef ref)
+    {
+        assert(!is_removed(ref));
+        begin_edit();
+        SuccessorIndex& index = mutable_successor_index();
+        Instruction& inst = instructions_.at(ref);
+        uint32_t const after = edits_->next.at(ref);
+        SmallVector<InstRef, 4> successors;
+        index.foreach_successor(ref,
+          [&](InstRef const successor) { successors.push_back(successor); });
+        auto unlink = [&](auto const wire, InstRef const child) {
+            InstRef const successor = index.successor(ref, wire);
+            if (successor == InstRef::invalid()) {
+                last_instruction_.at(wire_index(wire)) = child;
+            } else {
+                *find_child(successor, wire) = child;
+            }
+            index.link(child, wire, successor);
+        };
+        for (auto const& [qubit, child] : inst.qubits_conns_) {
+            unlink(qubit, child);
+        }
+        for (auto const& [cbit, child] : inst.cbits_conns_) {
+            unlink(cbit, child);
+        }
+        edits_->unlink(ref);
+        edits_->removed.at(ref) = 1u;
+        edits_->num_removed += 1;
+        if (layers_) {
+            layers_->remove(ref);
+            update_layers(after, successors);
+        }
+    }
+
+    template<typename OpT>
+    InstRef insert_before(InstRef pos, OpT&& optor, Span<Qubit const> qubits,
+      Span<Cbit const> cbits = {})
+    {
+        assert(!is_removed(pos));
+        begin_edit();
+        return insert(edits_->prev.at(pos), pos, std::forward<OpT>(optor),
+          qubits, cbits);
+    }
+
+    template<typename OpT>
+    InstRef insert_before(InstRef pos, OpT&& optor,
+      std::initializer_list<Qubit> qubits, std::initializer_list<Cbit> cbits = {})
+    {
+        return insert_before(pos, std::forward<OpT>(optor),
+          Span<Qubit const>(qubits.begin(), qubits.size()),
+          Span<Cbit const>(cbits.begin(), cbits.size()));
+    }
+
+    template<typename OpT>
+    InstRef insert_after(InstRef pos, OpT&& optor, Span<Qubit const> qubits,
+      Span<Cbit const> cbits = {})
+    {
+        assert(!is_removed(pos));
+        begin_edit();
+        return insert(pos, edits_->next.at(pos), std::forward<OpT>(optor),
+          qubits, cbits);
+    }
+
+    template<typename OpT>
+    InstRef insert_after(InstRef pos, OpT&& optor,
+      std::initializer_list<Qubit> qubits, std::initializer_list<Cbit> cbits = {})
+    {
+        return insert_after(pos, std::forward<OpT>(optor),
+          Span<Qubit const>(qubits.begin(), qubits.size()),
+          Span<Cbit const>(cbits.begin(), cbits.size()));
+    }
+
+    // Replaces the instruction `ref` by the instructions of `replacement`,
+    // whose wires are mapped to `qubits` and `cbits` (as in `append`).
+    void replace_instruction(InstRef ref, Circuit const& replacement,
+      std::vector<Qubit> const& qubits, std::vector<Cbit> const& cbits = {})
+    {
+        assert(replacement.num_cbits() == cbits.size());
+        assert(replacement.num_qubits() == qubits.size());
+        SmallVector<Qubit, 4> this_qubits;
+        SmallVector<Cbit, 2> this_cbits;
+        replacement.foreach_instruction([&](Instruction const& inst) {
+            this_qubits.clear();
             inst.foreach_qubit([&](Qubit qubit) {
-                Qubit const new_qubit =
+                this_qubits.push_back(
                   qubit.polarity() == Qubit::Polarity::positive
                     ? qubits.at(qubit)
-                    : !qubits.at(qubit);
-                this_qubits.push_back(new_qubit);
+                    : !qubits.at(qubit));
             });
-            std::vector<Cbit> this_cbits;
+            this_cbits.clear();
             inst.foreach_cbit(
               [&](Cbit cbit) { this_cbits.push_back(cbits.at(cbit)); });
-            assert(!this_qubits.empty());
-            apply_operator(inst, this_qubits, this_cbits);
+            insert_before(ref, inst, Span<Qubit const>(this_qubits),
+              Span<Cbit const>(this_cbits));
         });
+        remove_instruction(ref);
+    }
+
+    // Drops removed instructions and renumbers the remaining ones in program
+    // order.  Invalidates all references to instructions.
+    void compact()
+    {
+        if (!edits_) {
+            return;
+        }
+        constexpr uint32_t no_ref = std::numeric_limits<uint32_t>::max();
+        std::vector<uint32_t> new_ref(instructions_.size(), no_ref);
+        std::vector<Instruction> compacted;
+        compacted.reserve(std::max<size_t>(num_instructions(), 1024u));
+        for (uint32_t i = edits_->head; i != no_ref; i = edits_->next.at(i)) {
+            new_ref.at(i) = compacted.size();
+            compacted.push_back(std::move(instructions_.at(i)));
+        }
+        auto remap = [&](InstRef& ref) {
+            if (ref == InstRef::invalid()) {
+                return;
+            }
+            ref.uid_ = new_ref.at(ref);
+        };
+        for (Instruction& inst : compacted) {
+            for (auto& [_, child] : inst.qubits_conns_) {
+                remap(child);
+            }
+            for (auto& [_, child] : inst.cbits_conns_) {
+                remap(child);
+            }
+        }
+        for (InstRef& ref : last_instruction_) {
+            remap(ref);
+        }
+        attributes_.remap(new_ref, compacted.size());
+        instructions_ = std::move(compacted);
+        successors_.reset();
+        hashes_.reset();
+        bool const rebuild_columns = edits_->rebuild_columns;
+        edits_.reset();
+        if (rebuild_columns) {
+            enable_columns();
+        }
+        if (layers_) {
+            layers_.reset();
+            enable_layers();
+        }
+    }
+
+    // Replaces the operator of the instruction `ref`, keeping its wires.  The
+    // new operator must have the same number of targets.
+    template<typename OpT>
+    void set_operator(InstRef ref, OpT&& optor)
+    {
+        Instruction& inst = instructions_.at(ref);
+        hashes_.reset();
+        [[maybe_unused]] uint32_t const num_targets = inst.num_targets();
+        static_cast<Operator&>(inst) = std::forward<OpT>(optor);
+        assert(inst.num_targets() == num_targets);
+        if (columns_) {
+            columns_->update_operator(ref, inst);
+        }
     }
 
     Instruction const& instruction(InstRef ref) const
@@ -184,6 +576,27 @@ public:
         }
     }
 
+    // Input: the first instruction of each wire
+    template<typename Fn>
+    void foreach_input(Fn&& fn) const
+    {
+        // clang-format off
+        static_assert(std::is_invocable_r_v<void, Fn, InstRef> ||
+                      std::is_invocable_r_v<void, Fn, Instruction const&> ||
+                      std::is_invocable_r_v<void, Fn, InstRef, Instruction const&>);
+        // clang-format on
+        successor_index().foreach_input([&](InstRef const ref) {
+            if constexpr (std::is_invocable_r_v<void, Fn, InstRef>) {
+                fn(ref);
+            } else if constexpr (std::is_invocable_r_v<void, Fn,
+                                   Instruction const&>) {
+                fn(instructions_.at(ref));
+            } else {
+                fn(ref, instructions_.at(ref));
+            }
+        });
+    }
+
     template<typename Fn>
     void foreach_instruction(Fn&& fn) const
     {
@@ -192,6 +605,20 @@ public:
                       std::is_invocable_r_v<void, Fn, Instruction const&> ||
                       std::is_invocable_r_v<void, Fn, InstRef, Instruction const&>);
         // clang-format on
+        if (edits_) {
+            for (uint32_t i = edits_->head; i != Edits::none;
+                 i = edits_->next.at(i)) {
+                if constexpr (std::is_invocable_r_v<void, Fn, InstRef>) {
+                    fn(InstRef(i));
+                } else if constexpr (std::is_invocable_r_v<void, Fn,
+                                       Instruction const&>) {
+                    fn(instructions_.at(i));
+                } else {
+                    fn(InstRef(i), instructions_.at(i));
+                }
+            }
+            return;
+        }
         for (uint32_t i = 0u; i < num_instructions(); ++i) {
             if constexpr (std::is_invocable_r_v<void, Fn, InstRef>) {
                 fn(InstRef(i));
@@ -212,6 +639,20 @@ public:
                       std::is_invocable_r_v<void, Fn, Instruction const&> ||
                       std::is_invocable_r_v<void, Fn, InstRef, Instruction const&>);
         // clang-format on
+        if (edits_) {
+            for (uint32_t i = edits_->tail; i != Edits::none;
+                 i = edits_->prev.at(i)) {
+                if constexpr (std::is_invocable_r_v<void, Fn, InstRef>) {
+                    fn(InstRef(i));
+                } else if constexpr (std::is_invocable_r_v<void, Fn,
+                                       Instruction const&>) {
+                    fn(instructions_.at(i));
+                } else {
+                    fn(InstRef(i), instructions_.at(i));
+                }
+            }
+            return;
+        }
         for (uint32_t i = num_instructions(); i-- > 0u;) {
             if constexpr (std::is_invocable_r_v<void, Fn, InstRef>) {
                 fn(InstRef(i));
@@ -224,6 +665,71 @@ public:
         }
     }
 
+    // Visits the instructions layer by layer (ASAP layers, see
+    // `compute_asap_layers`), calling `fn` on the instructions of a layer
+    // concurrently, using the threads of `pool`.  All calls on a layer return
+    // before the next layer starts, so when `fn` is called on an instruction,
+    // it has returned for all of the instruction's ancestors.
+    //
+    // `fn` must be safe to call concurrently on different instructions of the
+    // same layer, e.g. it may write to its own instruction's entry of an
+    // `InstructionTable`.  The circuit must not be modified meanwhile.
+    template<typename Fn>
+    void parallel_foreach_layer(ThreadPool& pool, Fn&& fn) const
+    {
+        // clang-format off
+        static_assert(std::is_invocable_r_v<void, Fn, InstRef> ||
+                      std::is_invocable_r_v<void, Fn, Instruction const&> ||
+                      std::is_invocable_r_v<void, Fn, InstRef, Instruction const&>);
+        // clang-format on
+        // Bucket the instructions by layer (counting sort)
+        std::vector<uint32_t> computed;
+        if (!layers_) {
+            computed.resize(num_refs(), 0u);
+            foreach_instruction([&](InstRef const ref) {
+                uint32_t layer = 0u;
+                foreach_child(ref, [&](InstRef const child) {
+                    layer = std::max(layer, computed.at(child) + 1);
+                });
+                computed.at(ref) = layer;
+            });
+        }
+        auto layer_of = [&](InstRef const ref) {
+            return layers_ ? layers_->layer.at(ref) : computed.at(ref);
+        };
+        std::vector<uint32_t> offset;
+        foreach_instruction([&](InstRef const ref) {
+            uint32_t const layer = layer_of(ref);
+            if (offset.size() <= layer + 1) {
+                offset.resize(layer + 2, 0u);
+            }
+            offset.at(layer + 1) += 1;
+        });
+        for (uint32_t i = 1u; i < offset.size(); ++i) {
+            offset.at(i) += offset.at(i - 1);
+        }
+        std::vector<InstRef> order(num_instructions(), InstRef::invalid());
+        std::vector<uint32_t> fill(offset);
+        foreach_instruction([&](InstRef const ref) {
+            order.at(fill.at(layer_of(ref))++) = ref;
+        });
+
+        for (uint32_t layer = 0u; layer + 1 < offset.size(); ++layer) {
+            pool.parallel_for(
+              offset.at(layer), offset.at(layer + 1), [&](uint32_t const i) {
+                  InstRef const ref = order[i];
+                  if constexpr (std::is_invocable_r_v<void, Fn, InstRef>) {
+                      fn(ref);
+                  } else if constexpr (std::is_invocable_r_v<void, Fn,
+                                         Instruction const&>) {
+                      fn(instructions_[ref]);
+                  } else {
+                      fn(ref, instructions_[ref]);
+                  }
+              });
+        }
+    }
+
     template<typename Fn>
     void foreach_child(InstRef ref, Fn&& fn) const
     {
@@ -232,6 +738,12 @@ public:
                       std::is_invocable_r_v<void, Fn, Instruction const&> ||
                       std::is_invocable_r_v<void, Fn, InstRef, Instruction const&>);
         // clang-format on
+        if constexpr (std::is_invocable_r_v<void, Fn, InstRef>) {
+            if (columns_) {
+                columns_->foreach_child(ref, fn);
+                return;
+            }
+        }
         Instruction const& inst = instructions_.at(ref);
         inst.foreach_cbit([&](InstRef const iref) {
             if constexpr (std::is_invocable_r_v<void, Fn, InstRef>) {
@@ -255,7 +767,83 @@ public:
         });
     }
 
-    // This methods are needed for the python bindings
+    // The successors of an instruction, i.e., the next instruction on each one
+    // of its wires.  (The opposite of `foreach_child`.)
+    //
+    // The successor index is built lazily, the first time it is needed, and
+    // then kept up to date as the circuit changes.  Hence, the first call is
+    // O(#instructions), and must not happen concurrently with other calls.
+    template<typename Fn>
+    void foreach_successor(InstRef ref, Fn&& fn) const
+    {
+        // clang-format off
+        static_assert(std::is_invocable_r_v<void, Fn, InstRef> ||
+                      std::is_invocable_r_v<void, Fn, Instruction const&> ||
+                      std::is_invocable_r_v<void, Fn, InstRef, Instruction const&>);
+        // clang-format on
+        successor_index().foreach_successor(ref, [&](InstRef const sref) {
+            if constexpr (std::is_invocable_r_v<void, Fn, InstRef>) {
+                fn(sref);
+            } else if constexpr (std::is_invocable_r_v<void, Fn,
+                                   Instruction const&>) {
+                fn(instructions_.at(sref));
+            } else {
+                fn(sref, instructions_.at(sref));
+            }
+        });
+    }
+
+    SuccessorIndex const& successor_index() const
+    {
+        if (!successors_) {
+            Span<uint8_t const> removed;
+            if (edits_) {
+                removed = edits_->removed;
+            }
+            successors_.emplace(
+              instructions_, num_qubits(), num_cbits(), removed);
+        }
+        return *successors_;
+    }
+
+    // Structural hash
+    //
+    // A hash of the circuit's wires, global phase and instruction DAG (see
+    // `StructuralHash`), meant to key caches on circuit content.  Circuits
+    // that only differ in the order of independent instructions have the same
+    // hash.
+    //
+    // As the successor index, the hashes of the instructions are computed
+    // lazily, the first time they are needed, and then kept up to date as new
+    // instructions are added.  Editing a circuit in place, which may change
+    // the hashes of all instructions that follow the edit, drops them.
+    uint64_t structural_hash() const
+    {
+        uint64_t seed = structural_hashes().value();
+        hash_combine(seed, num_qubits());
+        hash_combine(seed, num_cbits());
+        hash_combine(seed, hash_double(global_phase_));
+        return seed;
+    }
+
+    // The hash of the sub-circuit (cone) of all instructions leading to `ref`.
+    uint64_t structural_hash(InstRef ref) const
+    {
+        return structural_hashes().node(ref);
+    }
+
+    StructuralHash const& structural_hashes() const
+    {
+        if (!hashes_) {
+            hashes_.emplace();
+            foreach_instruction(
+              [&](InstRef const ref) { hashes_->add(ref, instructions_); });
+        }
+        return *hashes_;
+    }
+
+    // This methods are needed for the python bindings.  They expect a compact
+    // circuit.
     auto py_begin() const
     {
         return instructions_.begin();
@@ -269,9 +857,77 @@ public:
 private:
     friend class BaseView;
 
+    // Owns the (optional) operator arena.  The arena must outlive the
+    // instructions, and be handed over together with them:
+    //   - copy construction: instructions are cloned on the heap, so the copy
+    //     starts with a fresh arena.
+    //   - copy assignment: we keep our arena, as our old instructions might
+    //     still be alive.
+    //   - move: the arenas are swapped, so that our old instructions are
+    //     destroyed before the arena they live in.
+    class Arena {
+    public:
+        Arena() = default;
+
+        Arena(Arena const& other)
+        {
+            if (other.arena_) {
+                enable();
+            }
+        }
+
+        Arena(Arena&& other) noexcept = default;
+
+        Arena& operator=(Arena const& other)
+        {
+            if (other.arena_) {
+                enable();
+            }
+            return *this;
+        }
+
+        Arena& operator=(Arena&& other) noexcept
+        {
+            std::swap(arena_, other.arena_);
+            return *this;
+        }
+
+        void enable()
+        {
+            if (!arena_) {
+                arena_ = std::make_unique<BumpAllocator>();
+            }
+        }
+
+        BumpAllocator* get() const
+        {
+            return arena_.get();
+        }
+
+    private:
+        std::unique_ptr<BumpAllocator> arena_;
+    };
+
+    void add_qubit()
+    {
+        last_instruction_.emplace(
+          last_instruction_.begin() + num_qubits(), InstRef::invalid());
+        if (successors_) {
+            successors_->add_qubit();
+        }
+    }
+
+    void add_cbit()
+    {
+        last_instruction_.emplace_back(InstRef::invalid());
+        if (successors_) {
+            successors_->add_cbit();
+        }
+    }
+
     void connect_instruction(Instruction& inst)
     {
-        uint32_t const inst_uid = num_instructions() - 1;
+        uint32_t const inst_uid = num_refs() - 1;
         for (auto& [wref, iref] : inst.qubits_conns_) {
             iref = last_instruction_.at(wref);
             last_instruction_.at(wref).uid_ = inst_uid;
@@ -280,12 +936,291 @@ private:
             iref = last_instruction_.at(wref + num_qubits());
             last_instruction_.at(wref + num_qubits()).uid_ = inst_uid;
         }
+        if (columns_) {
+            columns_->push_back(inst);
+        }
+        if (successors_) {
+            InstRef const ref(inst_uid);
+            successors_->push_back(inst);
+            for (auto const& [qubit, child] : inst.qubits_conns_) {
+                successors_->link(child, qubit, ref);
+            }
+            for (auto const& [cbit, child] : inst.cbits_conns_) {
+                successors_->link(child, cbit, ref);
+            }
+        }
+        if (edits_) {
+            edits_->push_back(edits_->tail, Edits::none);
+        }
+        if (hashes_) {
+            hashes_->add(InstRef(inst_uid), instructions_);
+        }
+        if (!attributes_.empty()) {
+            attributes_.resize(num_refs());
+        }
+        if (layers_) {
+            InstRef const ref(inst_uid);
+            layers_->layer.resize(num_refs(), 0u);
+            layers_->add(ref, compute_layer(ref));
+        }
+    }
+
+    // ASAP layers, and the number of instructions in each layer.
+    struct Layers {
+        void add(InstRef const ref, uint32_t const new_layer)
+        {
+            layer.at(ref) = new_layer;
+            if (count.size() <= new_layer) {
+                count.resize(new_layer + 1, 0u);
+            }
+            count.at(new_layer) += 1;
+            depth = std::max(depth, new_layer + 1);
+        }
+
+        void remove(InstRef const ref)
+        {
+            count.at(layer.at(ref)) -= 1;
+            while (depth > 0u && count.at(depth - 1) == 0u) {
+                --depth;
+            }
+        }
+
+        std::vector<uint32_t> layer;
+        std::vector<uint32_t> count;
+        std::vector<uint8_t> pending;
+        uint32_t depth = 0u;
+    };
+
+    uint32_t compute_layer(InstRef const ref) const
+    {
+        uint32_t result = 0u;
+        foreach_child(ref, [&](InstRef const child) {
+            result = std::max(result, layers_->layer.at(child) + 1);
+        });
+        return result;
+    }
+
+    uint32_t wire_depth(InstRef const last) const
+    {
+        assert(layers_);
+        return last == InstRef::invalid() ? 0u : layers_->layer.at(last) + 1;
+    }
+
+    // Recomputes the layers of `seeds`, and then of the successors of the
+    // instructions whose layer changed.  Program order is a topological
+    // order, so a single forward walk starting at `start` (which must come
+    // before all seeds) suffices.
+    void update_layers(uint32_t const start, Span<InstRef const> seeds)
+    {
+        std::vector<uint8_t>& pending = layers_->pending;
+        pending.resize(num_refs(), 0u);
+        uint32_t num_pending = 0u;
+        auto mark = [&](InstRef const ref) {
+            if (!pending.at(ref)) {
+                pending.at(ref) = 1u;
+                ++num_pending;
+            }
+        };
+        for (InstRef const ref : seeds) {
+            mark(ref);
+        }
+        SuccessorIndex const& index = successor_index();
+        for (uint32_t i = start; i != Edits::none && num_pending > 0u;
+             i = edits_->next.at(i)) {
+            if (!pending.at(i)) {
+                continue;
+            }
+            pending.at(i) = 0u;
+            --num_pending;
+            InstRef const ref(i);
+            uint32_t const new_layer = compute_layer(ref);
+            if (new_layer == layers_->layer.at(ref)) {
+                continue;
+            }
+            layers_->remove(ref);
+            layers_->add(ref, new_layer);
+            index.foreach_successor(ref, mark);
+        }
+    }
+
+    // Program order and tombstones of an edited circuit.
+    struct Edits {
+        static constexpr uint32_t none = std::numeric_limits<uint32_t>::max();
+
+        explicit Edits(uint32_t const num_instructions)
+            : head(num_instructions ? 0u : none)
+            , tail(num_instructions ? num_instructions - 1 : none)
+            , removed(num_instructions, 0u)
+        {
+            next.reserve(num_instructions);
+            prev.reserve(num_instructions);
+            for (uint32_t i = 0u; i < num_instructions; ++i) {
+                next.push_back(i + 1 < num_instructions ? i + 1 : none);
+                prev.push_back(i > 0u ? i - 1 : none);
+            }
+        }
+
+        // Adds a new instruction in between `before` and `after`
+        void push_back(uint32_t const before, uint32_t const after)
+        {
+            uint32_t const ref = next.size();
+            next.push_back(after);
+            prev.push_back(before);
+            removed.push_back(0u);
+            (before == none ? head : next.at(before)) = ref;
+            (after == none ? tail : prev.at(after)) = ref;
+        }
+
+        void unlink(uint32_t const ref)
+        {
+            uint32_t const before = prev.at(ref);
+            uint32_t const after = next.at(ref);
+            (before == none ? head : next.at(before)) = after;
+            (after == none ? tail : prev.at(after)) = before;
+            next.at(ref) = none;
+            prev.at(ref) = none;
+        }
+
+        uint32_t head;
+        uint32_t tail;
+        std::vector<uint32_t> next;
+        std::vector<uint32_t> prev;
+        std::vector<uint8_t> removed;
+        uint32_t num_removed = 0u;
+        bool rebuild_columns = false;
+    };
+
+    void begin_edit()
+    {
+        hashes_.reset();
+        if (edits_) {
+            return;
+        }
+        edits_.emplace(instructions_.size());
+        if (columns_) {
+            columns_.reset();
+            edits_->rebuild_columns = true;
+        }
+    }
+
+    SuccessorIndex& mutable_successor_index()
+    {
+        successor_index();
+        return *successors_;
+    }
+
+    uint32_t wire_index(Qubit const qubit) const
+    {
+        return qubit.uid();
+    }
+
+    uint32_t wire_index(Cbit const cbit) const
+    {
+        return num_qubits() + cbit.uid();
+    }
+
+    // Inserts a new instruction in between `before` and `after` (in program
+    // order, either can be invalid.)
+    template<typename OpT>
+    InstRef insert(uint32_t const before, uint32_t const after, OpT&& optor,
+      Span<Qubit const> qubits, Span<Cbit const> cbits)
+    {
+        SuccessorIndex& index = mutable_successor_index();
+        instructions_.emplace_back(
+          std::forward<OpT>(optor), qubits, cbits, arena_.get());
+        InstRef const ref(instructions_.size() - 1);
+        edits_->push_back(before, after);
+        if (!attributes_.empty()) {
+            attributes_.resize(num_refs());
+        }
+        index.push_back(instructions_.back());
+
+        auto connect = [&](auto const wire, InstRef& child) {
+            // The child is the last instruction on the wire before the
+            // insertion point.  Check the neighbors first.
+            child = InstRef::invalid();
+            InstRef const pos_before =
+              before == Edits::none ? InstRef::invalid() : InstRef(before);
+            InstRef const pos_after =
+              after == Edits::none ? InstRef::invalid() : InstRef(after);
+            if (!(pos_before == InstRef::invalid())
+                && find_child(pos_before, wire) != nullptr) {
+                child = pos_before;
+            } else if (!(pos_after == InstRef::invalid())
+                       && find_child(pos_after, wire) != nullptr) {
+                child = *find_child(pos_after, wire);
+            } else {
+                for (uint32_t i = before; i != Edits::none;
+                     i = edits_->prev.at(i)) {
+                    if (find_child(InstRef(i), wire) != nullptr) {
+                        child = InstRef(i);
+                        break;
+                    }
+                }
+            }
+            InstRef const successor = child == InstRef::invalid()
+                                      ? index.input(wire)
+                                      : index.successor(child, wire);
+            if (successor == InstRef::invalid()) {
+                last_instruction_.at(wire_index(wire)) = ref;
+            } else {
+                *find_child(successor, wire) = ref;
+            }
+            index.link(child, wire, ref);
+            index.link(ref, wire, successor);
+        };
+        Instruction& inst = instructions_.back();
+        for (auto& [qubit, child] : inst.qubits_conns_) {
+            connect(qubit, child);
+        }
+        for (auto& [cbit, child] : inst.cbits_conns_) {
+            connect(cbit, child);
+        }
+        if (layers_) {
+            layers_->layer.resize(num_refs(), 0u);
+            layers_->add(ref, compute_layer(ref));
+            SmallVector<InstRef, 4> successors;
+            index.foreach_successor(ref, [&](InstRef const successor) {
+                successors.push_back(successor);
+            });
+            update_layers(after, successors);
+        }
+        return ref;
+    }
+
+    // Returns a pointer to the child of `ref` on `wire`, or `nullptr` if `ref`
+    // does not act on `wire`.
+    InstRef* find_child(InstRef const ref, Qubit const qubit)
+    {
+        for (auto& [wire, child] : instructions_.at(ref).qubits_conns_) {
+            if (wire.uid() == qubit.uid()) {
+                return &child;
+            }
+        }
+        return nullptr;
+    }
+
+    InstRef* find_child(InstRef const ref, Cbit const cbit)
+    {
+        for (auto& [wire, child] : instructions_.at(ref).cbits_conns_) {
+            if (wire == cbit) {
+                return &child;
+            }
+        }
+        return nullptr;
     }
 
+    Arena arena_; // Must be declared before (destroyed after) instructions_
     std::vector<Instruction> instructions_;
     std::vector<InstRef> last_instruction_; // last instruction on a wire
     std::vector<Qubit> free_ancillae_; // Should this be here?!
     double global_phase_;
+    std::optional<InstructionColumns> columns_;
+    mutable std::optional<SuccessorIndex> successors_;
+    mutable std::optional<StructuralHash> hashes_;
+    std::optional<Edits> edits_;
+    detail::InstructionAttributes attributes_;
+    std::optional<Layers> layers_;
 };
 
 } // namespace tweedledum
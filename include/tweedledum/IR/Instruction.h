@@ -5,6 +5,7 @@
 #pragma once
 
 #include "../Utils/SmallVector.h"
+#include "../Utils/Span.h"
 #include "Operator.h"
 #include "WireStorage.h"
 
@@ -51,40 +52,48 @@ private:
 
 class Instruction : public Operator {
 public:
+    // If given, operators that do not fit inline are allocated in `arena`,
+    // which must outlive the instruction.
     template<typename OpT>
-    Instruction(OpT&& optor, std::vector<Qubit> const& qubits,
-      std::vector<Cbit> const& cbits)
-        : Operator(std::forward<OpT>(optor))
+    Instruction(OpT&& optor, Span<Qubit const> qubits, Span<Cbit const> cbits,
+      BumpAllocator* arena = nullptr)
+        : Operator(std::forward<OpT>(optor), arena)
     {
-        for (Qubit qubit : qubits) {
-            qubits_conns_.emplace_back(qubit, InstRef::invalid());
-        }
-        for (Cbit cbit : cbits) {
-            cbits_conns_.emplace_back(cbit, InstRef::invalid());
-        }
-        assert(qubits_conns_.size() >= this->num_targets());
+        add_wires(qubits, cbits);
     }
 
-    // This is called by realloc!!
     Instruction(Instruction const& other)
         : Operator(static_cast<Operator const&>(other))
         , qubits_conns_(other.qubits_conns_)
         , cbits_conns_(other.cbits_conns_)
     {}
 
-    Instruction(Instruction const& other, std::vector<Qubit> const& qubits,
-      std::vector<Cbit> const& cbits)
-        : Operator(static_cast<Operator const&>(other))
+    // This is called by realloc!!  It must be noexcept, otherwise
+    // `std::vector<Instruction>` falls back to copying (cloning) every
+    // operator when it grows.
+    Instruction(Instruction&& other) noexcept
+        : Operator(static_cast<Operator&&>(other))
+        , qubits_conns_(std::move(other.qubits_conns_))
+        , cbits_conns_(std::move(other.cbits_conns_))
+    {}
+
+    Instruction(Instruction const& other, BumpAllocator* arena)
+        : Operator(static_cast<Operator const&>(other), arena)
+        , qubits_conns_(other.qubits_conns_)
+        , cbits_conns_(other.cbits_conns_)
+    {}
+
+    Instruction(Instruction const& other, Span<Qubit const> qubits,
+      Span<Cbit const> cbits, BumpAllocator* arena = nullptr)
+        : Operator(static_cast<Operator const&>(other), arena)
     {
-        for (Qubit qubit : qubits) {
-            qubits_conns_.emplace_back(qubit, InstRef::invalid());
-        }
-        for (Cbit cbit : cbits) {
-            cbits_conns_.emplace_back(cbit, InstRef::invalid());
-        }
-        assert(qubits_conns_.size() >= this->num_targets());
+        add_wires(qubits, cbits);
     }
 
+    Instruction& operator=(Instruction const& other) = default;
+
+    Instruction& operator=(Instruction&& other) = default;
+
     uint32_t num_controls() const
     {
         return qubits_conns_.size() - this->num_targets();
@@ -239,6 +248,19 @@ public:
     }
 
 private:
+    void add_wires(Span<Qubit const> qubits, Span<Cbit const> cbits)
+    {
+        qubits_conns_.reserve(qubits.size());
+        for (Qubit qubit : qubits) {
+            qubits_conns_.emplace_back(qubit, InstRef::invalid());
+        }
+        cbits_conns_.reserve(cbits.size());
+        for (Cbit cbit : cbits) {
+            cbits_conns_.emplace_back(cbit, InstRef::invalid());
+        }
+        assert(qubits_conns_.size() >= this->num_targets());
+    }
+
     struct QubitConnection {
         Qubit qubit;
         InstRef inst_ref;
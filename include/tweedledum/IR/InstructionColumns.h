@@ -0,0 +1,206 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../Utils/Span.h"
+#include "Cbit.h"
+#include "Instruction.h"
+#include "Qubit.h"
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+#include <string_view>
+#include <vector>
+
+namespace tweedledum {
+
+/*! \brief Columnar (structure-of-arrays) storage of a circuit's instructions.
+ *
+ * An `Instruction` is a fat object: a type-erased operator plus two small
+ * vectors of wire connections.  Passes that only look at the structure of a
+ * circuit (which kind of operator, acting on which wires, depending on which
+ * instructions) end up dragging all of that through the cache.  This class
+ * stores the same information in flat columns:
+ *
+ *   - kind: the operator kind identifier (see `OperatorKind.h`)
+ *   - parameter: the operator's angle (NaN if it does not have one)
+ *   - qubits/cbits: wires in compressed sparse row (CSR) layout
+ *   - qubit/cbit children: the predecessor instruction on each wire
+ *
+ * The columns are a mirror of the instructions, which still own the operators.
+ */
+class InstructionColumns {
+public:
+    InstructionColumns()
+        : qubits_offset_(1, 0u)
+        , cbits_offset_(1, 0u)
+    {}
+
+    uint32_t num_instructions() const
+    {
+        return kind_.size();
+    }
+
+    void reserve(uint32_t const size)
+    {
+        kind_.reserve(size);
+        num_targets_.reserve(size);
+        parameter_.reserve(size);
+        qubits_offset_.reserve(size + 1);
+        cbits_offset_.reserve(size + 1);
+    }
+
+    void clear()
+    {
+        kind_.clear();
+        num_targets_.clear();
+        parameter_.clear();
+        qubits_offset_.assign(1, 0u);
+        qubits_.clear();
+        qubits_children_.clear();
+        cbits_offset_.assign(1, 0u);
+        cbits_.clear();
+        cbits_children_.clear();
+    }
+
+    void push_back(Instruction const& inst)
+    {
+        kind_.push_back(inst.kind_id());
+        num_targets_.push_back(inst.num_targets());
+        std::optional<double> const angle = inst.angle();
+        parameter_.push_back(
+          angle ? *angle : std::numeric_limits<double>::quiet_NaN());
+        inst.foreach_qubit([&](Qubit const qubit, InstRef const child) {
+            qubits_.push_back(qubit);
+            qubits_children_.push_back(child);
+        });
+        qubits_offset_.push_back(qubits_.size());
+        inst.foreach_cbit([&](Cbit const cbit, InstRef const child) {
+            cbits_.push_back(cbit);
+            cbits_children_.push_back(child);
+        });
+        cbits_offset_.push_back(cbits_.size());
+    }
+
+    // Updates the operator's columns after `ref`'s operator was replaced.
+    // (The wires must be the same.)
+    void update_operator(InstRef const ref, Instruction const& inst)
+    {
+        assert(ref < num_instructions());
+        kind_[ref] = inst.kind_id();
+        num_targets_[ref] = inst.num_targets();
+        std::optional<double> const angle = inst.angle();
+        parameter_[ref] =
+          angle ? *angle : std::numeric_limits<double>::quiet_NaN();
+    }
+
+    // Kinds
+    uint32_t kind_id(InstRef const ref) const
+    {
+        assert(ref < num_instructions());
+        return kind_[ref];
+    }
+
+    std::string_view kind(InstRef const ref) const
+    {
+        return operator_kind_name(kind_id(ref));
+    }
+
+    // Parameters
+    bool has_parameter(InstRef const ref) const
+    {
+        return !std::isnan(parameter(ref));
+    }
+
+    double parameter(InstRef const ref) const
+    {
+        assert(ref < num_instructions());
+        return parameter_[ref];
+    }
+
+    // Wires
+    uint32_t num_qubits(InstRef const ref) const
+    {
+        assert(ref < num_instructions());
+        return qubits_offset_[ref + 1] - qubits_offset_[ref];
+    }
+
+    uint32_t num_cbits(InstRef const ref) const
+    {
+        assert(ref < num_instructions());
+        return cbits_offset_[ref + 1] - cbits_offset_[ref];
+    }
+
+    uint32_t num_wires(InstRef const ref) const
+    {
+        return num_qubits(ref) + num_cbits(ref);
+    }
+
+    uint32_t num_targets(InstRef const ref) const
+    {
+        assert(ref < num_instructions());
+        return num_targets_[ref];
+    }
+
+    uint32_t num_controls(InstRef const ref) const
+    {
+        return num_qubits(ref) - num_targets(ref);
+    }
+
+    Span<Qubit const> qubits(InstRef const ref) const
+    {
+        return {qubits_.data() + qubits_offset_[ref], num_qubits(ref)};
+    }
+
+    Span<Cbit const> cbits(InstRef const ref) const
+    {
+        return {cbits_.data() + cbits_offset_[ref], num_cbits(ref)};
+    }
+
+    // Predecessors (children) of the instruction on each one of its wires,
+    // aligned with `qubits(ref)` and `cbits(ref)`.
+    Span<InstRef const> qubits_children(InstRef const ref) const
+    {
+        return {qubits_children_.data() + qubits_offset_[ref], num_qubits(ref)};
+    }
+
+    Span<InstRef const> cbits_children(InstRef const ref) const
+    {
+        return {cbits_children_.data() + cbits_offset_[ref], num_cbits(ref)};
+    }
+
+    // Same visiting order as `Circuit::foreach_child`: first cbits, then qubits.
+    template<typename Fn>
+    void foreach_child(InstRef const ref, Fn&& fn) const
+    {
+        static_assert(std::is_invocable_r_v<void, Fn, InstRef>);
+        for (InstRef const child : cbits_children(ref)) {
+            if (child == InstRef::invalid()) {
+                continue;
+            }
+            fn(child);
+        }
+        for (InstRef const child : qubits_children(ref)) {
+            if (child == InstRef::invalid()) {
+                continue;
+            }
+            fn(child);
+        }
+    }
+
+private:
+    std::vector<uint32_t> kind_;
+    std::vector<uint32_t> num_targets_;
+    std::vector<double> parameter_;
+    std::vector<uint32_t> qubits_offset_;
+    std::vector<Qubit> qubits_;
+    std::vector<InstRef> qubits_children_;
+    std::vector<uint32_t> cbits_offset_;
+    std::vector<Cbit> cbits_;
+    std::vector<InstRef> cbits_children_;
+};
+
+} // namespace tweedledum
@@ -0,0 +1,259 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../Utils/Span.h"
+#include "Instruction.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tweedledum {
+
+/*! \brief Per-instruction data, indexed by `InstRef`.
+ *
+ * A table can be used on its own, e.g. as scratch space in a pass, or be
+ * attached to a circuit as a named attribute (see `Circuit::attribute`), in
+ * which case the circuit keeps its size in sync with the instructions.
+ *
+ * Entries of new instructions get the table's default value.  (Use `uint8_t`
+ * instead of `bool`, as `std::vector<bool>` can't hand out references.)
+ */
+template<typename T>
+class InstructionTable {
+    static_assert(!std::is_same_v<T, bool>);
+
+public:
+    explicit InstructionTable(T const& default_value = T())
+        : default_value_(default_value)
+    {}
+
+    InstructionTable(uint32_t const size, T const& default_value)
+        : default_value_(default_value)
+        , data_(size, default_value)
+    {}
+
+    uint32_t size() const
+    {
+        return data_.size();
+    }
+
+    T const& default_value() const
+    {
+        return default_value_;
+    }
+
+    T& operator[](InstRef const ref)
+    {
+        assert(ref < data_.size());
+        return data_[ref];
+    }
+
+    T const& operator[](InstRef const ref) const
+    {
+        assert(ref < data_.size());
+        return data_[ref];
+    }
+
+    T& at(InstRef const ref)
+    {
+        return data_.at(ref);
+    }
+
+    T const& at(InstRef const ref) const
+    {
+        return data_.at(ref);
+    }
+
+    // Sets all entries to the default value.
+    void reset()
+    {
+        std::fill(data_.begin(), data_.end(), default_value_);
+    }
+
+    void resize(uint32_t const size)
+    {
+        data_.resize(size, default_value_);
+    }
+
+    Span<T const> values() const
+    {
+        return data_;
+    }
+
+    // Moves the entry of each instruction `i` to `new_ref[i]`, dropping the
+    // entries whose new reference is invalid.
+    void remap(std::vector<uint32_t> const& new_ref, uint32_t const new_size)
+    {
+        std::vector<T> remapped(new_size, default_value_);
+        for (uint32_t i = 0u; i < data_.size() && i < new_ref.size(); ++i) {
+            if (new_ref[i] < new_size) {
+                remapped[new_ref[i]] = std::move(data_[i]);
+            }
+        }
+        data_ = std::move(remapped);
+    }
+
+private:
+    T default_value_;
+    std::vector<T> data_;
+};
+
+namespace detail {
+// Named instruction tables of a circuit.  Tables are type-erased, a table can
+// only be accessed with the type it was created with.
+class InstructionAttributes {
+public:
+    InstructionAttributes() = default;
+
+    InstructionAttributes(InstructionAttributes const& other)
+    {
+        for (Entry const& entry : other.entries_) {
+            entries_.push_back({entry.name, entry.table->clone()});
+        }
+    }
+
+    InstructionAttributes(InstructionAttributes&& other) noexcept = default;
+
+    InstructionAttributes& operator=(InstructionAttributes const& other)
+    {
+        if (this != &other) {
+            InstructionAttributes copy(other);
+            entries_ = std::move(copy.entries_);
+        }
+        return *this;
+    }
+
+    InstructionAttributes& operator=(
+      InstructionAttributes&& other) noexcept = default;
+
+    bool empty() const
+    {
+        return entries_.empty();
+    }
+
+    template<typename T>
+    InstructionTable<T>& get_or_create(std::string_view const name,
+      uint32_t const size, T const& default_value)
+    {
+        if (InstructionTable<T>* table = find<T>(name)) {
+            return *table;
+        }
+        auto model = std::make_unique<Model<T>>(size, default_value);
+        InstructionTable<T>& table = model->table;
+        entries_.push_back({std::string(name), std::move(model)});
+        return table;
+    }
+
+    // Returns `nullptr` if there is no table named `name`.  Throws
+    // `std::invalid_argument` if there is one, but of another type.
+    template<typename T>
+    InstructionTable<T>* find(std::string_view const name) const
+    {
+        for (Entry const& entry : entries_) {
+            if (entry.name != name) {
+                continue;
+            }
+            if (entry.table->type() != type_key<T>()) {
+                throw std::invalid_argument(
+                  "Instruction attribute '" + entry.name
+                  + "' was created with another type");
+            }
+            return &static_cast<Model<T>*>(entry.table.get())->table;
+        }
+        return nullptr;
+    }
+
+    void erase(std::string_view const name)
+    {
+        entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                         [&](Entry const& entry) { return entry.name == name; }),
+          entries_.end());
+    }
+
+    void resize(uint32_t const size)
+    {
+        for (Entry& entry : entries_) {
+            entry.table->resize(size);
+        }
+    }
+
+    void remap(std::vector<uint32_t> const& new_ref, uint32_t const new_size)
+    {
+        for (Entry& entry : entries_) {
+            entry.table->remap(new_ref, new_size);
+        }
+    }
+
+private:
+    // One object per type, its address identifies the type.
+    template<typename T>
+    static void const* type_key()
+    {
+        static char const key = 0;
+        return &key;
+    }
+
+    struct Concept {
+        virtual ~Concept() = default;
+        virtual void const* type() const = 0;
+        virtual std::unique_ptr<Concept> clone() const = 0;
+        virtual void resize(uint32_t size) = 0;
+        virtual void remap(
+          std::vector<uint32_t> const& new_ref, uint32_t new_size) = 0;
+    };
+
+    template<typename T>
+    struct Model : public Concept {
+        Model(uint32_t const size, T const& default_value)
+            : table(size, default_value)
+        {}
+
+        explicit Model(InstructionTable<T> const& other)
+            : table(other)
+        {}
+
+        void const* type() const override
+        {
+            return type_key<T>();
+        }
+
+        std::unique_ptr<Concept> clone() const override
+        {
+            return std::make_unique<Model>(table);
+        }
+
+        void resize(uint32_t const size) override
+        {
+            table.resize(size);
+        }
+
+        void remap(std::vector<uint32_t> const& new_ref,
+          uint32_t const new_size) override
+        {
+            table.remap(new_ref, new_size);
+        }
+
+        InstructionTable<T> table;
+    };
+
+    struct Entry {
+        std::string name;
+        std::unique_ptr<Concept> table;
+    };
+
+    std::vector<Entry> entries_;
+};
+} // namespace detail
+
+} // namespace tweedledum
@@ -5,9 +5,13 @@
 #pragma once
 
 #include "../Operators/Meta.h"
+#include "../Utils/Allocators.h"
+#include "../Utils/Hash.h"
 #include "../Utils/Matrix.h"
+#include "OperatorKind.h"
 #include "OperatorTraits.h"
 
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string_view>
@@ -26,18 +30,23 @@ class Instruction;
 // creating a copy of the original ConcreteOp object on the heap (or on the
 // stack if the object is small enough).
 //
+// Objects that do not fit on the stack can be optionally allocated from an
+// arena (see `Circuit::enable_arena`), in which case the operator only runs
+// the object's destructor, and the arena is responsible for the memory.
+//
 class Operator {
 public:
     // clang-format off
     template<typename ConcreteOp,
              std::enable_if_t<!std::is_same_v<Operator, remove_cvref_t<ConcreteOp>>, bool> = true>
-    Operator(ConcreteOp&& op) noexcept
+    Operator(ConcreteOp&& op, BumpAllocator* arena = nullptr) noexcept
     {
         using ConcreteType = remove_cvref_t<ConcreteOp>;
         static_assert(!std::is_same_v<ConcreteType, Instruction>);
         constexpr bool is_small = sizeof(Model<ConcreteType, true>) <= small_size;
-        new (&model_) Model<ConcreteType, is_small>(std::forward<ConcreteOp>(op));
+        new (&model_) Model<ConcreteType, is_small>(std::forward<ConcreteOp>(op), arena);
         concept_ = &Model<ConcreteType, is_small>::vtable_;
+        kind_id_ = operator_kind_id<ConcreteType>();
     }
 
     template<typename ConcreteOp,
@@ -48,16 +57,18 @@ public:
         static_assert(!std::is_same_v<ConcreteType, Instruction>);
         constexpr bool is_small = sizeof(Model<ConcreteType, true>) <= small_size;
         concept_->dtor(&model_);
-        new (&model_) Model<ConcreteType, is_small>(std::forward<ConcreteOp>(op));
+        new (&model_) Model<ConcreteType, is_small>(std::forward<ConcreteOp>(op), nullptr);
         concept_ = &Model<ConcreteType, is_small>::vtable_;
+        kind_id_ = operator_kind_id<ConcreteType>();
         return *this;
     }
     // clang-format on
 
-    Operator(Operator const& other) noexcept
+    Operator(Operator const& other, BumpAllocator* arena = nullptr) noexcept
     {
         concept_ = other.concept_;
-        concept_->clone(&other.model_, &model_);
+        kind_id_ = other.kind_id_;
+        concept_->clone(&other.model_, &model_, arena);
     }
 
     Operator& operator=(Operator const& other) noexcept
@@ -69,14 +80,33 @@ public:
         concept_->dtor(&model_);
 
         concept_ = other.concept_;
-        concept_->clone(&other.model_, &model_);
+        kind_id_ = other.kind_id_;
+        concept_->clone(&other.model_, &model_, nullptr);
         return *this;
     }
 
-    // TODO: I need to think a bit better about move!!
-    Operator(Operator&& other) = delete;
+    // A moved-from operator can only be destroyed or assigned to.  (Heap
+    // models give away their payload instead of cloning it.)
+    Operator(Operator&& other) noexcept
+    {
+        concept_ = other.concept_;
+        kind_id_ = other.kind_id_;
+        concept_->move(&other.model_, &model_);
+    }
+
+    Operator& operator=(Operator&& other) noexcept
+    {
+        // Guard self assignment
+        if (this == &other) {
+            return *this;
+        }
+        concept_->dtor(&model_);
 
-    Operator& operator=(Operator&& other) = delete;
+        concept_ = other.concept_;
+        kind_id_ = other.kind_id_;
+        concept_->move(&other.model_, &model_);
+        return *this;
+    }
 
     ~Operator()
     {
@@ -93,6 +123,17 @@ public:
         return concept_->kind(&model_);
     };
 
+    // See `OperatorKind.h`
+    uint32_t kind_id() const
+    {
+        return kind_id_;
+    }
+
+    std::optional<double> angle() const
+    {
+        return concept_->angle(&model_);
+    }
+
     std::string_view name() const
     {
         std::string_view the_kind = kind();
@@ -115,10 +156,20 @@ public:
         return concept_->num_targets(&model_);
     };
 
+    // Equal operators have equal hashes.  The hash covers the operator's kind
+    // and its state: operators provide it through a `hash()` method, or else
+    // through `angle()`.  Operators that have neither only hash their kind.
+    uint64_t hash() const
+    {
+        uint64_t seed = std::hash<std::string_view>()(kind());
+        hash_combine(seed, concept_->hash(&model_));
+        return seed;
+    }
+
     template<typename ConcreteOp>
     bool is_a() const
     {
-        return ConcreteOp::kind() == kind();
+        return kind_id_ == operator_kind_id<ConcreteOp>();
     }
 
     template<typename... Args>
@@ -136,7 +187,7 @@ public:
 
     bool operator==(Operator const& other) const
     {
-        if (kind() != other.kind()) {
+        if (kind_id_ != other.kind_id_) {
             return false;
         }
         return concept_->equal(&model_, &other.model_);
@@ -147,31 +198,52 @@ private:
 
     struct Concept {
         void (*dtor)(void*) noexcept;
-        void (*clone)(void const*, void*) noexcept;
+        void (*clone)(void const*, void*, BumpAllocator*) noexcept;
+        void (*move)(void*, void*) noexcept;
         bool (*equal)(void const*, void const*) noexcept;
         void const* (*optor)(void const*) noexcept;
         std::optional<Operator> (*adjoint)(void const*) noexcept;
+        std::optional<double> (*angle)(void const*) noexcept;
         std::string_view (*kind)(void const*) noexcept;
         std::optional<UMatrix> const (*matrix)(void const*) noexcept;
         uint32_t (*num_targets)(void const*) noexcept;
+        uint64_t (*hash)(void const*) noexcept;
     };
 
     template<class ConcreteOp, bool IsSmall>
     struct Model;
 
+    // Operators whose adjoint might not exist return an optional.
+    template<typename AdjointOp>
+    static std::optional<Operator> wrap_adjoint(AdjointOp&& adjoint) noexcept
+    {
+        return Operator(std::forward<AdjointOp>(adjoint));
+    }
+
+    template<typename AdjointOp>
+    static std::optional<Operator> wrap_adjoint(
+      std::optional<AdjointOp>&& adjoint) noexcept
+    {
+        if (!adjoint) {
+            return std::nullopt;
+        }
+        return Operator(std::move(*adjoint));
+    }
+
     static constexpr size_t small_size = sizeof(void*) * 4;
     Concept const* concept_;
+    uint32_t kind_id_;
     std::aligned_storage_t<small_size> model_;
 };
 
 // Stack
 template<class ConcreteOp>
 struct Operator::Model<ConcreteOp, true> {
-    Model(ConcreteOp&& op) noexcept
+    Model(ConcreteOp&& op, BumpAllocator*) noexcept
         : operator_(std::forward<ConcreteOp>(op))
     {}
 
-    Model(ConcreteOp const& op) noexcept
+    Model(ConcreteOp const& op, BumpAllocator*) noexcept
         : operator_(op)
     {}
 
@@ -180,10 +252,16 @@ struct Operator::Model<ConcreteOp, true> {
         static_cast<Model*>(self)->~Model();
     }
 
-    static void clone(void const* self, void* other) noexcept
+    static void clone(void const* self, void* other, BumpAllocator*) noexcept
     {
         new (other) Model<remove_cvref_t<ConcreteOp>, true>(
-          static_cast<Model const*>(self)->operator_);
+          static_cast<Model const*>(self)->operator_, nullptr);
+    }
+
+    static void move(void* self, void* other) noexcept
+    {
+        new (other)
+          Model(std::move(static_cast<Model*>(self)->operator_), nullptr);
     }
 
     static bool equal(void const* self, void const* other) noexcept
@@ -205,7 +283,17 @@ struct Operator::Model<ConcreteOp, true> {
     static std::optional<Operator> adjoint(void const* self) noexcept
     {
         if constexpr (has_adjoint_v<ConcreteOp>) {
-            return static_cast<Model const*>(self)->operator_.adjoint();
+            return wrap_adjoint(
+              static_cast<Model const*>(self)->operator_.adjoint());
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    static std::optional<double> angle(void const* self) noexcept
+    {
+        if constexpr (has_angle_v<ConcreteOp>) {
+            return static_cast<Model const*>(self)->operator_.angle();
         } else {
             return std::nullopt;
         }
@@ -234,8 +322,20 @@ struct Operator::Model<ConcreteOp, true> {
         }
     }
 
-    static constexpr Concept vtable_{
-      dtor, clone, equal, optor, adjoint, kind, matrix, num_targets};
+    static uint64_t hash(void const* self) noexcept
+    {
+        if constexpr (has_hash_v<ConcreteOp>) {
+            return static_cast<Model const*>(self)->operator_.hash();
+        } else if constexpr (has_angle_v<ConcreteOp>) {
+            return hash_double(
+              static_cast<Model const*>(self)->operator_.angle());
+        } else {
+            return 0u;
+        }
+    }
+
+    static constexpr Concept vtable_{dtor, clone, move, equal, optor, adjoint,
+      angle, kind, matrix, num_targets, hash};
 
     ConcreteOp operator_;
 };
@@ -243,23 +343,52 @@ struct Operator::Model<ConcreteOp, true> {
 // Heap
 template<class ConcreteOp>
 struct Operator::Model<ConcreteOp, false> {
-    Model(ConcreteOp&& op) noexcept
-        : operator_(std::make_unique<ConcreteOp>(std::forward<ConcreteOp>(op)))
+    Model(ConcreteOp&& op, BumpAllocator* arena) noexcept
+        : operator_(create(std::forward<ConcreteOp>(op), arena))
+        , in_arena_(arena != nullptr)
     {}
 
-    Model(ConcreteOp const& op) noexcept
-        : operator_(std::make_unique<ConcreteOp>(op))
+    Model(ConcreteOp const& op, BumpAllocator* arena) noexcept
+        : operator_(create(op, arena))
+        , in_arena_(arena != nullptr)
     {}
 
+    template<typename T>
+    static ConcreteOp* create(T&& op, BumpAllocator* arena)
+    {
+        if (arena == nullptr) {
+            return new ConcreteOp(std::forward<T>(op));
+        }
+        return new (arena->allocate<ConcreteOp>())
+          ConcreteOp(std::forward<T>(op));
+    }
+
     static void dtor(void* self) noexcept
     {
-        static_cast<Model*>(self)->operator_.reset();
+        Model* model = static_cast<Model*>(self);
+        if (model->operator_ == nullptr) {
+            return;
+        }
+        if (model->in_arena_) {
+            model->operator_->~ConcreteOp();
+        } else {
+            delete model->operator_;
+        }
+        model->operator_ = nullptr;
     }
 
-    static void clone(void const* self, void* other) noexcept
+    static void clone(
+      void const* self, void* other, BumpAllocator* arena) noexcept
     {
-        new (other)
-          Model<ConcreteOp, false>(*static_cast<Model const*>(self)->operator_);
+        new (other) Model<ConcreteOp, false>(
+          *static_cast<Model const*>(self)->operator_, arena);
+    }
+
+    static void move(void* self, void* other) noexcept
+    {
+        Model* model = static_cast<Model*>(self);
+        new (other) Model(*model);
+        model->operator_ = nullptr;
     }
 
     static bool equal(void const* self, void const* other) noexcept
@@ -268,20 +397,30 @@ struct Operator::Model<ConcreteOp, false> {
         {
             return true;
         } else {
-            return static_cast<Model const*>(self)->operator_
-                == static_cast<Model const*>(other)->operator_;
+            return *static_cast<Model const*>(self)->operator_
+                == *static_cast<Model const*>(other)->operator_;
         }
     }
 
     static void const* optor(void const* self) noexcept
     {
-        return static_cast<Model const*>(self)->operator_.get();
+        return static_cast<Model const*>(self)->operator_;
     }
 
     static std::optional<Operator> adjoint(void const* self) noexcept
     {
         if constexpr (has_adjoint_v<ConcreteOp>) {
-            return static_cast<Model const*>(self)->operator_->adjoint();
+            return wrap_adjoint(
+              static_cast<Model const*>(self)->operator_->adjoint());
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    static std::optional<double> angle(void const* self) noexcept
+    {
+        if constexpr (has_angle_v<ConcreteOp>) {
+            return static_cast<Model const*>(self)->operator_->angle();
         } else {
             return std::nullopt;
         }
@@ -310,10 +449,23 @@ struct Operator::Model<ConcreteOp, false> {
         }
     }
 
-    static constexpr Concept vtable_{
-      dtor, clone, equal, optor, adjoint, kind, matrix, num_targets};
+    static uint64_t hash(void const* self) noexcept
+    {
+        if constexpr (has_hash_v<ConcreteOp>) {
+            return static_cast<Model const*>(self)->operator_->hash();
+        } else if constexpr (has_angle_v<ConcreteOp>) {
+            return hash_double(
+              static_cast<Model const*>(self)->operator_->angle());
+        } else {
+            return 0u;
+        }
+    }
+
+    static constexpr Concept vtable_{dtor, clone, move, equal, optor, adjoint,
+      angle, kind, matrix, num_targets, hash};
 
-    std::unique_ptr<ConcreteOp> operator_;
+    ConcreteOp* operator_;
+    bool in_arena_;
 };
 
 } // namespace tweedledum
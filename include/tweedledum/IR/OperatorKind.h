@@ -0,0 +1,98 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace tweedledum {
+
+// Operator kind identifiers
+//
+// Every operator kind (the string returned by `kind()`, e.g. "std.x") gets a
+// small integer identifier the first time it is seen.  Operators store this
+// identifier, so checking whether an operator is of a certain kind is an
+// integer comparison instead of a string comparison.
+//
+// Identifiers are dense, starting at zero, and are assigned in order of
+// registration.  Hence they are _not_ stable across runs and must not be
+// serialized.  Extension operators (including the ones defined outside of
+// this library) are registered automatically the first time an operator of
+// their type is created.  They can also be registered explicitly with
+// `register_operator_kind`, and looked up without registering them with
+// `find_operator_kind`.
+namespace detail {
+
+struct OperatorKindRegistry {
+    std::mutex mutex;
+    std::deque<std::string> names;
+    std::unordered_map<std::string_view, uint32_t> ids;
+};
+
+inline OperatorKindRegistry& operator_kind_registry()
+{
+    static OperatorKindRegistry registry;
+    return registry;
+}
+
+} // namespace detail
+
+// Returns the identifier of `kind`, registering it if necessary.
+inline uint32_t register_operator_kind(std::string_view const kind)
+{
+    detail::OperatorKindRegistry& registry = detail::operator_kind_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto search = registry.ids.find(kind);
+    if (search != registry.ids.end()) {
+        return search->second;
+    }
+    uint32_t const id = registry.names.size();
+    // std::deque does not invalidate references on `emplace_back`, so the
+    // key `string_view`s remain valid.
+    std::string_view const name = registry.names.emplace_back(kind);
+    registry.ids.emplace(name, id);
+    return id;
+}
+
+// Returns the identifier of `kind`, if it was registered.
+inline std::optional<uint32_t> find_operator_kind(std::string_view const kind)
+{
+    detail::OperatorKindRegistry& registry = detail::operator_kind_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto search = registry.ids.find(kind);
+    if (search == registry.ids.end()) {
+        return std::nullopt;
+    }
+    return search->second;
+}
+
+inline uint32_t num_operator_kinds()
+{
+    detail::OperatorKindRegistry& registry = detail::operator_kind_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return registry.names.size();
+}
+
+inline std::string_view operator_kind_name(uint32_t const id)
+{
+    detail::OperatorKindRegistry& registry = detail::operator_kind_registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    return registry.names.at(id);
+}
+
+// The identifier is computed once per type.
+template<typename ConcreteOp>
+uint32_t operator_kind_id()
+{
+    static uint32_t const id = register_operator_kind(ConcreteOp::kind());
+    return id;
+}
+
+} // namespace tweedledum
@@ -43,6 +43,30 @@ struct has_adjoint<Op, std::void_t<decltype(std::declval<Op>().adjoint())>>
 template<class Op>
 inline constexpr bool has_adjoint_v = has_adjoint<Op>::value;
 
+//
+
+template<class Op, class = void>
+struct has_angle : std::false_type {};
+
+template<class Op>
+struct has_angle<Op, std::void_t<decltype(std::declval<Op>().angle())>>
+    : std::true_type {};
+
+template<class Op>
+inline constexpr bool has_angle_v = has_angle<Op>::value;
+
+//
+
+template<class Op, class = void>
+struct has_hash : std::false_type {};
+
+template<class Op>
+struct has_hash<Op, std::void_t<decltype(std::declval<Op>().hash())>>
+    : std::true_type {};
+
+template<class Op>
+inline constexpr bool has_hash_v = has_hash<Op>::value;
+
 // Got it from: https://stackoverflow.com/a/18603716
 template<class F, class... T,
   typename = decltype(std::declval<F>()(std::declval<T>()...))>
@@ -0,0 +1,101 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../Utils/Hash.h"
+#include "../Utils/Span.h"
+
+#include <cassert>
+#include <cstdint>
+#include <limits>
+
+namespace tweedledum {
+
+/*! \brief A symbolic (real) parameter.
+ *
+ * Parameters are affine expressions, `scale * x[index] + offset`, of a single
+ * symbol, which is enough to express the angles obtained by negating (taking
+ * the adjoint) and scaling rotations.  A parameter without a symbol is a
+ * constant.  Symbols are identified by their index in the vector of values
+ * given when binding (see `bind_parameters`.)
+ */
+class Parameter {
+public:
+    static Parameter symbol(uint32_t const index)
+    {
+        assert(index != no_symbol);
+        return Parameter(index, 1.0, 0.0);
+    }
+
+    Parameter(double const constant = 0.0)
+        : index_(no_symbol)
+        , scale_(0.0)
+        , offset_(constant)
+    {}
+
+    bool is_constant() const
+    {
+        return index_ == no_symbol;
+    }
+
+    uint32_t index() const
+    {
+        assert(!is_constant());
+        return index_;
+    }
+
+    double evaluate(Span<double const> values) const
+    {
+        if (is_constant()) {
+            return offset_;
+        }
+        assert(index_ < values.size());
+        return scale_ * values[index_] + offset_;
+    }
+
+    Parameter operator-() const
+    {
+        return Parameter(index_, -scale_, -offset_);
+    }
+
+    Parameter operator*(double const factor) const
+    {
+        return Parameter(index_, scale_ * factor, offset_ * factor);
+    }
+
+    Parameter operator+(double const term) const
+    {
+        return Parameter(index_, scale_, offset_ + term);
+    }
+
+    bool operator==(Parameter const& other) const
+    {
+        return index_ == other.index_ && scale_ == other.scale_
+            && offset_ == other.offset_;
+    }
+
+    uint64_t hash() const
+    {
+        uint64_t seed = index_;
+        hash_combine(seed, hash_double(scale_));
+        hash_combine(seed, hash_double(offset_));
+        return seed;
+    }
+
+private:
+    static constexpr uint32_t no_symbol = std::numeric_limits<uint32_t>::max();
+
+    Parameter(uint32_t const index, double const scale, double const offset)
+        : index_(index)
+        , scale_(scale)
+        , offset_(offset)
+    {}
+
+    uint32_t index_;
+    double scale_;
+    double offset_;
+};
+
+} // namespace tweedledum
@@ -0,0 +1,139 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../Utils/Hash.h"
+#include "Cbit.h"
+#include "Instruction.h"
+#include "Qubit.h"
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace tweedledum {
+
+/*! \brief Structural hashes of a circuit's instructions.
+ *
+ * The hash of an instruction covers its operator (see `Operator::hash`), and,
+ * on each one of its wires, the polarity and the hash of its child together
+ * with the position of the wire among the child's wires.  On wires where the
+ * instruction has no child, it covers the uid of the wire instead.  Hence,
+ * the hash of an instruction identifies the whole sub-circuit (cone) that
+ * leads to it.
+ *
+ * The hash of a circuit is the sum of the hashes of its instructions, which
+ * does not depend on the order in which independent instructions were added:
+ * circuits with the same instruction DAG have the same hash.
+ *
+ * Hashes can be added incrementally, as long as the children of an instruction
+ * are added before the instruction itself.
+ *
+ * Hashes are meant for in-memory caches: they depend on `std::hash`, and thus
+ * are not guaranteed to be the same across platforms.
+ */
+class StructuralHash {
+public:
+    uint64_t value() const
+    {
+        return sum_;
+    }
+
+    uint64_t node(InstRef const ref) const
+    {
+        return nodes_.at(ref);
+    }
+
+    // Adds the hash of the instruction `ref`, whose children must have been
+    // added already.
+    void add(InstRef const ref, std::vector<Instruction> const& instructions)
+    {
+        if (nodes_.size() <= ref) {
+            nodes_.resize(ref + 1, 0u);
+        }
+        Instruction const& inst = instructions.at(ref);
+        uint64_t const hash =
+          compute(inst, [&](auto const wire, InstRef const child) {
+              if (child == InstRef::invalid()) {
+                  return input_hash(wire);
+              }
+              return child_hash(
+                nodes_.at(child), instructions.at(child), wire);
+          });
+        nodes_.at(ref) = hash;
+        sum_ += hash;
+    }
+
+    // Computes the hash of `inst` given a function that returns a hash for
+    // each one of its wires, and the child on that wire.
+    template<typename Fn>
+    static uint64_t compute(Instruction const& inst, Fn&& wire_hash)
+    {
+        uint64_t seed = inst.hash();
+        hash_combine(seed, inst.num_qubits());
+        inst.foreach_qubit([&](Qubit const qubit, InstRef const child) {
+            hash_combine(seed, qubit.polarity() == Qubit::Polarity::positive);
+            hash_combine(seed, wire_hash(qubit, child));
+        });
+        inst.foreach_cbit([&](Cbit const cbit, InstRef const child) {
+            hash_combine(seed, wire_hash(cbit, child));
+        });
+        return hash_mix(seed);
+    }
+
+    // Hash of a wire without child, which only depends on the wire's uid.
+    // (Sub-circuits renumber their wires, see `structural_hash(circuit, cut)`.)
+    static uint64_t input_hash(Qubit const qubit)
+    {
+        return hash_mix(qubit.uid());
+    }
+
+    static uint64_t input_hash(Cbit const cbit)
+    {
+        return hash_mix(~static_cast<uint64_t>(cbit.uid()));
+    }
+
+    template<typename WireT>
+    static uint64_t child_hash(
+      uint64_t const child_hash, Instruction const& child, WireT const wire)
+    {
+        uint64_t seed = child_hash;
+        hash_combine(seed, position(child, wire));
+        return seed;
+    }
+
+private:
+    // Position of `wire` among the wires of `inst` (first qubits, then cbits.)
+    static uint32_t position(Instruction const& inst, Qubit const qubit)
+    {
+        uint32_t result = 0u;
+        uint32_t i = 0u;
+        inst.foreach_qubit([&](Qubit const other) {
+            if (other.uid() == qubit.uid()) {
+                result = i;
+            }
+            ++i;
+        });
+        return result;
+    }
+
+    static uint32_t position(Instruction const& inst, Cbit const cbit)
+    {
+        uint32_t result = 0u;
+        uint32_t i = inst.num_qubits();
+        inst.foreach_cbit([&](Cbit const other) {
+            if (other == cbit) {
+                result = i;
+            }
+            ++i;
+        });
+        return result;
+    }
+
+    std::vector<uint64_t> nodes_;
+    uint64_t sum_ = 0u;
+};
+
+} // namespace tweedledum
@@ -0,0 +1,199 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../Utils/Span.h"
+#include "Cbit.h"
+#include "Instruction.h"
+#include "Qubit.h"
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+namespace tweedledum {
+
+/*! \brief Forward (successor) adjacency of a circuit's instructions.
+ *
+ * Instructions only record their predecessors (children) on each wire.  This
+ * index stores, in compressed sparse row (CSR) layout, the successor of each
+ * instruction on each one of its wires, and the first instruction on each wire
+ * (the inputs).
+ *
+ * New instructions can only be added at the end of the CSR arrays, i.e., with
+ * increasing references, but links can be changed anywhere.  This is enough
+ * for `Circuit` to keep the index up to date when instructions are added or
+ * edited in place.
+ */
+class SuccessorIndex {
+public:
+    // Builds the index out of the children of the instructions.  Instructions
+    // marked in `removed` (if given) are ignored.
+    SuccessorIndex(std::vector<Instruction> const& instructions,
+      uint32_t const num_qubits, uint32_t const num_cbits,
+      Span<uint8_t const> removed = {})
+        : qubit_inputs_(num_qubits, InstRef::invalid())
+        , cbit_inputs_(num_cbits, InstRef::invalid())
+    {
+        offset_.reserve(instructions.size() + 1);
+        offset_.push_back(0u);
+        for (Instruction const& inst : instructions) {
+            push_back(inst);
+        }
+        for (uint32_t i = 0u; i < instructions.size(); ++i) {
+            if (!removed.empty() && removed[i]) {
+                continue;
+            }
+            InstRef const ref(i);
+            instructions.at(i).foreach_qubit(
+              [&](Qubit qubit, InstRef child) { link(child, qubit, ref); });
+            instructions.at(i).foreach_cbit(
+              [&](Cbit cbit, InstRef child) { link(child, cbit, ref); });
+        }
+    }
+
+    uint32_t num_instructions() const
+    {
+        return offset_.size() - 1;
+    }
+
+    void add_qubit()
+    {
+        qubit_inputs_.push_back(InstRef::invalid());
+    }
+
+    void add_cbit()
+    {
+        cbit_inputs_.push_back(InstRef::invalid());
+    }
+
+    // Adds (unlinked) slots for a new instruction, which gets the reference
+    // `InstRef(num_instructions())`.
+    void push_back(Instruction const& inst)
+    {
+        inst.foreach_qubit([&](Qubit qubit) {
+            wires_.push_back(key(qubit));
+            successors_.push_back(InstRef::invalid());
+        });
+        inst.foreach_cbit([&](Cbit cbit) {
+            wires_.push_back(key(cbit));
+            successors_.push_back(InstRef::invalid());
+        });
+        offset_.push_back(wires_.size());
+    }
+
+    // Makes `ref` the successor of `child` on `wire`.  If `child` is invalid,
+    // `ref` becomes the input of `wire`.
+    template<typename WireT>
+    void link(InstRef const child, WireT const wire, InstRef const ref)
+    {
+        if (child == InstRef::invalid()) {
+            input_slot(wire) = ref;
+            return;
+        }
+        successors_.at(find_slot(child, key(wire))) = ref;
+    }
+
+    InstRef input(Qubit const qubit) const
+    {
+        return qubit_inputs_.at(qubit.uid());
+    }
+
+    InstRef input(Cbit const cbit) const
+    {
+        return cbit_inputs_.at(cbit.uid());
+    }
+
+    template<typename WireT>
+    InstRef successor(InstRef const ref, WireT const wire) const
+    {
+        return successors_.at(find_slot(ref, key(wire)));
+    }
+
+    // The successor of `ref` on each one of its wires (first qubits, then
+    // cbits), `InstRef::invalid()` if `ref` is the last instruction on a wire.
+    Span<InstRef const> successors(InstRef const ref) const
+    {
+        assert(ref < num_instructions());
+        return {successors_.data() + offset_[ref],
+          offset_[ref + 1] - offset_[ref]};
+    }
+
+    // Same order as `Circuit::foreach_output`: first qubits, then cbits.
+    template<typename Fn>
+    void foreach_input(Fn&& fn) const
+    {
+        static_assert(std::is_invocable_r_v<void, Fn, InstRef>);
+        for (InstRef const ref : qubit_inputs_) {
+            if (ref == InstRef::invalid()) {
+                continue;
+            }
+            fn(ref);
+        }
+        for (InstRef const ref : cbit_inputs_) {
+            if (ref == InstRef::invalid()) {
+                continue;
+            }
+            fn(ref);
+        }
+    }
+
+    template<typename Fn>
+    void foreach_successor(InstRef const ref, Fn&& fn) const
+    {
+        static_assert(std::is_invocable_r_v<void, Fn, InstRef>);
+        for (InstRef const successor : successors(ref)) {
+            if (successor == InstRef::invalid()) {
+                continue;
+            }
+            fn(successor);
+        }
+    }
+
+private:
+    // Wires are keyed by their uid, with the most significant bit set for
+    // cbits.  This way keys do not change when wires are added.
+    static constexpr uint32_t cbit_flag = 1u << 31;
+
+    static uint32_t key(Qubit const qubit)
+    {
+        return qubit.uid();
+    }
+
+    static uint32_t key(Cbit const cbit)
+    {
+        return cbit.uid() | cbit_flag;
+    }
+
+    InstRef& input_slot(Qubit const qubit)
+    {
+        return qubit_inputs_.at(qubit.uid());
+    }
+
+    InstRef& input_slot(Cbit const cbit)
+    {
+        return cbit_inputs_.at(cbit.uid());
+    }
+
+    uint32_t find_slot(InstRef const ref, uint32_t const wire) const
+    {
+        assert(ref < num_instructions());
+        for (uint32_t i = offset_[ref]; i < offset_[ref + 1]; ++i) {
+            if (wires_[i] == wire) {
+                return i;
+            }
+        }
+        assert(0 && "Instruction does not act on this wire");
+        return offset_[ref + 1];
+    }
+
+    std::vector<uint32_t> offset_;
+    std::vector<uint32_t> wires_;
+    std::vector<InstRef> successors_;
+    std::vector<InstRef> qubit_inputs_;
+    std::vector<InstRef> cbit_inputs_;
+};
+
+} // namespace tweedledum
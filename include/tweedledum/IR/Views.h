@@ -0,0 +1,589 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "Cbit.h"
+#include "Circuit.h"
+#include "Instruction.h"
+#include "Qubit.h"
+
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tweedledum {
+
+// Circuit views
+//
+// A view is a lightweight, non-owning, read-only window over (part of) a
+// circuit.  It exposes the same traversal interface as `Circuit` (the
+// `foreach_*` methods, `instruction`, `num_instructions` and the wires), so
+// passes written as templates over the circuit type can take a view in place
+// of a circuit.  Instructions are not copied, unless explicitly asked for with
+// `materialize()`.
+//
+// Instructions in a view are referenced by _view_ references, which go from
+// 0 to `num_instructions() - 1` following the view's program order.  Hence,
+// analyses that index per-instruction data by `InstRef`, and size it with
+// `num_refs()`, work out of the box.
+// `circuit_ref` translates them back into the circuit's references.  Note that
+// the children stored in an `Instruction` are the circuit's references; use
+// the view's `foreach_child` instead, which only visits instructions in the
+// view.
+//
+// Views keep a pointer to the circuit, which must outlive them and must be
+// compact (see `Circuit::compact()`): creating a view of an edited circuit
+// throws `std::invalid_argument`.  Modifying the circuit invalidates its
+// views.
+class BaseView {
+public:
+    BaseView(Circuit const& circuit)
+        : circuit_(&circuit)
+    {
+        if (!circuit.is_compact()) {
+            throw std::invalid_argument("Views require a compact circuit");
+        }
+    }
+
+    Circuit const& circuit() const
+    {
+        return *circuit_;
+    }
+
+    double global_phase() const
+    {
+        return circuit_->global_phase();
+    }
+
+    // Wires: the same as the circuit's
+    uint32_t num_wires() const
+    {
+        return circuit_->num_wires();
+    }
+
+    uint32_t num_qubits() const
+    {
+        return circuit_->num_qubits();
+    }
+
+    uint32_t num_cbits() const
+    {
+        return circuit_->num_cbits();
+    }
+
+    std::vector<Qubit> qubits() const
+    {
+        return circuit_->qubits();
+    }
+
+    std::vector<Cbit> cbits() const
+    {
+        return circuit_->cbits();
+    }
+
+    std::string_view name(Qubit qubit) const
+    {
+        return circuit_->name(qubit);
+    }
+
+    std::string_view name(Cbit cbit) const
+    {
+        return circuit_->name(cbit);
+    }
+
+    template<typename Fn>
+    void foreach_qubit(Fn&& fn) const
+    {
+        circuit_->foreach_qubit(std::forward<Fn>(fn));
+    }
+
+    template<typename Fn>
+    void foreach_cbit(Fn&& fn) const
+    {
+        circuit_->foreach_cbit(std::forward<Fn>(fn));
+    }
+
+protected:
+    Instruction const& circuit_instruction(InstRef const ref) const
+    {
+        return circuit_->instructions_.at(ref);
+    }
+
+    // Calls `fn` with any of the three accepted callback forms.
+    template<typename Fn>
+    static void invoke(Fn&& fn, InstRef const ref, Instruction const& inst)
+    {
+        // clang-format off
+        static_assert(std::is_invocable_r_v<void, Fn, InstRef> ||
+                      std::is_invocable_r_v<void, Fn, Instruction const&> ||
+                      std::is_invocable_r_v<void, Fn, InstRef, Instruction const&>);
+        // clang-format on
+        if constexpr (std::is_invocable_r_v<void, Fn, InstRef>) {
+            fn(ref);
+        } else if constexpr (std::is_invocable_r_v<void, Fn,
+                               Instruction const&>) {
+            fn(inst);
+        } else {
+            fn(ref, inst);
+        }
+    }
+
+    // Creates a circuit with the same wires and storage modes as the viewed
+    // one.  (See `shallow_duplicate`.)
+    Circuit duplicate_wires() const
+    {
+        Circuit duplicate;
+        if (circuit_->has_columns()) {
+            duplicate.enable_columns();
+        }
+        if (circuit_->has_arena()) {
+            duplicate.enable_arena();
+        }
+        circuit_->foreach_cbit(
+          [&](std::string_view name) { duplicate.create_cbit(name); });
+        circuit_->foreach_qubit(
+          [&](std::string_view name) { duplicate.create_qubit(name); });
+        return duplicate;
+    }
+
+    Circuit const* circuit_;
+};
+
+/*! \brief Common implementation of views that keep the circuit's order.
+ *
+ * `ViewT` must implement `num_instructions()`, `circuit_ref(InstRef)` and
+ * `view_ref(InstRef)`, which returns `InstRef::invalid()` for circuit
+ * references not in the view.
+ *
+ * `foreach_child` and `foreach_output` walk the circuit's wires until finding
+ * an instruction of the view, which is cheap for contiguous views only.
+ * Sparse views link their instructions upfront instead (see `SubsetView`.)
+ */
+template<typename ViewT>
+class ForwardView : public BaseView {
+public:
+    using BaseView::BaseView;
+
+    // View references are dense
+    uint32_t num_refs() const
+    {
+        return self().num_instructions();
+    }
+
+    Instruction const& instruction(InstRef const ref) const
+    {
+        return circuit_instruction(self().circuit_ref(ref));
+    }
+
+    template<typename Fn>
+    void foreach_instruction(Fn&& fn) const
+    {
+        for (uint32_t i = 0u; i < self().num_instructions(); ++i) {
+            invoke(fn, InstRef(i), instruction(InstRef(i)));
+        }
+    }
+
+    template<typename Fn>
+    void foreach_r_instruction(Fn&& fn) const
+    {
+        for (uint32_t i = self().num_instructions(); i-- > 0u;) {
+            invoke(fn, InstRef(i), instruction(InstRef(i)));
+        }
+    }
+
+    // Same visiting order as `Circuit::foreach_child`: first cbits, then qubits.
+    //
+    // The child on a wire is the previous instruction of the view on it, which
+    // might not be the circuit's child when the view skips instructions.
+    template<typename Fn>
+    void foreach_child(InstRef const ref, Fn&& fn) const
+    {
+        Instruction const& inst = instruction(ref);
+        auto visit = [&](auto const wire, InstRef const child) {
+            InstRef const view_child = previous_in_view(child, wire);
+            if (view_child == InstRef::invalid()) {
+                return;
+            }
+            invoke(fn, view_child, instruction(view_child));
+        };
+        inst.foreach_cbit(visit);
+        inst.foreach_qubit(visit);
+    }
+
+    // The last instruction of the view on each wire.  (An instruction is
+    // visited once per wire on which it is the last one.)
+    template<typename Fn>
+    void foreach_output(Fn&& fn) const
+    {
+        for (uint32_t i = self().num_instructions(); i-- > 0u;) {
+            InstRef const ref(i);
+            Instruction const& inst = instruction(ref);
+            auto visit = [&](auto const wire) {
+                if (next_in_view(self().circuit_ref(ref), wire)
+                    == InstRef::invalid()) {
+                    invoke(fn, ref, inst);
+                }
+            };
+            inst.foreach_qubit([&](Qubit const qubit) { visit(qubit); });
+            inst.foreach_cbit([&](Cbit const cbit) { visit(cbit); });
+        }
+    }
+
+    // Copies the instructions of the view into a new circuit.
+    Circuit materialize() const
+    {
+        Circuit result = duplicate_wires();
+        foreach_instruction(
+          [&](Instruction const& inst) { result.apply_operator(inst); });
+        return result;
+    }
+
+private:
+    // Walks back on `wire`, starting at the circuit's instruction `ref`, until
+    // finding an instruction of the view.
+    template<typename WireT>
+    InstRef previous_in_view(InstRef ref, WireT const wire) const
+    {
+        InstRef const first = self().circuit_ref(InstRef(0));
+        while (!(ref == InstRef::invalid()) && ref >= first) {
+            InstRef const view_ref = self().view_ref(ref);
+            if (!(view_ref == InstRef::invalid())) {
+                return view_ref;
+            }
+            ref = child_on(circuit_instruction(ref), wire);
+        }
+        return InstRef::invalid();
+    }
+
+    // Walks forward on `wire`, starting after the circuit's instruction `ref`,
+    // until finding an instruction of the view.
+    template<typename WireT>
+    InstRef next_in_view(InstRef ref, WireT const wire) const
+    {
+        SuccessorIndex const& index = circuit_->successor_index();
+        InstRef const last =
+          self().circuit_ref(InstRef(self().num_instructions() - 1));
+        ref = index.successor(ref, wire);
+        while (!(ref == InstRef::invalid()) && ref <= last) {
+            InstRef const view_ref = self().view_ref(ref);
+            if (!(view_ref == InstRef::invalid())) {
+                return view_ref;
+            }
+            ref = index.successor(ref, wire);
+        }
+        return InstRef::invalid();
+    }
+
+    static InstRef child_on(Instruction const& inst, Qubit const qubit)
+    {
+        InstRef result = InstRef::invalid();
+        inst.foreach_qubit([&](Qubit const other, InstRef const child) {
+            if (other.uid() == qubit.uid()) {
+                result = child;
+            }
+        });
+        return result;
+    }
+
+    static InstRef child_on(Instruction const& inst, Cbit const cbit)
+    {
+        InstRef result = InstRef::invalid();
+        inst.foreach_cbit([&](Cbit const other, InstRef const child) {
+            if (other == cbit) {
+                result = child;
+            }
+        });
+        return result;
+    }
+
+    ViewT const& self() const
+    {
+        return static_cast<ViewT const&>(*this);
+    }
+};
+
+/*! \brief View of a contiguous range of instructions: [begin, end). */
+class SliceView : public ForwardView<SliceView> {
+public:
+    SliceView(Circuit const& circuit, InstRef const begin, InstRef const end)
+        : ForwardView(circuit)
+        , begin_(begin)
+        , end_(end)
+    {
+        assert(begin_ <= end_ && end_ <= circuit.num_instructions());
+    }
+
+    uint32_t num_instructions() const
+    {
+        return end_ - begin_;
+    }
+
+    InstRef circuit_ref(InstRef const ref) const
+    {
+        assert(ref < num_instructions());
+        return InstRef(begin_ + ref);
+    }
+
+    InstRef view_ref(InstRef const ref) const
+    {
+        if (ref < begin_ || ref >= end_) {
+            return InstRef::invalid();
+        }
+        return InstRef(ref - begin_);
+    }
+
+private:
+    uint32_t begin_;
+    uint32_t end_;
+};
+
+/*! \brief View of an arbitrary subset of instructions, e.g., of a `Cut`.
+ *
+ * The view keeps a sorted list of the selected references (no instruction is
+ * copied.)  The circuit's program order is kept.  The children of each
+ * instruction in the view are computed once, when creating the view, so that
+ * traversals take time proportional to the size of the view.
+ */
+class SubsetView : public ForwardView<SubsetView> {
+public:
+    SubsetView(Circuit const& circuit, std::vector<InstRef> refs)
+        : ForwardView(circuit)
+        , refs_(std::move(refs))
+    {
+        std::sort(refs_.begin(), refs_.end(),
+          [](InstRef a, InstRef b) { return a < b; });
+        link();
+    }
+
+    uint32_t num_instructions() const
+    {
+        return refs_.size();
+    }
+
+    InstRef circuit_ref(InstRef const ref) const
+    {
+        return refs_.at(ref);
+    }
+
+    InstRef view_ref(InstRef const ref) const
+    {
+        auto it = std::lower_bound(refs_.begin(), refs_.end(), ref,
+          [](InstRef a, InstRef b) { return a < b; });
+        if (it == refs_.end() || !(*it == ref)) {
+            return InstRef::invalid();
+        }
+        return InstRef(std::distance(refs_.begin(), it));
+    }
+
+    // Same visiting order as `ForwardView::foreach_child`.
+    template<typename Fn>
+    void foreach_child(InstRef const ref, Fn&& fn) const
+    {
+        uint32_t const end = children_begin_.at(ref + 1);
+        for (uint32_t i = children_begin_.at(ref); i < end; ++i) {
+            InstRef const child = children_.at(i);
+            invoke(fn, child, instruction(child));
+        }
+    }
+
+    // The last instruction of the view on each wire.  (Same visiting order as
+    // `ForwardView::foreach_output`.)
+    template<typename Fn>
+    void foreach_output(Fn&& fn) const
+    {
+        for (uint32_t i = num_instructions(); i-- > 0u;) {
+            InstRef const ref(i);
+            Instruction const& inst = instruction(ref);
+            inst.foreach_qubit([&](Qubit const qubit) {
+                if (last_on_qubit_.at(qubit.uid()) == ref) {
+                    invoke(fn, ref, inst);
+                }
+            });
+            inst.foreach_cbit([&](Cbit const cbit) {
+                if (last_on_cbit_.at(cbit.uid()) == ref) {
+                    invoke(fn, ref, inst);
+                }
+            });
+        }
+    }
+
+protected:
+    SubsetView(Circuit const& circuit)
+        : ForwardView(circuit)
+    {}
+
+    // Links each instruction to the previous instruction of the view on each
+    // of its wires.  Must be called once `refs_` is complete and sorted.
+    void link()
+    {
+        last_on_qubit_.assign(circuit_->num_qubits(), InstRef::invalid());
+        last_on_cbit_.assign(circuit_->num_cbits(), InstRef::invalid());
+        children_begin_.reserve(refs_.size() + 1);
+        children_begin_.push_back(0u);
+        for (uint32_t i = 0u; i < refs_.size(); ++i) {
+            auto visit = [&](InstRef& last) {
+                if (!(last == InstRef::invalid())) {
+                    children_.push_back(last);
+                }
+                last = InstRef(i);
+            };
+            Instruction const& inst = instruction(InstRef(i));
+            inst.foreach_cbit(
+              [&](Cbit const cbit) { visit(last_on_cbit_.at(cbit.uid())); });
+            inst.foreach_qubit([&](Qubit const qubit) {
+                visit(last_on_qubit_.at(qubit.uid()));
+            });
+            children_begin_.push_back(children_.size());
+        }
+    }
+
+    std::vector<InstRef> refs_;
+
+private:
+    // The children of instruction `i` are in `children_`, from
+    // `children_begin_[i]` to `children_begin_[i + 1]`.
+    std::vector<uint32_t> children_begin_;
+    std::vector<InstRef> children_;
+    // Last instruction of the view on each wire, indexed by uid
+    std::vector<InstRef> last_on_qubit_;
+    std::vector<InstRef> last_on_cbit_;
+};
+
+/*! \brief View of the instructions that act on a subset of the qubits.
+ *
+ * The view contains all instructions acting on at least one of the qubits.
+ * The wires themselves are not renumbered.
+ */
+class QubitSubsetView : public SubsetView {
+public:
+    QubitSubsetView(Circuit const& circuit, std::vector<Qubit> const& qubits)
+        : SubsetView(circuit)
+    {
+        std::vector<uint8_t> in_subset(circuit.num_qubits(), 0u);
+        for (Qubit const& qubit : qubits) {
+            in_subset.at(qubit) = 1u;
+        }
+        circuit.foreach_instruction([&](InstRef ref, Instruction const& inst) {
+            bool selected = false;
+            inst.foreach_qubit(
+              [&](Qubit const qubit) { selected |= in_subset.at(qubit); });
+            if (selected) {
+                refs_.push_back(ref);
+            }
+        });
+        link();
+    }
+};
+
+/*! \brief View of the instructions in a range of layers: [first, last).
+ *
+ * The layers are given by the caller, e.g., by `compute_asap_layers`, and must
+ * be consistent with the dependencies of the circuit.
+ */
+class LayerView : public SubsetView {
+public:
+    LayerView(Circuit const& circuit, std::vector<uint32_t> const& layers,
+      uint32_t const first, uint32_t const last)
+        : SubsetView(circuit)
+    {
+        assert(layers.size() == circuit.num_instructions());
+        for (uint32_t i = 0u; i < layers.size(); ++i) {
+            if (layers[i] >= first && layers[i] < last) {
+                refs_.emplace_back(i);
+            }
+        }
+        link();
+    }
+
+    LayerView(Circuit const& circuit, std::vector<uint32_t> const& layers,
+      uint32_t const layer)
+        : LayerView(circuit, layers, layer, layer + 1)
+    {}
+};
+
+/*! \brief View of a circuit with its instructions in reverse order.
+ *
+ * The children of an instruction in this view are its successors in the
+ * circuit, and the outputs are the circuit's inputs.
+ */
+class ReversedView : public BaseView {
+public:
+    using BaseView::BaseView;
+
+    uint32_t num_instructions() const
+    {
+        return circuit_->num_instructions();
+    }
+
+    uint32_t num_refs() const
+    {
+        return num_instructions();
+    }
+
+    InstRef circuit_ref(InstRef const ref) const
+    {
+        assert(ref < num_instructions());
+        return InstRef(num_instructions() - 1 - ref);
+    }
+
+    InstRef view_ref(InstRef const ref) const
+    {
+        return circuit_ref(ref);
+    }
+
+    Instruction const& instruction(InstRef const ref) const
+    {
+        return circuit_instruction(circuit_ref(ref));
+    }
+
+    template<typename Fn>
+    void foreach_instruction(Fn&& fn) const
+    {
+        for (uint32_t i = 0u; i < num_instructions(); ++i) {
+            invoke(fn, InstRef(i), instruction(InstRef(i)));
+        }
+    }
+
+    template<typename Fn>
+    void foreach_r_instruction(Fn&& fn) const
+    {
+        for (uint32_t i = num_instructions(); i-- > 0u;) {
+            invoke(fn, InstRef(i), instruction(InstRef(i)));
+        }
+    }
+
+    template<typename Fn>
+    void foreach_child(InstRef const ref, Fn&& fn) const
+    {
+        circuit_->foreach_successor(circuit_ref(ref), [&](InstRef successor) {
+            InstRef const child = view_ref(successor);
+            invoke(fn, child, instruction(child));
+        });
+    }
+
+    template<typename Fn>
+    void foreach_output(Fn&& fn) const
+    {
+        circuit_->foreach_input([&](InstRef input) {
+            InstRef const ref = view_ref(input);
+            invoke(fn, ref, instruction(ref));
+        });
+    }
+
+    // Copies the instructions of the view into a new circuit.
+    Circuit materialize() const
+    {
+        Circuit result = duplicate_wires();
+        foreach_instruction(
+          [&](Instruction const& inst) { result.apply_operator(inst); });
+        return result;
+    }
+};
+
+} // namespace tweedledum
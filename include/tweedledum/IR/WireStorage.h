@@ -8,12 +8,172 @@
 #include "Qubit.h"
 
 #include <cassert>
+#include <fmt/format.h>
+#include <iterator>
 #include <limits>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 namespace tweedledum {
 
+namespace detail {
+/*! \brief Compressed names of one kind of wire.
+ *
+ * Wire names usually are a register name followed by an index, e.g. `__q42`
+ * or `a_3`.  Instead of a string per wire, we store the names as (register,
+ * index) pairs, 8 bytes per wire, and each register name once.  Names given
+ * in full are split at their trailing digits (as long as the digits can be
+ * printed back exactly); names that can't be split become a register of
+ * their own.
+ *
+ * Strings are only materialized when `at()` is asked for a name.  They are
+ * then cached, so the returned view remains valid as long as the storage.
+ * The cache is guarded by a mutex, hence `at()` can be called concurrently.
+ * (Copies start with an empty cache.)
+ */
+class WireNames {
+public:
+    uint32_t size() const
+    {
+        return names_.size();
+    }
+
+    void push_back(std::string_view const name)
+    {
+        constexpr uint32_t max_digits = 9u; // Any 9 digits fit in an index
+        uint32_t num_digits = 0u;
+        while (num_digits < name.size()
+               && is_digit(name[name.size() - num_digits - 1])) {
+            ++num_digits;
+        }
+        // "q" or "q007" can't be printed back from an index.
+        bool const leading_zero =
+          num_digits > 1u && name[name.size() - num_digits] == '0';
+        if (num_digits == 0u || num_digits > max_digits || leading_zero) {
+            names_.push_back({intern(name), no_index});
+            return;
+        }
+        uint32_t index = 0u;
+        for (char const c : name.substr(name.size() - num_digits)) {
+            index = (index * 10u) + (c - '0');
+        }
+        push_back(name.substr(0, name.size() - num_digits), index);
+    }
+
+    // The name of the wire is `register_name` followed by `index`.
+    void push_back(std::string_view const register_name, uint32_t const index)
+    {
+        assert(index != no_index);
+        names_.push_back({intern(register_name), index});
+    }
+
+    std::string_view at(uint32_t const uid) const
+    {
+        Name const& name = names_.at(uid);
+        if (name.index == no_index) {
+            return *registers_.at(name.reg);
+        }
+        std::lock_guard<std::mutex> lock(cache_.mutex);
+        auto [it, inserted] = cache_.names.try_emplace(uid);
+        if (inserted) {
+            format(name, it->second);
+        }
+        return it->second;
+    }
+
+    // Calls `fn` with the name of each wire.  The names are materialized one
+    // at a time, in a buffer, so the views are only valid during the call.
+    template<typename Fn>
+    void foreach_name(Fn&& fn) const
+    {
+        std::string buffer;
+        for (Name const& name : names_) {
+            if (name.index == no_index) {
+                fn(std::string_view(*registers_.at(name.reg)));
+                continue;
+            }
+            format(name, buffer);
+            fn(std::string_view(buffer));
+        }
+    }
+
+private:
+    static constexpr uint32_t no_index = std::numeric_limits<uint32_t>::max();
+
+    struct Name {
+        uint32_t reg;
+        uint32_t index;
+    };
+
+    // Copying the names must not read the cache, which another thread may be
+    // writing to.  Moving it keeps the views valid.
+    struct Cache {
+        std::mutex mutex;
+        std::unordered_map<uint32_t, std::string> names;
+
+        Cache() = default;
+
+        Cache(Cache const&) {}
+
+        Cache(Cache&& other) noexcept
+            : names(std::move(other.names))
+        {}
+
+        Cache& operator=(Cache const&)
+        {
+            names.clear();
+            return *this;
+        }
+
+        Cache& operator=(Cache&& other) noexcept
+        {
+            names = std::move(other.names);
+            return *this;
+        }
+    };
+
+    static bool is_digit(char const c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    uint32_t intern(std::string_view const register_name)
+    {
+        // Wires of a register are usually created one after the other.
+        if (!registers_.empty() && *registers_.at(last_) == register_name) {
+            return last_;
+        }
+        auto [it, inserted] = register_ids_.try_emplace(
+          std::string(register_name), registers_.size());
+        if (inserted) {
+            registers_.push_back(
+              std::make_shared<std::string const>(register_name));
+        }
+        last_ = it->second;
+        return last_;
+    }
+
+    void format(Name const& name, std::string& out) const
+    {
+        out.assign(*registers_.at(name.reg));
+        fmt::format_to(std::back_inserter(out), "{}", name.index);
+    }
+
+    std::vector<Name> names_;
+    // Register names are allocated one by one, so that their views remain
+    // valid as the vector grows.  They are immutable, hence shared by copies.
+    std::vector<std::shared_ptr<std::string const>> registers_;
+    std::unordered_map<std::string, uint32_t> register_ids_;
+    uint32_t last_ = 0u;
+    mutable Cache cache_;
+};
+} // namespace detail
+
 class WireStorage {
 public:
     WireStorage() = default;
@@ -55,6 +215,7 @@ public:
         return qubits_;
     }
 
+    // See `detail::WireNames` for the lifetime of names.
     std::string_view name(Cbit cbit) const
     {
         return cbit_names_.at(cbit);
@@ -79,13 +240,12 @@ public:
             }
         } else if constexpr (std::is_invocable_r_v<void, Fn, std::string_view>)
         {
-            for (std::string const& name : cbit_names_) {
-                fn(name);
-            }
+            cbit_names_.foreach_name(fn);
         } else {
-            for (uint32_t i = 0; i < num_cbits(); ++i) {
-                fn(cbits_.at(i), cbit_names_.at(i));
-            }
+            uint32_t i = 0u;
+            cbit_names_.foreach_name([&](std::string_view const name) {
+                fn(cbits_.at(i++), name);
+            });
         }
     }
 
@@ -103,13 +263,12 @@ public:
             }
         } else if constexpr (std::is_invocable_r_v<void, Fn, std::string_view>)
         {
-            for (std::string const& name : qubit_names_) {
-                fn(name);
-            }
+            qubit_names_.foreach_name(fn);
         } else {
-            for (uint32_t i = 0; i < num_qubits(); ++i) {
-                fn(qubits_.at(i), qubit_names_.at(i));
-            }
+            uint32_t i = 0u;
+            qubit_names_.foreach_name([&](std::string_view const name) {
+                fn(qubits_.at(i++), name);
+            });
         }
     }
 
@@ -118,7 +277,15 @@ protected:
     {
         uint32_t const uid = cbits_.size();
         cbits_.push_back(Cbit(uid));
-        cbit_names_.emplace_back(name);
+        cbit_names_.push_back(name);
+        return cbits_.back();
+    }
+
+    Cbit do_create_cbit(std::string_view register_name, uint32_t index)
+    {
+        uint32_t const uid = cbits_.size();
+        cbits_.push_back(Cbit(uid));
+        cbit_names_.push_back(register_name, index);
         return cbits_.back();
     }
 
@@ -126,15 +293,23 @@ protected:
     {
         uint32_t const uid = qubits_.size();
         qubits_.push_back(Qubit(uid));
-        qubit_names_.emplace_back(name);
+        qubit_names_.push_back(name);
+        return qubits_.back();
+    }
+
+    Qubit do_create_qubit(std::string_view register_name, uint32_t index)
+    {
+        uint32_t const uid = qubits_.size();
+        qubits_.push_back(Qubit(uid));
+        qubit_names_.push_back(register_name, index);
         return qubits_.back();
     }
 
 private:
     std::vector<Cbit> cbits_;
-    std::vector<std::string> cbit_names_;
+    detail::WireNames cbit_names_;
     std::vector<Qubit> qubits_;
-    std::vector<std::string> qubit_names_;
+    detail::WireNames qubit_names_;
 };
 
 } // namespace tweedledum
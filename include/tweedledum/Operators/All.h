@@ -7,5 +7,6 @@
 #include "Extension.h"
 #include "Ising.h"
 #include "Meta.h"
+#include "Meta/Parametric.h"
 #include "Reversible.h"
 #include "Standard.h"
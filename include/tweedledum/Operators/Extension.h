@@ -8,5 +8,6 @@
 #include "Extension/LogicNetwork.h"
 #include "Extension/Parity.h"
 #include "Extension/Permutation.h"
+#include "Extension/Subcircuit.h"
 #include "Extension/TruthTable.h"
 #include "Extension/Unitary.h"
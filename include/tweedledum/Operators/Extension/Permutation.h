@@ -4,6 +4,8 @@
 *-----------------------------------------------------------------------------*/
 #pragma once
 
+#include "../../Utils/Hash.h"
+
 #include <cmath>
 #include <string_view>
 #include <vector>
@@ -31,6 +33,15 @@ public:
         return std::log2(permutation_.size());
     }
 
+    uint64_t hash() const
+    {
+        uint64_t seed = permutation_.size();
+        for (uint32_t const element : permutation_) {
+            hash_combine(seed, element);
+        }
+        return seed;
+    }
+
     bool operator==(Permutation const& other) const
     {
         return permutation_ == other.permutation_;
@@ -0,0 +1,103 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../../IR/Circuit.h"
+#include "../../Utils/Hash.h"
+
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+namespace tweedledum::Op {
+
+// A composite operator whose body is a circuit.
+//
+// The body is shared among all copies of the operator, so a circuit that
+// repeats the same block many times, e.g. the iterations of Grover's
+// algorithm, only stores it once.  The qubits (cbits) of the body are mapped
+// to the qubits (cbits) of the instruction, in order, and all qubits are
+// targets.
+//
+// Passes treat subcircuits as black boxes.  `subcircuit_decomp` inlines them.
+// The adjoint is lazy: it shares the body, and is only inverted when inlined.
+// (The body is scanned once, when the operator is created, to compute its
+// structural hash and whether it has an adjoint.)
+class Subcircuit {
+public:
+    static constexpr std::string_view kind()
+    {
+        return "ext.subcircuit";
+    }
+
+    Subcircuit(std::shared_ptr<Circuit const> body)
+        : body_(std::move(body))
+        , hash_(body_->structural_hash())
+        , is_adjoint_(false)
+        , has_adjoint_(true)
+    {
+        body_->foreach_instruction([&](Instruction const& inst) {
+            has_adjoint_ = has_adjoint_ && inst.adjoint().has_value();
+        });
+    }
+
+    Subcircuit(Circuit body)
+        : Subcircuit(std::make_shared<Circuit const>(std::move(body)))
+    {}
+
+    // Fails if any operator of the body does not have an adjoint.
+    std::optional<Subcircuit> adjoint() const
+    {
+        if (!has_adjoint_) {
+            return std::nullopt;
+        }
+        Subcircuit result(*this);
+        result.is_adjoint_ = !is_adjoint_;
+        return result;
+    }
+
+    Circuit const& body() const
+    {
+        return *body_;
+    }
+
+    std::shared_ptr<Circuit const> const& shared_body() const
+    {
+        return body_;
+    }
+
+    // If true, the operator is the adjoint of its body.
+    bool is_adjoint() const
+    {
+        return is_adjoint_;
+    }
+
+    uint32_t num_targets() const
+    {
+        return body_->num_qubits();
+    }
+
+    uint64_t hash() const
+    {
+        uint64_t seed = hash_;
+        hash_combine(seed, is_adjoint_);
+        return seed;
+    }
+
+    // Two subcircuits are equal if they share their body.
+    bool operator==(Subcircuit const& other) const
+    {
+        return body_ == other.body_ && is_adjoint_ == other.is_adjoint_;
+    }
+
+private:
+    std::shared_ptr<Circuit const> body_;
+    uint64_t hash_;
+    bool is_adjoint_;
+    bool has_adjoint_;
+};
+
+} // namespace tweedledum::Op
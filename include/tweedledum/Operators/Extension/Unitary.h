@@ -5,6 +5,7 @@
 #pragma once
 
 #include "../../IR/Instruction.h"
+#include "../../Utils/Hash.h"
 #include "../../Utils/Matrix.h"
 
 #include <cassert>
@@ -26,7 +27,7 @@ public:
     {}
 
     Unitary(UMatrix&& unitary)
-        : matrix_(unitary)
+        : matrix_(std::move(unitary))
     {}
 
     UMatrix const& matrix() const
@@ -41,6 +42,17 @@ public:
         return std::log2(matrix_.rows());
     }
 
+    uint64_t hash() const
+    {
+        uint64_t seed = matrix_.rows();
+        Complex const* data = matrix_.data();
+        for (uint32_t i = 0u; i < matrix_.size(); ++i) {
+            hash_combine(seed, hash_double(data[i].real()));
+            hash_combine(seed, hash_double(data[i].imag()));
+        }
+        return seed;
+    }
+
     bool operator==(Unitary const& other) const
     {
         return matrix_ == other.matrix_;
@@ -27,6 +27,11 @@ public:
         return Ryy(-angle_);
     }
 
+    double angle() const
+    {
+        return angle_;
+    }
+
     UMatrix4 const matrix() const
     {
         Complex const a = std::cos(angle_);
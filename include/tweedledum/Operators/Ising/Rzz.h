@@ -27,6 +27,11 @@ public:
         return Rzz(-angle_);
     }
 
+    double angle() const
+    {
+        return angle_;
+    }
+
     UMatrix4 const matrix() const
     {
         Complex const p = std::exp(Complex(0., angle_ / 2));
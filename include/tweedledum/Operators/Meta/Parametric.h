@@ -0,0 +1,147 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../../IR/Operator.h"
+#include "../../IR/Parameter.h"
+#include "../../Utils/Span.h"
+#include "../Standard/U.h"
+
+#include <array>
+#include <cassert>
+#include <functional>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+namespace tweedledum::Op {
+
+// A rotation operator whose angles are symbolic parameters.
+//
+// Passes that only look at the wires of an instruction (e.g. mapping) and
+// passes that leave unknown operators untouched (e.g. decompositions) work on
+// parametric circuits, so their result can be bound many times without being
+// recomputed (see `bind_parameters`).  Parametric operators do not have a
+// matrix; passes that need one must run on bound circuits.
+//
+// Any operator constructible from one up to three angles, and whose adjoint
+// negates all of them, can be made parametric: `Rx`, `Ry`, `Rz`, `P`, `Rxx`,
+// `Ryy` and `Rzz`.  `U` is also supported: its adjoint also swaps φ and λ.
+class Parametric {
+public:
+    static constexpr uint32_t max_parameters = 3u;
+
+    static constexpr std::string_view kind()
+    {
+        return "meta.parametric";
+    }
+
+    template<typename OpT, typename... Params>
+    static Parametric create(Params const&... params)
+    {
+        static_assert(sizeof...(Params) >= 1u);
+        static_assert(sizeof...(Params) <= max_parameters);
+        Parametric result(OpT::kind(), &construct_n<OpT, sizeof...(Params)>,
+          {Parameter(params)...}, sizeof...(Params));
+        result.num_targets_ = result.bind_({}).num_targets();
+        return result;
+    }
+
+    Parametric adjoint() const
+    {
+        Parametric result(*this);
+        for (uint32_t i = 0u; i < num_parameters_; ++i) {
+            result.parameters_[i] = -parameters_[i];
+        }
+        if (target_kind_ == U::kind()) {
+            std::swap(result.parameters_[1], result.parameters_[2]);
+        }
+        return result;
+    }
+
+    // The kind of the bound operator
+    std::string_view target_kind() const
+    {
+        return target_kind_;
+    }
+
+    uint32_t num_targets() const
+    {
+        return num_targets_;
+    }
+
+    uint32_t num_parameters() const
+    {
+        return num_parameters_;
+    }
+
+    Parameter const& parameter(uint32_t const idx) const
+    {
+        assert(idx < num_parameters_);
+        return parameters_[idx];
+    }
+
+    // Throws `std::out_of_range` if `values` has no value for a symbol.
+    Operator bind(Span<double const> values) const
+    {
+        std::array<double, max_parameters> angles = {};
+        for (uint32_t i = 0u; i < num_parameters_; ++i) {
+            Parameter const& parameter = parameters_[i];
+            if (!parameter.is_constant()
+                && parameter.index() >= values.size()) {
+                throw std::out_of_range("Missing value for a parameter symbol");
+            }
+            angles[i] = parameter.evaluate(values);
+        }
+        return bind_(angles);
+    }
+
+    uint64_t hash() const
+    {
+        uint64_t seed = std::hash<std::string_view>()(target_kind_);
+        for (uint32_t i = 0u; i < num_parameters_; ++i) {
+            hash_combine(seed, parameters_[i].hash());
+        }
+        return seed;
+    }
+
+    bool operator==(Parametric const& other) const
+    {
+        return bind_ == other.bind_ && parameters_ == other.parameters_;
+    }
+
+private:
+    using Angles = std::array<double, max_parameters>;
+
+    template<typename OpT, std::size_t... I>
+    static Operator construct(Angles const& angles, std::index_sequence<I...>)
+    {
+        return OpT(angles[I]...);
+    }
+
+    template<typename OpT, std::size_t N>
+    static Operator construct_n(Angles const& angles)
+    {
+        return construct<OpT>(angles, std::make_index_sequence<N>{});
+    }
+
+    Parametric(std::string_view target_kind, Operator (*bind)(Angles const&),
+      std::array<Parameter, max_parameters> const& parameters,
+      uint32_t num_parameters)
+        : target_kind_(target_kind)
+        , bind_(bind)
+        , parameters_(parameters)
+        , num_parameters_(num_parameters)
+        , num_targets_(1u)
+    {}
+
+    std::string_view target_kind_;
+    Operator (*bind_)(Angles const&);
+    std::array<Parameter, max_parameters> parameters_;
+    uint32_t num_parameters_;
+    uint32_t num_targets_;
+};
+
+} // namespace tweedledum::Op
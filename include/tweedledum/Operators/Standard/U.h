@@ -4,6 +4,7 @@
 *-----------------------------------------------------------------------------*/
 #pragma once
 
+#include "../../Utils/Hash.h"
 #include "../../Utils/Matrix.h"
 
 #include <cmath>
@@ -26,7 +27,22 @@ public:
 
     U adjoint() const
     {
-        return U(-theta_, -phi_, -lambda_);
+        return U(-theta_, -lambda_, -phi_);
+    }
+
+    double theta() const
+    {
+        return theta_;
+    }
+
+    double phi() const
+    {
+        return phi_;
+    }
+
+    double lambda() const
+    {
+        return lambda_;
     }
 
     UMatrix2 const matrix() const
@@ -39,6 +55,14 @@ public:
           .finished();
     }
 
+    uint64_t hash() const
+    {
+        uint64_t seed = hash_double(theta_);
+        hash_combine(seed, hash_double(phi_));
+        hash_combine(seed, hash_double(lambda_));
+        return seed;
+    }
+
     bool operator==(U const& other) const
     {
         return theta_ == other.theta_ && phi_ == other.phi_
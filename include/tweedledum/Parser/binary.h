@@ -0,0 +1,208 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../IR/Cbit.h"
+#include "../IR/Circuit.h"
+#include "../IR/Instruction.h"
+#include "../IR/Qubit.h"
+#include "../Utils/Span.h"
+
+#include <cstdint>
+#include <optional>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace tweedledum::binary {
+
+// Binary circuit format
+//
+// A compact, versioned format meant to cache circuits on disk.  Files are
+// written in a single pass and read by memory-mapping them: an instruction is
+// only decoded when it is accessed, and accessing it does not require parsing
+// anything else.  All fields are stored in the byte order of the machine that
+// wrote the file, and a file written on a machine with a different byte order
+// is rejected.
+//
+// Layout (every section is aligned to 8 bytes):
+//
+//   header:        magic "TWDLCIRC", u32 version, u32 byte order mark
+//   instructions:  one record per instruction, each:
+//                    u32 kind, u16 #qubits, u16 #cbits, u32 #parameters,
+//                    u32 reserved, u32 wires[#qubits + #cbits],
+//                    f64 parameters[#parameters]
+//   offsets:       u64 position of each instruction record
+//   kinds:         u32 length + characters, for each operator kind
+//   names:         u64 offsets[#qubits + #cbits + 1], followed by the
+//                  characters of the wire names (first qubits, then cbits)
+//   trailer:       section positions, counts, global phase and magic
+//
+// Operator kinds are stored as strings, and instructions refer to them by
+// their index in the kinds section.  (Kind identifiers are not stable across
+// runs, see `OperatorKind.h`.)  Wires are stored as their uid, with the most
+// significant bit set for negative polarity.
+//
+// Only operators whose state can be described by a list of real parameters
+// are supported: the standard and Ising operators, `Op::Unitary`, and the
+// stateless extension and meta operators.
+
+inline constexpr uint32_t version = 1u;
+
+namespace detail {
+// How to encode/decode the parameters of an operator kind.
+struct Codec;
+} // namespace detail
+
+// Returns true if operators of `kind` can be serialized.
+bool is_supported(std::string_view kind);
+
+/*! \brief Streaming writer.
+ *
+ * Instructions are written to the stream as they come.  The writer only keeps
+ * the wire names, the operator kinds and the position of each instruction
+ * (8 bytes per instruction) in memory, which are written by `finish()`.  It
+ * does not seek, so it can write to any output stream.
+ */
+class Writer {
+public:
+    explicit Writer(std::ostream& os);
+
+    Qubit create_qubit(std::string_view name);
+
+    Cbit create_cbit(std::string_view name);
+
+    void set_global_phase(double phase);
+
+    // Returns false, and does not write anything, if the instruction's
+    // operator is not supported.
+    bool write_instruction(Instruction const& inst);
+
+    // Writes the tables and the trailer.  Returns false if the stream failed
+    // at any point.
+    bool finish();
+
+    uint32_t num_instructions() const
+    {
+        return offsets_.size();
+    }
+
+private:
+    void write_bytes(void const* data, uint64_t size);
+    void write_padding();
+    uint32_t file_kind(Instruction const& inst);
+
+    std::ostream& os_;
+    uint64_t position_;
+    double global_phase_;
+    std::vector<uint64_t> offsets_;
+    std::vector<detail::Codec const*> kinds_;
+    std::unordered_map<uint32_t, uint32_t> kind_index_;
+    std::vector<std::string> qubit_names_;
+    std::vector<std::string> cbit_names_;
+    std::vector<double> parameters_;
+};
+
+// Returns false if the circuit has unsupported operators, in which case nothing
+// is written, or if writing fails.
+bool write(Circuit const& circuit, std::ostream& os);
+
+// On failure, the file is removed.
+bool write_file(Circuit const& circuit, std::string_view path);
+
+/*! \brief A memory-mapped binary circuit.
+ *
+ * Opening a file validates its header, trailer, tables and the structure of
+ * every instruction record, but does not decode anything: instructions are
+ * decoded lazily, on access.  (On platforms without `mmap`, the file is
+ * read into memory instead.)
+ */
+class MappedCircuit {
+public:
+    static std::optional<MappedCircuit> open(std::string_view path);
+
+    // Copies `buffer`, mainly for testing and for in-memory caches.
+    static std::optional<MappedCircuit> from_buffer(std::string_view buffer);
+
+    MappedCircuit(MappedCircuit const&) = delete;
+    MappedCircuit& operator=(MappedCircuit const&) = delete;
+    MappedCircuit(MappedCircuit&& other) noexcept;
+    MappedCircuit& operator=(MappedCircuit&& other) noexcept;
+    ~MappedCircuit();
+
+    // Properties
+    uint32_t num_instructions() const
+    {
+        return num_instructions_;
+    }
+
+    uint32_t num_qubits() const
+    {
+        return num_qubits_;
+    }
+
+    uint32_t num_cbits() const
+    {
+        return num_cbits_;
+    }
+
+    double global_phase() const
+    {
+        return global_phase_;
+    }
+
+    std::string_view name(Qubit qubit) const;
+
+    std::string_view name(Cbit cbit) const;
+
+    // Instructions
+    std::string_view kind(InstRef ref) const;
+
+    uint32_t num_qubits(InstRef ref) const;
+
+    uint32_t num_cbits(InstRef ref) const;
+
+    Qubit qubit(InstRef ref, uint32_t idx) const;
+
+    Cbit cbit(InstRef ref, uint32_t idx) const;
+
+    // The parameters point directly into the mapped file.
+    Span<double const> parameters(InstRef ref) const;
+
+    // Decodes a single instruction.  Its children are invalid, as the file
+    // does not store them: they are only computed by `load()`.
+    Instruction instruction(InstRef ref) const;
+
+    Circuit load() const;
+
+private:
+    MappedCircuit() = default;
+    bool initialize();
+    void release();
+    template<typename T>
+    T read(uint64_t position) const;
+    uint64_t record(InstRef ref) const;
+    Operator decode(InstRef ref) const;
+
+    uint8_t const* data_ = nullptr;
+    uint64_t size_ = 0u;
+    void* mapping_ = nullptr;
+    std::vector<uint64_t> buffer_;
+
+    uint32_t num_instructions_ = 0u;
+    uint32_t num_qubits_ = 0u;
+    uint32_t num_cbits_ = 0u;
+    double global_phase_ = 0.0;
+    uint64_t offsets_ = 0u;
+    uint64_t names_ = 0u;
+    std::vector<detail::Codec const*> kinds_;
+};
+
+// Returns `std::nullopt` if the file cannot be read or is not valid.
+std::optional<Circuit> read_file(std::string_view path);
+
+} // namespace tweedledum::binary
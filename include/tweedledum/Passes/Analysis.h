@@ -6,7 +6,11 @@
 
 #include "Analysis/compute_alap_layers.h"
 #include "Analysis/compute_asap_layers.h"
+#include "Analysis/compute_commutation_dag.h"
 #include "Analysis/compute_critical_paths.h"
 #include "Analysis/compute_cuts.h"
 #include "Analysis/compute_depth.h"
+#include "Analysis/compute_schedule.h"
+#include "Analysis/compute_statistics.h"
 #include "Analysis/count_operators.h"
+#include "Analysis/structural_hash.h"
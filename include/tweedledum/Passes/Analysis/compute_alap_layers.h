@@ -12,9 +12,12 @@
 
 namespace tweedledum {
 
-inline std::vector<uint32_t> compute_alap_layers(Circuit const& circuit)
+// `CircuitT` can be a `Circuit` or a view (see `IR/Views.h`.)  The result is
+// indexed by `InstRef`; entries of removed instructions are 0.
+template<typename CircuitT>
+std::vector<uint32_t> compute_alap_layers(CircuitT const& circuit)
 {
-    std::vector<uint32_t> instruction_layer(circuit.num_instructions(), 0u);
+    std::vector<uint32_t> instruction_layer(circuit.num_refs(), 0u);
     circuit.foreach_output(
       [&](InstRef const ref) { instruction_layer.at(ref) = 0u; });
     uint32_t max_layer = 0u;
@@ -27,9 +30,9 @@ inline std::vector<uint32_t> compute_alap_layers(Circuit const& circuit)
         max_layer = std::max(max_layer, layer);
     });
     max_layer -= 1u;
-    for (uint32_t& layer : instruction_layer) {
-        layer = max_layer - layer;
-    }
+    circuit.foreach_instruction([&](InstRef ref) {
+        instruction_layer.at(ref) = max_layer - instruction_layer.at(ref);
+    });
     return instruction_layer;
 }
 
@@ -8,13 +8,25 @@
 #include "../../IR/Instruction.h"
 
 #include <algorithm>
+#include <type_traits>
 #include <vector>
 
 namespace tweedledum {
 
-inline std::vector<uint32_t> compute_asap_layers(Circuit const& circuit)
+// `CircuitT` can be a `Circuit` or a view (see `IR/Views.h`.)  The result is
+// indexed by `InstRef`; entries of removed instructions are 0.
+template<typename CircuitT>
+std::vector<uint32_t> compute_asap_layers(CircuitT const& circuit)
 {
-    std::vector<uint32_t> instruction_layer(circuit.num_instructions(), 0u);
+    std::vector<uint32_t> instruction_layer(circuit.num_refs(), 0u);
+    if constexpr (std::is_same_v<CircuitT, Circuit>) {
+        if (circuit.has_layers()) {
+            circuit.foreach_instruction([&](InstRef inst) {
+                instruction_layer.at(inst) = circuit.layer(inst);
+            });
+            return instruction_layer;
+        }
+    }
     circuit.foreach_instruction([&](InstRef inst) {
         uint32_t layer = 0;
         circuit.foreach_child(inst, [&](InstRef child) {
@@ -23,9 +35,8 @@ inline std::vector<uint32_t> compute_asap_layers(Circuit const& circuit)
         instruction_layer.at(inst) = ++layer;
     });
     // Correcting (I want layers to start from 0!)
-    for (uint32_t& layer : instruction_layer) {
-        layer -= 1;
-    }
+    circuit.foreach_instruction(
+      [&](InstRef inst) { instruction_layer.at(inst) -= 1; });
     return instruction_layer;
 }
 
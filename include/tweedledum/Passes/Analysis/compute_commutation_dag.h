@@ -0,0 +1,390 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../../IR/Circuit.h"
+#include "../../IR/Instruction.h"
+#include "../../IR/Operator.h"
+#include "../../Operators/Ising.h"
+#include "../../Operators/Meta/Parametric.h"
+#include "../../Operators/Standard.h"
+#include "../../Utils/Matrix.h"
+#include "../../Utils/Span.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace tweedledum {
+
+/*! \brief How an instruction acts on one of its wires.
+ *
+ * An instruction acts `diagonal`ly on a wire if it is block diagonal with
+ * respect to the computational basis of that wire (e.g. controls, and the
+ * targets of Z, T or Rz), and acts as an `x` if it is block diagonal with
+ * respect to the X basis of the wire (e.g. the targets of X or Rx).
+ *
+ * Two instructions commute if, on each wire they share, both act diagonally or
+ * both act as an `x`.  (Both are then block diagonal in the same basis of the
+ * shared wires, and the blocks act on disjoint wires.)  Instructions always
+ * act as `other` on cbits.
+ */
+enum class WireAction : uint8_t {
+    diagonal,
+    x,
+    other,
+};
+
+/*! \brief Classifies the action of operators on their targets.
+ *
+ * Known operators are classified by kind.  Other operators are classified by
+ * inspecting their matrix, if they have one.  The results are cached by
+ * operator (see `Operator::hash`), so each distinct operator is only checked
+ * once.
+ */
+class WireActionCache {
+public:
+    // Matrices of operators with more targets are not inspected.
+    static constexpr uint32_t max_matrix_targets = 6u;
+
+    WireAction target_action(Operator const& optor)
+    {
+        if (optor.is_one<Op::Z, Op::S, Op::Sdg, Op::T, Op::Tdg, Op::Rz, Op::P,
+              Op::Rzz>()) {
+            return WireAction::diagonal;
+        }
+        if (optor.is_one<Op::X, Op::Rx, Op::Sx, Op::Sxdg, Op::Rxx>()) {
+            return WireAction::x;
+        }
+        if (optor.is_one<Op::H, Op::Y, Op::Ry, Op::Ryy, Op::Swap, Op::U,
+              Op::Measure>()) {
+            return WireAction::other;
+        }
+        if (optor.is_a<Op::Parametric>()) {
+            std::string_view const kind =
+              optor.cast<Op::Parametric>().target_kind();
+            if (kind == Op::Rz::kind() || kind == Op::P::kind()
+                || kind == Op::Rzz::kind()) {
+                return WireAction::diagonal;
+            }
+            if (kind == Op::Rx::kind() || kind == Op::Rxx::kind()) {
+                return WireAction::x;
+            }
+            return WireAction::other;
+        }
+        std::vector<Entry>& entries = cache_[optor.hash()];
+        for (Entry const& entry : entries) {
+            if (entry.optor == optor) {
+                return entry.action;
+            }
+        }
+        WireAction const action = from_matrix(optor);
+        entries.push_back({optor, action});
+        return action;
+    }
+
+    // Action of `inst` on its `i`-th qubit.
+    WireAction qubit_action(Instruction const& inst, uint32_t const i)
+    {
+        if (i < inst.num_controls()) {
+            return WireAction::diagonal;
+        }
+        return target_action(inst);
+    }
+
+private:
+    struct Entry {
+        Operator optor;
+        WireAction action;
+    };
+
+    static WireAction from_matrix(Operator const& optor)
+    {
+        if (optor.num_targets() > max_matrix_targets) {
+            return WireAction::other;
+        }
+        std::optional<UMatrix> const matrix = optor.matrix();
+        if (!matrix) {
+            return WireAction::other;
+        }
+        if (is_diagonal(*matrix)) {
+            return WireAction::diagonal;
+        }
+        // Change to the X basis of all targets
+        UMatrix h = UMatrix::Ones(1, 1);
+        UMatrix2 h1;
+        h1 << 1.0, 1.0, 1.0, -1.0;
+        h1 /= std::sqrt(2.0);
+        while (h.rows() < matrix->rows()) {
+            UMatrix next(h.rows() * 2, h.cols() * 2);
+            for (uint32_t i = 0u; i < 2u; ++i) {
+                for (uint32_t j = 0u; j < 2u; ++j) {
+                    next.block(i * h.rows(), j * h.cols(), h.rows(), h.cols()) =
+                      h1(i, j) * h;
+                }
+            }
+            h = std::move(next);
+        }
+        if (is_diagonal(h * (*matrix) * h)) {
+            return WireAction::x;
+        }
+        return WireAction::other;
+    }
+
+    static bool is_diagonal(UMatrix const& matrix)
+    {
+        constexpr double atol = 1e-10;
+        for (uint32_t j = 0u; j < matrix.cols(); ++j) {
+            for (uint32_t i = 0u; i < matrix.rows(); ++i) {
+                if (i != j && std::abs(matrix(i, j)) > atol) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    std::unordered_map<uint64_t, std::vector<Entry>> cache_;
+};
+
+/*! \brief Dependency DAG of a circuit, modulo commutation.
+ *
+ * The instructions on each wire are partitioned into _commutation groups_:
+ * maximal runs of consecutive instructions that act diagonally (or as `x`) on
+ * the wire, see `WireAction`.  Instructions acting as `other` on a wire are
+ * alone in their group.  An instruction depends on the instructions of the
+ * previous group on each one of its wires, and two instructions commute if
+ * they are in the same group on all the wires they share.
+ *
+ * The circuit stores a strictly wire-ordered DAG, e.g. two CX sharing a
+ * control (or a target) are dependent.  Here, they are not, hence passes can
+ * reorder them to reduce depth or to bring gates that cancel together.
+ *
+ * Groups are identified by an index.  The instructions of a group are sorted
+ * in program order, and all of them come after the instructions of the
+ * previous group on the same wire.
+ */
+class CommutationDag {
+public:
+    static constexpr uint32_t no_group = std::numeric_limits<uint32_t>::max();
+
+    CommutationDag(Circuit const& circuit)
+        : num_qubits_(circuit.num_qubits())
+    {
+        WireActionCache cache;
+        build(circuit, cache);
+    }
+
+    CommutationDag(Circuit const& circuit, WireActionCache& cache)
+        : num_qubits_(circuit.num_qubits())
+    {
+        build(circuit, cache);
+    }
+
+    uint32_t num_groups() const
+    {
+        return group_wire_.size();
+    }
+
+    // Wire of the group: a qubit uid, or the number of qubits plus a cbit uid.
+    uint32_t group_wire(uint32_t const group) const
+    {
+        return group_wire_.at(group);
+    }
+
+    WireAction group_action(uint32_t const group) const
+    {
+        return group_action_.at(group);
+    }
+
+    // Previous (next) group on the same wire, or `no_group`.
+    uint32_t previous_group(uint32_t const group) const
+    {
+        return group_prev_.at(group);
+    }
+
+    uint32_t next_group(uint32_t const group) const
+    {
+        return group_next_.at(group);
+    }
+
+    Span<InstRef const> members(uint32_t const group) const
+    {
+        uint32_t const begin = member_offset_.at(group);
+        return {members_.data() + begin, member_offset_.at(group + 1) - begin};
+    }
+
+    // The groups of an instruction, one per wire (qubits first, then cbits, in
+    // the instruction's order.)
+    Span<uint32_t const> groups(InstRef const ref) const
+    {
+        uint32_t const begin = inst_offset_.at(ref);
+        return {inst_groups_.data() + begin, inst_offset_.at(ref + 1) - begin};
+    }
+
+    bool commute(InstRef const a, InstRef const b) const
+    {
+        for (uint32_t const group_a : groups(a)) {
+            for (uint32_t const group_b : groups(b)) {
+                if (group_wire_[group_a] == group_wire_[group_b]
+                    && group_a != group_b) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    // Calls `fn` on the instructions that `ref` directly depends on.  (An
+    // instruction may be visited more than once, if it shares more than one
+    // wire with `ref`.)
+    template<typename Fn>
+    void foreach_predecessor(InstRef const ref, Fn&& fn) const
+    {
+        static_assert(std::is_invocable_r_v<void, Fn, InstRef>);
+        for (uint32_t const group : groups(ref)) {
+            uint32_t const prev = group_prev_[group];
+            if (prev == no_group) {
+                continue;
+            }
+            for (InstRef const pred : members(prev)) {
+                fn(pred);
+            }
+        }
+    }
+
+    template<typename Fn>
+    void foreach_successor(InstRef const ref, Fn&& fn) const
+    {
+        static_assert(std::is_invocable_r_v<void, Fn, InstRef>);
+        for (uint32_t const group : groups(ref)) {
+            uint32_t const next = group_next_[group];
+            if (next == no_group) {
+                continue;
+            }
+            for (InstRef const succ : members(next)) {
+                fn(succ);
+            }
+        }
+    }
+
+    /*! \brief ASAP levels of the commutation DAG, indexed by `InstRef`.
+     *
+     * Instructions on the same level pairwise commute, but, unlike layers,
+     * they may share wires.  Takes time linear in the number of instructions.
+     */
+    std::vector<uint32_t> levels() const
+    {
+        std::vector<uint32_t> level(inst_offset_.size() - 1, 0u);
+        std::vector<uint32_t> group_level(num_groups(), 0u);
+        for (InstRef const ref : order_) {
+            uint32_t result = 0u;
+            for (uint32_t const group : groups(ref)) {
+                uint32_t const prev = group_prev_[group];
+                if (prev != no_group) {
+                    result = std::max(result, group_level[prev] + 1);
+                }
+            }
+            level.at(ref) = result;
+            for (uint32_t const group : groups(ref)) {
+                group_level[group] = std::max(group_level[group], result);
+            }
+        }
+        return level;
+    }
+
+private:
+    void build(Circuit const& circuit, WireActionCache& cache)
+    {
+        uint32_t const num_wires = circuit.num_qubits() + circuit.num_cbits();
+        uint32_t const num_refs = circuit.num_refs();
+        order_.reserve(circuit.num_instructions());
+        inst_offset_.assign(num_refs + 1, 0u);
+        circuit.foreach_instruction([&](InstRef ref, Instruction const& inst) {
+            order_.push_back(ref);
+            inst_offset_.at(ref + 1) = inst.num_wires();
+        });
+        for (uint32_t i = 1u; i < inst_offset_.size(); ++i) {
+            inst_offset_.at(i) += inst_offset_.at(i - 1);
+        }
+        inst_groups_.resize(inst_offset_.back(), no_group);
+
+        // Assign groups
+        std::vector<uint32_t> current(num_wires, no_group);
+        std::vector<uint32_t> group_size;
+        auto join = [&](uint32_t const wire, WireAction const action) {
+            uint32_t const group = current.at(wire);
+            if (group != no_group && action != WireAction::other
+                && group_action_.at(group) == action) {
+                group_size.at(group) += 1;
+                return group;
+            }
+            uint32_t const new_group = group_wire_.size();
+            group_wire_.push_back(wire);
+            group_action_.push_back(action);
+            group_prev_.push_back(group);
+            group_next_.push_back(no_group);
+            group_size.push_back(1u);
+            if (group != no_group) {
+                group_next_.at(group) = new_group;
+            }
+            current.at(wire) = new_group;
+            return new_group;
+        };
+        for (InstRef const ref : order_) {
+            Instruction const& inst = circuit.instruction(ref);
+            uint32_t* groups = inst_groups_.data() + inst_offset_.at(ref);
+            uint32_t i = 0u;
+            inst.foreach_qubit([&](Qubit const qubit) {
+                groups[i] = join(qubit.uid(), cache.qubit_action(inst, i));
+                ++i;
+            });
+            inst.foreach_cbit([&](Cbit const cbit) {
+                groups[i] = join(num_qubits_ + cbit.uid(), WireAction::other);
+                ++i;
+            });
+        }
+
+        // Fill the members of each group, in program order
+        member_offset_.assign(num_groups() + 1, 0u);
+        for (uint32_t group = 0u; group < num_groups(); ++group) {
+            member_offset_.at(group + 1) =
+              member_offset_.at(group) + group_size.at(group);
+        }
+        members_.resize(member_offset_.back(), InstRef::invalid());
+        std::vector<uint32_t> fill(
+          member_offset_.begin(), member_offset_.end() - 1);
+        for (InstRef const ref : order_) {
+            for (uint32_t const group : groups(ref)) {
+                members_.at(fill.at(group)++) = ref;
+            }
+        }
+    }
+
+    uint32_t num_qubits_;
+    // Instructions in program order
+    std::vector<InstRef> order_;
+    // Groups of each instruction
+    std::vector<uint32_t> inst_offset_;
+    std::vector<uint32_t> inst_groups_;
+    // Groups
+    std::vector<uint32_t> group_wire_;
+    std::vector<WireAction> group_action_;
+    std::vector<uint32_t> group_prev_;
+    std::vector<uint32_t> group_next_;
+    std::vector<uint32_t> member_offset_;
+    std::vector<InstRef> members_;
+};
+
+inline CommutationDag compute_commutation_dag(Circuit const& circuit)
+{
+    return CommutationDag(circuit);
+}
+
+} // namespace tweedledum
@@ -6,26 +6,168 @@
 
 #include "../../IR/Circuit.h"
 #include "../../IR/Instruction.h"
+#include "../../IR/InstructionTable.h"
 #include "../../Operators/Standard/Measure.h"
 #include "../../Utils/Cut.h"
 
 #include <algorithm>
+#include <functional>
+#include <iterator>
 #include <limits>
+#include <queue>
+#include <utility>
 #include <vector>
 
 namespace tweedledum {
 
+namespace detail {
+
+// A cut under construction.  Instructions are kept in a linked list (see
+// `CutBuilder::next_`), so that merging two cuts takes constant time.
+struct CutNode {
+    // Sorted by uid, at most one qubit per uid (as in `Cut`.)
+    std::vector<Qubit> qubits;
+    std::vector<Cbit> cbits;
+    InstRef head = InstRef::invalid();
+    InstRef tail = InstRef::invalid();
+
+    bool empty() const
+    {
+        return head == InstRef::invalid();
+    }
+};
+
+class CutBuilder {
+public:
+    CutBuilder(uint32_t const num_refs)
+        : next_(num_refs, InstRef::invalid())
+    {}
+
+    uint32_t size() const
+    {
+        return nodes_.size();
+    }
+
+    CutNode const& node(uint32_t const cut) const
+    {
+        return nodes_.at(cut);
+    }
+
+    void new_cut(Instruction const& inst, InstRef const ref)
+    {
+        CutNode& node = nodes_.emplace_back();
+        node.qubits = inst.qubits();
+        node.cbits = inst.cbits();
+        std::sort(node.qubits.begin(), node.qubits.end());
+        std::sort(node.cbits.begin(), node.cbits.end());
+        node.head = ref;
+        node.tail = ref;
+    }
+
+    void add_instruction(uint32_t const cut, Instruction const& inst,
+      InstRef const ref)
+    {
+        CutNode& node = nodes_.at(cut);
+        inst.foreach_qubit([&](Qubit const qubit) { add_qubit(node, qubit); });
+        next_.at(node.tail) = ref;
+        node.tail = ref;
+    }
+
+    // Number of qubits in the union of the qubits of both cuts
+    uint32_t union_size(uint32_t const cut0, uint32_t const cut1) const
+    {
+        std::vector<Qubit> const& qubits0 = nodes_.at(cut0).qubits;
+        std::vector<Qubit> const& qubits1 = nodes_.at(cut1).qubits;
+        uint32_t common = 0u;
+        auto it0 = qubits0.begin();
+        auto it1 = qubits1.begin();
+        while (it0 != qubits0.end() && it1 != qubits1.end()) {
+            if (*it0 < *it1) {
+                ++it0;
+            } else if (*it1 < *it0) {
+                ++it1;
+            } else {
+                ++common;
+                ++it0;
+                ++it1;
+            }
+        }
+        return qubits0.size() + qubits1.size() - common;
+    }
+
+    // Moves the instructions of `cut0` in front of the ones of `cut1`.
+    void merge_into(uint32_t const cut0, uint32_t const cut1)
+    {
+        CutNode& node0 = nodes_.at(cut0);
+        CutNode& node1 = nodes_.at(cut1);
+        std::vector<Qubit> qubits;
+        std::set_union(node0.qubits.begin(), node0.qubits.end(),
+          node1.qubits.begin(), node1.qubits.end(), std::back_inserter(qubits));
+        node1.qubits = std::move(qubits);
+        next_.at(node0.tail) = node1.head;
+        node1.head = node0.head;
+        node0.head = InstRef::invalid();
+        node0.tail = InstRef::invalid();
+    }
+
+    std::vector<Cut> build() const
+    {
+        std::vector<Cut> cuts;
+        for (CutNode const& node : nodes_) {
+            if (node.empty()) {
+                continue;
+            }
+            std::vector<InstRef> instructions;
+            for (InstRef ref = node.head; !(ref == InstRef::invalid());
+                 ref = next_.at(ref)) {
+                instructions.push_back(ref);
+            }
+            cuts.emplace_back(node.qubits, node.cbits, instructions);
+        }
+        return cuts;
+    }
+
+private:
+    // Qubits are inserted only if there is no qubit with the same uid.
+    static void add_qubit(CutNode& node, Qubit const qubit)
+    {
+        auto it =
+          std::lower_bound(node.qubits.begin(), node.qubits.end(), qubit);
+        if (it == node.qubits.end() || qubit < *it) {
+            node.qubits.insert(it, qubit);
+        }
+    }
+
+    std::vector<CutNode> nodes_;
+    std::vector<InstRef> next_;
+};
+
+} // namespace detail
+
+/*! \brief Partitions the circuit into cuts of at most `cut_width` qubits.
+ *
+ * First, instructions are greedily added, in program order, to the cut of
+ * their children.  Instructions acting on more than `cut_width` qubits, and
+ * measurements, get their own cut.  Then, each narrow cut `i` is merged into
+ * the first cut `j > i` that shares a qubit with it or that is narrow enough
+ * to be merged, if their union is at most `cut_width` wide and they have the
+ * same cbits.
+ *
+ * To find `j` without scanning all the following cuts, we keep, for each
+ * qubit and for each width, the cuts in a min-heap.  (Qubits of a cut only
+ * grow, so entries only become stale when the width of a cut changes, and
+ * are then discarded lazily.)
+ */
 inline std::vector<Cut> compute_cuts(
   Circuit const& circuit, uint32_t const cut_width = 2u)
 {
     constexpr int32_t invalid_cut = std::numeric_limits<int32_t>::min();
-    std::vector<int32_t> inst_cut(circuit.num_instructions(), invalid_cut);
-    std::vector<Cut> cuts;
-    circuit.foreach_instruction([&](InstRef ref) {
-        Instruction const& inst = circuit.instruction(ref);
+    InstructionTable<int32_t> inst_cut(circuit.num_refs(), invalid_cut);
+    detail::CutBuilder cuts(circuit.num_refs());
+    circuit.foreach_instruction([&](InstRef ref, Instruction const& inst) {
         if (inst.num_qubits() > cut_width || inst.is_a<Op::Measure>()) {
             inst_cut.at(ref) = -(cuts.size());
-            cuts.emplace_back(inst.qubits(), inst.cbits(), ref);
+            cuts.new_cut(inst, ref);
             return;
         }
         int32_t cut = invalid_cut;
@@ -41,34 +183,70 @@ inline std::vector<Cut> compute_cuts(
         });
         if (++same_cut == inst.num_wires() && cut >= 0) {
             inst_cut.at(ref) = cut;
-            cuts.at(cut).add_intruction(ref, inst);
+            cuts.add_instruction(cut, inst, ref);
             return;
-        } else if (cut >= 0 && cuts.at(cut).num_qubits() < inst.num_qubits()) {
+        } else if (cut >= 0
+                   && cuts.node(cut).qubits.size() < inst.num_qubits()) {
             inst_cut.at(ref) = cut;
-            cuts.at(cut).add_intruction(ref, inst);
+            cuts.add_instruction(cut, inst, ref);
             return;
         }
         inst_cut.at(ref) = cuts.size();
-        cuts.emplace_back(inst.qubits(), inst.cbits(), ref);
+        cuts.new_cut(inst, ref);
     });
+
     // Try to merge some cuts
+    using MinHeap = std::priority_queue<uint32_t, std::vector<uint32_t>,
+      std::greater<uint32_t>>;
+    std::vector<MinHeap> by_qubit(circuit.num_qubits());
+    std::vector<MinHeap> by_width(cut_width + 1);
+    auto width = [&](uint32_t const cut) {
+        return static_cast<uint32_t>(cuts.node(cut).qubits.size());
+    };
+    auto push = [&](uint32_t const cut) {
+        for (Qubit const& qubit : cuts.node(cut).qubits) {
+            by_qubit.at(qubit.uid()).push(cut);
+        }
+        if (width(cut) <= cut_width) {
+            by_width.at(width(cut)).push(cut);
+        }
+    };
+    // Returns the first valid entry after `i` (or `cuts.size()`.)
+    auto first_after = [&](MinHeap& heap, uint32_t const i, auto&& is_valid) {
+        while (!heap.empty() && (heap.top() <= i || !is_valid(heap.top()))) {
+            heap.pop();
+        }
+        return heap.empty() ? cuts.size() : heap.top();
+    };
+    for (uint32_t i = 0u; i < cuts.size(); ++i) {
+        push(i);
+    }
     for (uint32_t i = 0u; i < cuts.size(); ++i) {
-        if (cuts.at(i).num_qubits() >= cut_width) {
+        if (width(i) >= cut_width) {
             continue;
         }
-        for (uint32_t j = i + 1; j < cuts.size(); ++j) {
-            int32_t did_merge =
-              try_merge_cuts(cuts.at(i), cuts.at(j), cut_width);
-            if (did_merge) {
-                break;
-            }
+        // Qubits of a cut only grow, hence the entries of the qubit heaps
+        // remain valid.
+        uint32_t j = cuts.size();
+        for (Qubit const& qubit : cuts.node(i).qubits) {
+            j = std::min(j, first_after(by_qubit.at(qubit.uid()), i,
+                              [](uint32_t) { return true; }));
+        }
+        for (uint32_t w = 0u; w <= cut_width - width(i); ++w) {
+            j = std::min(j, first_after(by_width.at(w), i,
+                              [&](uint32_t cut) { return width(cut) == w; }));
+        }
+        if (j == cuts.size() || cuts.union_size(i, j) > cut_width
+            || cuts.node(i).cbits != cuts.node(j).cbits) {
+            continue;
+        }
+        uint32_t const old_width = width(j);
+        cuts.merge_into(i, j);
+        if (width(j) != old_width) {
+            push(j);
         }
     }
-    // After merging some cuts, remove the empty ones
-    auto end = std::remove_if(
-      cuts.begin(), cuts.end(), [](Cut const& cut) { return cut.empty(); });
-    cuts.erase(end, cuts.end());
-    return cuts;
+    return cuts.build();
 }
 
 } // namespace tweedledum
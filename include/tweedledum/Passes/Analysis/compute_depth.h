@@ -8,12 +8,21 @@
 #include "compute_asap_layers.h"
 
 #include <algorithm>
+#include <type_traits>
 #include <vector>
 
 namespace tweedledum {
 
-inline uint32_t compute_depth(Circuit const& circuit)
+// `CircuitT` can be a `Circuit` or a view (see `IR/Views.h`.)  O(1) if the
+// circuit maintains its layers (see `Circuit::enable_layers`.)
+template<typename CircuitT>
+uint32_t compute_depth(CircuitT const& circuit)
 {
+    if constexpr (std::is_same_v<CircuitT, Circuit>) {
+        if (circuit.has_layers()) {
+            return circuit.depth();
+        }
+    }
     std::vector<uint32_t> layers = compute_asap_layers(circuit);
     auto it = std::max_element(layers.begin(), layers.end());
     return *it + 1;
@@ -0,0 +1,108 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../../IR/Circuit.h"
+#include "../../IR/Instruction.h"
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+namespace tweedledum {
+
+// Timing of a circuit's instructions, indexed by `InstRef`.
+struct Schedule {
+    std::vector<double> duration;
+    // Earliest (ASAP) start time of each instruction
+    std::vector<double> start;
+    // How much each instruction can be delayed without increasing the latency,
+    // i.e., its latest (ALAP) start time minus its earliest start time.
+    std::vector<double> slack;
+    // A longest path, in program order.  All its instructions have zero slack.
+    std::vector<InstRef> critical_path;
+    // Total duration of the circuit
+    double latency = 0.0;
+
+    double finish(InstRef const ref) const
+    {
+        return start.at(ref) + duration.at(ref);
+    }
+};
+
+/*! \brief Duration-aware ASAP/ALAP scheduling.
+ *
+ * The weighted counterpart of `compute_asap_layers`, `compute_alap_layers` and
+ * `compute_critical_paths`: an instruction starts once all of its children
+ * have finished.  Takes time linear in the size of the circuit.
+ *
+ * `duration` gives the duration of an instruction.  It is either called with
+ * the instruction, e.g. `Durations` (see `Target/Durations.h`), or with its
+ * reference and the instruction, e.g. to read an `InstructionTable<double>`.
+ *
+ * `CircuitT` can be a `Circuit` or a view (see `IR/Views.h`.)
+ */
+template<typename CircuitT, typename DurationFn>
+Schedule compute_schedule(CircuitT const& circuit, DurationFn&& duration)
+{
+    // clang-format off
+    static_assert(std::is_invocable_r_v<double, DurationFn, Instruction const&> ||
+                  std::is_invocable_r_v<double, DurationFn, InstRef, Instruction const&>);
+    // clang-format on
+    uint32_t const num_refs = circuit.num_refs();
+    Schedule schedule;
+    schedule.duration.resize(num_refs, 0.0);
+    schedule.start.resize(num_refs, 0.0);
+    schedule.slack.resize(num_refs, 0.0);
+
+    // Forward pass: earliest start times.  We also keep the child that
+    // finishes last, to recover a critical path.
+    std::vector<InstRef> last_child(num_refs, InstRef::invalid());
+    InstRef last = InstRef::invalid();
+    circuit.foreach_instruction([&](InstRef const ref, Instruction const& inst) {
+        if constexpr (std::is_invocable_r_v<double, DurationFn,
+                        Instruction const&>) {
+            schedule.duration.at(ref) = duration(inst);
+        } else {
+            schedule.duration.at(ref) = duration(ref, inst);
+        }
+        double start = 0.0;
+        circuit.foreach_child(ref, [&](InstRef const child) {
+            if (last_child.at(ref) == InstRef::invalid()
+                || schedule.finish(child) > start) {
+                start = schedule.finish(child);
+                last_child.at(ref) = child;
+            }
+        });
+        schedule.start.at(ref) = start;
+        if (last == InstRef::invalid()
+            || schedule.finish(ref) > schedule.latency) {
+            schedule.latency = schedule.finish(ref);
+            last = ref;
+        }
+    });
+
+    // Backward pass: latest finish times
+    std::vector<double> latest_finish(num_refs, schedule.latency);
+    circuit.foreach_r_instruction([&](InstRef const ref) {
+        double const latest_start =
+          latest_finish.at(ref) - schedule.duration.at(ref);
+        schedule.slack.at(ref) =
+          std::max(0.0, latest_start - schedule.start.at(ref));
+        circuit.foreach_child(ref, [&](InstRef const child) {
+            latest_finish.at(child) =
+              std::min(latest_finish.at(child), latest_start);
+        });
+    });
+
+    for (InstRef ref = last; !(ref == InstRef::invalid());
+         ref = last_child.at(ref)) {
+        schedule.critical_path.push_back(ref);
+    }
+    std::reverse(schedule.critical_path.begin(), schedule.critical_path.end());
+    return schedule;
+}
+
+} // namespace tweedledum
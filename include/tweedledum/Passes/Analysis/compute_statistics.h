@@ -0,0 +1,126 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../../IR/Circuit.h"
+#include "../../IR/Instruction.h"
+#include "../../IR/OperatorKind.h"
+#include "../../Operators/Ising.h"
+#include "../../Operators/Meta/Parametric.h"
+#include "../../Operators/Standard.h"
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace tweedledum {
+
+// Operator statistics of a circuit.
+struct CircuitStatistics {
+    uint32_t num_instructions = 0u;
+    // Indexed by operator kind identifier (see `IR/OperatorKind.h`), and then
+    // by number of controls.  Use `count` to query by name.
+    std::vector<std::vector<uint32_t>> by_kind;
+    // Number of instructions acting on each qubit, indexed by uid
+    std::vector<uint32_t> by_qubit;
+    // By number of qubits (controls included)
+    uint32_t num_one_qubit = 0u;
+    uint32_t num_two_qubit = 0u;
+    uint32_t num_multi_qubit = 0u;
+    // Uncontrolled T and T† instructions
+    uint32_t t_count = 0u;
+    // Parameterized rotations (Rx, Ry, Rz, P, Rxx, Ryy, Rzz), controlled or
+    // not, including symbolic ones (`Op::Parametric`.)
+    uint32_t num_rotations = 0u;
+
+    // Number of instructions of a kind (e.g. "std.x") with `num_controls`
+    // controls
+    uint32_t count(
+      std::string_view const kind, uint32_t const num_controls) const
+    {
+        std::optional<uint32_t> const id = find_operator_kind(kind);
+        if (!id || *id >= by_kind.size()
+            || num_controls >= by_kind[*id].size()) {
+            return 0u;
+        }
+        return by_kind[*id][num_controls];
+    }
+
+    // Number of instructions of a kind, regardless of their controls
+    uint32_t count_all(std::string_view const kind) const
+    {
+        std::optional<uint32_t> const id = find_operator_kind(kind);
+        uint32_t result = 0u;
+        if (id && *id < by_kind.size()) {
+            for (uint32_t const count : by_kind[*id]) {
+                result += count;
+            }
+        }
+        return result;
+    }
+};
+
+/*! \brief Computes operator statistics in a single pass.
+ *
+ * Instructions are counted by integer operator kind and number of controls,
+ * no strings are built.  (`count_operators` turns such counters into names.)
+ *
+ * `CircuitT` can be a `Circuit` or a view (see `IR/Views.h`.)
+ */
+template<typename CircuitT>
+CircuitStatistics compute_statistics(CircuitT const& circuit)
+{
+    auto is_rotation = [](std::string_view const kind) {
+        return kind == Op::Rx::kind() || kind == Op::Ry::kind()
+            || kind == Op::Rz::kind() || kind == Op::P::kind()
+            || kind == Op::Rxx::kind() || kind == Op::Ryy::kind()
+            || kind == Op::Rzz::kind();
+    };
+    CircuitStatistics stats;
+    stats.by_qubit.resize(circuit.num_qubits(), 0u);
+    circuit.foreach_instruction([&](Instruction const& inst) {
+        uint32_t const kind_id = inst.kind_id();
+        uint32_t const num_controls = inst.num_controls();
+        if (stats.by_kind.size() <= kind_id) {
+            stats.by_kind.resize(kind_id + 1);
+        }
+        std::vector<uint32_t>& kind_counter = stats.by_kind[kind_id];
+        if (kind_counter.size() <= num_controls) {
+            kind_counter.resize(num_controls + 1, 0u);
+        }
+        kind_counter[num_controls] += 1;
+        stats.num_instructions += 1;
+
+        inst.foreach_qubit(
+          [&](Qubit const qubit) { stats.by_qubit.at(qubit.uid()) += 1; });
+        switch (inst.num_qubits()) {
+        case 0u:
+            break;
+        case 1u:
+            stats.num_one_qubit += 1;
+            break;
+        case 2u:
+            stats.num_two_qubit += 1;
+            break;
+        default:
+            stats.num_multi_qubit += 1;
+            break;
+        }
+
+        if (num_controls == 0u && inst.is_one<Op::T, Op::Tdg>()) {
+            stats.t_count += 1;
+        } else if (inst.is_one<Op::Rx, Op::Ry, Op::Rz, Op::P, Op::Rxx,
+                     Op::Ryy, Op::Rzz>()) {
+            stats.num_rotations += 1;
+        } else if (inst.is_a<Op::Parametric>()
+                   && is_rotation(inst.cast<Op::Parametric>().target_kind())) {
+            stats.num_rotations += 1;
+        }
+    });
+    return stats;
+}
+
+} // namespace tweedledum
@@ -9,25 +9,71 @@
 
 #include <algorithm>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
+#include <vector>
 
 namespace tweedledum {
 
-inline auto count_operators(Circuit const& circuit)
+namespace detail {
+
+// Builds the names out of (kind, number of controls) counters.
+inline std::unordered_map<std::string, uint32_t> count_names(
+  std::vector<std::vector<uint32_t>> const& kind_counters)
 {
     std::unordered_map<std::string, uint32_t> counters;
-    circuit.foreach_instruction([&](Instruction const& inst) {
-        std::string id =
-          inst.num_controls() == 0
-            ? fmt::format("{}", inst.name())
-            : fmt::format("({}c){}", inst.num_controls(), inst.name());
-        auto it = counters.find(id);
-        if (it != counters.end()) {
-            it->second += 1;
+    for (uint32_t i = 0u; i < kind_counters.size(); ++i) {
+        if (kind_counters.at(i).empty()) {
+            continue;
         }
-        counters.emplace(id, 1u);
-    });
+        std::string_view name = operator_kind_name(i);
+        auto pos = name.find_first_of(".");
+        if (pos != std::string_view::npos) {
+            name.remove_prefix(pos + 1);
+        }
+        for (uint32_t j = 0u; j < kind_counters.at(i).size(); ++j) {
+            if (kind_counters.at(i).at(j) == 0u) {
+                continue;
+            }
+            std::string id = j == 0 ? fmt::format("{}", name)
+                                    : fmt::format("({}c){}", j, name);
+            counters[id] += kind_counters.at(i).at(j);
+        }
+    }
     return counters;
 }
 
+} // namespace detail
+
+// `CircuitT` can be a `Circuit` or a view (see `IR/Views.h`.)
+template<typename CircuitT>
+auto count_operators(CircuitT const& circuit)
+{
+    // Count (kind, number of controls) pairs, only then build the names.
+    std::vector<std::vector<uint32_t>> kind_counters;
+    auto count = [&](uint32_t const kind_id, uint32_t const num_controls) {
+        if (kind_counters.size() <= kind_id) {
+            kind_counters.resize(kind_id + 1);
+        }
+        std::vector<uint32_t>& kind_counter = kind_counters.at(kind_id);
+        if (kind_counter.size() <= num_controls) {
+            kind_counter.resize(num_controls + 1, 0u);
+        }
+        kind_counter.at(num_controls) += 1;
+    };
+    if constexpr (std::is_same_v<CircuitT, Circuit>) {
+        if (circuit.has_columns()) {
+            InstructionColumns const& columns = circuit.columns();
+            circuit.foreach_instruction([&](InstRef ref) {
+                count(columns.kind_id(ref), columns.num_controls(ref));
+            });
+            return detail::count_names(kind_counters);
+        }
+    }
+    circuit.foreach_instruction([&](Instruction const& inst) {
+        count(inst.kind_id(), inst.num_controls());
+    });
+    return detail::count_names(kind_counters);
+}
+
 } // namespace tweedledum
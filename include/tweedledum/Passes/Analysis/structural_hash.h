@@ -0,0 +1,180 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../../IR/Circuit.h"
+#include "../../IR/Instruction.h"
+#include "../../IR/StructuralHash.h"
+#include "../../Utils/Cut.h"
+
+#include <algorithm>
+#include <cassert>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tweedledum {
+
+// Structural hash of the sub-circuit formed by the instructions of `cut`.
+//
+// Wires are identified by their position in the cut, and instructions outside
+// the cut are ignored.  Hence the hash of a cut is the same as the structural
+// hash of the circuit obtained by copying the instructions of the cut, in
+// order, to a new circuit whose wires are the wires of the cut (see
+// `Circuit::structural_hash`).  In particular, identical blocks acting on
+// different wires have the same hash.
+inline uint64_t structural_hash(Circuit const& circuit, Cut const& cut)
+{
+    auto local = [&](auto const wire, auto const& wires) {
+        for (uint32_t i = 0u; i < wires.size(); ++i) {
+            if (wires[i].uid() == wire.uid()) {
+                return i;
+            }
+        }
+        assert(0 && "Wire is not in the cut");
+        return 0u;
+    };
+    auto local_wire = [&](auto const wire) {
+        if constexpr (std::is_same_v<decltype(wire), Qubit const>) {
+            return Qubit(local(wire, cut.qubits));
+        } else {
+            return Cbit(local(wire, cut.cbits));
+        }
+    };
+
+    std::vector<std::pair<InstRef, uint64_t>> nodes;
+    nodes.reserve(cut.instructions.size());
+    for (InstRef const ref : cut.instructions) {
+        nodes.emplace_back(ref, 0u);
+    }
+    std::sort(nodes.begin(), nodes.end(),
+      [](auto const& a, auto const& b) { return a.first < b.first; });
+    auto find = [&](InstRef const ref) {
+        auto it = std::lower_bound(nodes.begin(), nodes.end(), ref,
+          [](auto const& node, InstRef const r) { return node.first < r; });
+        return (it != nodes.end() && it->first == ref) ? &*it : nullptr;
+    };
+
+    // The children of an instruction must be hashed before it.  References
+    // follow the program order only in compact circuits, otherwise we sort
+    // the cut topologically: depth-first, visiting the children in the cut.
+    std::vector<uint32_t> order;
+    order.reserve(nodes.size());
+    if (circuit.is_compact()) {
+        for (uint32_t i = 0u; i < nodes.size(); ++i) {
+            order.push_back(i);
+        }
+    } else {
+        // 0: not visited, 1: visiting its children, 2: done
+        std::vector<uint8_t> state(nodes.size(), 0u);
+        std::vector<uint32_t> stack;
+        auto visit = [&](InstRef const child) {
+            auto const* node = find(child);
+            if (node != nullptr && state.at(node - nodes.data()) == 0u) {
+                stack.push_back(node - nodes.data());
+            }
+        };
+        for (uint32_t i = 0u; i < nodes.size(); ++i) {
+            stack.push_back(i);
+            while (!stack.empty()) {
+                uint32_t const n = stack.back();
+                if (state.at(n) == 0u) {
+                    state.at(n) = 1u;
+                    Instruction const& inst =
+                      circuit.instruction(nodes[n].first);
+                    inst.foreach_cbit(visit);
+                    inst.foreach_qubit(visit);
+                    continue;
+                }
+                stack.pop_back();
+                if (state.at(n) == 1u) {
+                    state.at(n) = 2u;
+                    order.push_back(n);
+                }
+            }
+        }
+    }
+
+    uint64_t sum = 0u;
+    for (uint32_t const n : order) {
+        auto& [ref, hash] = nodes[n];
+        Instruction const& inst = circuit.instruction(ref);
+        hash = StructuralHash::compute(
+          inst, [&](auto const wire, InstRef const child) {
+              auto const* node = child == InstRef::invalid() ? nullptr
+                                                             : find(child);
+              if (node == nullptr) {
+                  return StructuralHash::input_hash(local_wire(wire));
+              }
+              return StructuralHash::child_hash(
+                node->second, circuit.instruction(child), wire);
+          });
+        sum += hash;
+    }
+    hash_combine(sum, cut.qubits.size());
+    hash_combine(sum, cut.cbits.size());
+    hash_combine(sum, hash_double(0.0));
+    return sum;
+}
+
+// Returns true if both circuits have the same wires, global phase and
+// instruction DAG, i.e., if they only differ in the order of independent
+// instructions.  (Meant to resolve collisions of `structural_hash`.)
+inline bool structurally_equal(Circuit const& a, Circuit const& b)
+{
+    if (a.num_qubits() != b.num_qubits() || a.num_cbits() != b.num_cbits()
+        || a.num_instructions() != b.num_instructions()
+        || a.global_phase() != b.global_phase()) {
+        return false;
+    }
+    // The instructions of `b` on each wire, in order.  We go through `a` in
+    // program order: the instruction matching the current one must be the
+    // next (unmatched) instruction of `b` on all of its wires.
+    uint32_t const num_wires = b.num_qubits() + b.num_cbits();
+    std::vector<std::vector<InstRef>> wire_instructions(num_wires);
+    b.foreach_instruction([&](InstRef const ref, Instruction const& inst) {
+        inst.foreach_qubit(
+          [&](Qubit const qubit) { wire_instructions[qubit].push_back(ref); });
+        inst.foreach_cbit([&](Cbit const cbit) {
+            wire_instructions[b.num_qubits() + cbit].push_back(ref);
+        });
+    });
+    std::vector<uint32_t> next(num_wires, 0u);
+    auto next_on = [&](uint32_t const wire) {
+        return next[wire] < wire_instructions[wire].size()
+               ? wire_instructions[wire][next[wire]]
+               : InstRef::invalid();
+    };
+
+    bool equal = true;
+    a.foreach_instruction([&](Instruction const& inst) {
+        if (!equal) {
+            return;
+        }
+        InstRef const ref = next_on(inst.qubit(0u));
+        if (ref == InstRef::invalid()) {
+            equal = false;
+            return;
+        }
+        Instruction const& other = b.instruction(ref);
+        if (!(static_cast<Operator const&>(inst)
+                == static_cast<Operator const&>(other))
+            || inst.qubits() != other.qubits()
+            || inst.cbits() != other.cbits()) {
+            equal = false;
+            return;
+        }
+        auto advance = [&](uint32_t const wire) {
+            equal &= (next_on(wire) == ref);
+            next[wire] += 1;
+        };
+        inst.foreach_qubit([&](Qubit const qubit) { advance(qubit); });
+        inst.foreach_cbit(
+          [&](Cbit const cbit) { advance(b.num_qubits() + cbit); });
+    });
+    return equal;
+}
+
+} // namespace tweedledum
@@ -8,3 +8,4 @@
 #include "Decomposition/bridge_decomp.h"
 #include "Decomposition/one_qubit_decomp.h"
 #include "Decomposition/parity_decomp.h"
+#include "Decomposition/subcircuit_decomp.h"
@@ -0,0 +1,22 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../../IR/Circuit.h"
+
+namespace tweedledum {
+
+/*! \brief Inlines all subcircuits (`Op::Subcircuit`), recursively.
+ *
+ * Each body is flattened (and inverted, for adjoint subcircuits) only once,
+ * no matter how many times it is used.  The global phases of the bodies are
+ * added to the global phase of the result.
+ *
+ * \param[in] original A quantum circuit (__will not be modified__).
+ * \returns a __new__ circuit without subcircuits.
+ */
+Circuit subcircuit_decomp(Circuit const& original);
+
+} // namespace tweedledum
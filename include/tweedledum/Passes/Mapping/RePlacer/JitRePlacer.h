@@ -5,11 +5,11 @@
 #pragma once
 
 #include "../../../IR/Circuit.h"
+#include "../../../IR/InstructionTable.h"
 #include "../../../IR/Qubit.h"
 #include "../../../Operators/Reversible.h"
 #include "../../../Target/Device.h"
 #include "../../../Target/Placement.h"
-#include "../../Utility/reverse.h"
 
 namespace tweedledum {
 
@@ -20,7 +20,7 @@ public:
         : device_(device)
         , original_(original)
         , placement_(placement)
-        , visited_(original_.num_instructions(), 0u)
+        , visited_(original_.num_refs(), 0u)
         , involved_phy_(device_.num_qubits(), 0u)
         , phy_decay_(device_.num_qubits(), 1.0)
         , num_swaps_(0u)
@@ -28,17 +28,17 @@ public:
         extended_layer_.reserve(e_set_size_);
     }
 
+    // A forward pass followed by a backward one: the resulting placement is
+    // tuned for the beginning of the circuit, i.e., to be used as the initial
+    // placement for a (forward) router.
     void run()
     {
-        Circuit reversed = reverse(original_);
-        for (uint32_t i = 0; i < 1; ++i) {
-            current_ = &original_;
-            do_run();
-
-            current_ = &reversed;
-            reset();
-            do_run();
-        }
+        forward_ = true;
+        do_run();
+
+        forward_ = false;
+        reset();
+        do_run();
     }
 
 private:
@@ -48,11 +48,22 @@ private:
 
     void reset()
     {
-        std::fill(visited_.begin(), visited_.end(), 0u);
+        visited_.reset();
         std::fill(phy_decay_.begin(), phy_decay_.end(), 1.0);
         num_swaps_ = 0u;
     }
 
+    // Next instructions in the direction of the current pass.
+    template<typename Fn>
+    void foreach_next(InstRef const ref, Fn&& fn) const
+    {
+        if (forward_) {
+            original_.foreach_successor(ref, fn);
+        } else {
+            original_.foreach_child(ref, fn);
+        }
+    }
+
     bool add_front_layer();
 
     void select_extended_layer();
@@ -73,10 +84,10 @@ private:
 
     Device const& device_;
     Circuit const& original_;
-    Circuit const* current_;
+    bool forward_ = true;
     Placement& placement_;
 
-    std::vector<uint32_t> visited_;
+    InstructionTable<uint32_t> visited_;
 
     // Sabre internals
     std::vector<InstRef> front_layer_;
@@ -5,11 +5,11 @@
 #pragma once
 
 #include "../../../IR/Circuit.h"
+#include "../../../IR/InstructionTable.h"
 #include "../../../IR/Qubit.h"
 #include "../../../Operators/Reversible.h"
 #include "../../../Target/Device.h"
 #include "../../../Target/Placement.h"
-#include "../../Utility/reverse.h"
 
 namespace tweedledum {
 
@@ -20,20 +20,22 @@ public:
         : device_(device)
         , original_(original)
         , placement_(placement)
-        , visited_(original.num_instructions(), 0u)
+        , visited_(original.num_refs(), 0u)
         , involved_phy_(device_.num_qubits(), 0u)
         , phy_decay_(device_.num_qubits(), 1.0)
     {
         extended_layer_.reserve(e_set_size_);
     }
 
+    // A forward pass followed by a backward one: the resulting placement is
+    // tuned for the beginning of the circuit, i.e., to be used as the initial
+    // placement for a (forward) router.
     void run()
     {
-        current_ = &original_;
+        forward_ = true;
         do_run();
 
-        Circuit reversed = reverse(original_);
-        current_ = &reversed;
+        forward_ = false;
         reset();
         do_run();
     }
@@ -45,10 +47,21 @@ private:
 
     void reset()
     {
-        std::fill(visited_.begin(), visited_.end(), 0u);
+        visited_.reset();
         std::fill(phy_decay_.begin(), phy_decay_.end(), 1.0);
     }
 
+    // Next instructions in the direction of the current pass.
+    template<typename Fn>
+    void foreach_next(InstRef const ref, Fn&& fn) const
+    {
+        if (forward_) {
+            original_.foreach_successor(ref, fn);
+        } else {
+            original_.foreach_child(ref, fn);
+        }
+    }
+
     bool add_front_layer();
 
     void select_extended_layer();
@@ -63,10 +76,10 @@ private:
 
     Device const& device_;
     Circuit const& original_;
-    Circuit const* current_;
+    bool forward_ = true;
     Placement& placement_;
 
-    std::vector<uint32_t> visited_;
+    InstructionTable<uint32_t> visited_;
 
     // Sabre internals
     std::vector<InstRef> front_layer_;
@@ -5,12 +5,12 @@
 #pragma once
 
 #include "../../../IR/Circuit.h"
+#include "../../../IR/InstructionTable.h"
 #include "../../../IR/Qubit.h"
 #include "../../../Operators/Reversible.h"
 #include "../../../Target/Device.h"
 #include "../../../Target/Mapping.h"
 #include "../../../Target/Placement.h"
-#include "../../Utility/reverse.h"
 
 namespace tweedledum {
 
@@ -21,7 +21,7 @@ public:
         : device_(device)
         , original_(original)
         , mapping_(init_placement)
-        , visited_(original_.num_instructions(), 0u)
+        , visited_(original_.num_refs(), 0u)
         , involved_phy_(device_.num_qubits(), 0u)
         , phy_decay_(device_.num_qubits(), 1.0)
     {
@@ -49,7 +49,7 @@ private:
     Circuit const& original_;
     Circuit* mapped_;
     Mapping mapping_;
-    std::vector<uint32_t> visited_;
+    InstructionTable<uint32_t> visited_;
 
     // Sabre internals
     std::vector<InstRef> front_layer_;
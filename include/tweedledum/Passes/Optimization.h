@@ -4,7 +4,10 @@
 *-----------------------------------------------------------------------------*/
 #pragma once
 
+#include "Optimization/commutative_cancellation.h"
 #include "Optimization/gate_cancellation.h"
 #include "Optimization/linear_resynth.h"
+#include "Optimization/one_qubit_fusion.h"
 #include "Optimization/phase_folding.h"
 #include "Optimization/steiner_resynth.h"
+#include "Optimization/two_qubit_resynth.h"
@@ -0,0 +1,30 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../../IR/Circuit.h"
+
+namespace tweedledum {
+
+/*! \brief Gate cancellation modulo commutation.
+ *
+ * Unlike `gate_cancellation`, which only cancels adjacent instructions, this
+ * pass looks through commuting instructions (see `CommutationDag`): two
+ * instructions on the same qubits that are in the same commutation group on
+ * all of them can be brought together.  Such pairs are
+ *   - removed, if one is the adjoint of the other;
+ *   - merged, if they are rotations around the same axis, e.g.
+ *     Rz(a)·Rz(b) = Rz(a + b); or powers of T (T·T = S, S·S = Z, ...) or of
+ *     √X (√X·√X = X), when the product is a single gate.
+ * Removing a pair can bring together the instructions around it, e.g. the
+ * outer pair of H·Y·Y·H.  A single pass, in near-linear time, removes such
+ * nested pairs too.
+ *
+ * \param[in] original A quantum circuit (__will not be modified__).
+ * \returns a __new__ optimized circuit.
+ */
+Circuit commutative_cancellation(Circuit const& original);
+
+} // namespace tweedledum
@@ -0,0 +1,31 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../../IR/Circuit.h"
+
+#include <nlohmann/json.hpp>
+
+namespace tweedledum {
+
+/*! \brief Fuses runs of one-qubit instructions.
+ *
+ * Maximal runs of one-qubit instructions on each qubit are multiplied into a
+ * single 2x2 unitary.  A run that is the identity, up to global phase, is
+ * removed.  Otherwise the unitary is decomposed with `OneQubitDecomposer`
+ * (the basis is given in `config`, as for `one_qubit_decomp`), and the
+ * decomposition replaces the run if it has fewer instructions.
+ *
+ * Instructions without a matrix (e.g. symbolic ones) and instructions with
+ * classical bits end runs.
+ *
+ * \param[in] original A quantum circuit (__will not be modified__).
+ * \param[in] config Configuration of `OneQubitDecomposer`.
+ * \returns a __new__ optimized circuit.
+ */
+Circuit one_qubit_fusion(
+  Circuit const& original, nlohmann::json const& config = {});
+
+} // namespace tweedledum
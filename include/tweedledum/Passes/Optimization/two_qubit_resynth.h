@@ -0,0 +1,33 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../../IR/Circuit.h"
+
+#include <nlohmann/json.hpp>
+
+namespace tweedledum {
+
+/*! \brief Resynthesizes two-qubit blocks with the minimal number of CX.
+ *
+ * The circuit is partitioned with `compute_cuts(original, 2)`.  The unitary
+ * of each two-qubit cut is computed and decomposed with `TwoQubitDecomposer`,
+ * which needs at most three CX operators.  The decomposition replaces the cut
+ * if it is cheaper: it needs fewer CX operators than the two-qubit
+ * instructions of the cut (a two-qubit instruction costs the number of CX
+ * operators needed to implement it, e.g. three for a swap), or as many but
+ * fewer instructions overall.
+ *
+ * Cuts with classical bits, negative controls or instructions without a
+ * matrix (e.g. symbolic ones) are kept as they are.
+ *
+ * \param[in] original A quantum circuit (__will not be modified__).
+ * \param[in] config Configuration of `TwoQubitDecomposer`.
+ * \returns a __new__ optimized circuit.
+ */
+Circuit two_qubit_resynth(
+  Circuit const& original, nlohmann::json const& config = {});
+
+} // namespace tweedledum
@@ -4,6 +4,7 @@
 *-----------------------------------------------------------------------------*/
 #pragma once
 
+#include "Utility/bind_parameters.h"
 #include "Utility/inverse.h"
 #include "Utility/reverse.h"
 #include "Utility/shallow_duplicate.h"
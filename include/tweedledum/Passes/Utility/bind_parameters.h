@@ -0,0 +1,93 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../../IR/Circuit.h"
+#include "../../Operators/Meta/Parametric.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <vector>
+
+namespace tweedledum {
+
+/*! \brief Returns the number of symbols used by the parametric operators.
+ *
+ * \param[in] circuit A quantum circuit (__will not be modified__).
+ * \returns the largest symbol index plus one.
+ */
+inline uint32_t num_parameters(Circuit const& circuit)
+{
+    uint32_t result = 0u;
+    circuit.foreach_instruction([&](Instruction const& inst) {
+        if (!inst.is_a<Op::Parametric>()) {
+            return;
+        }
+        Op::Parametric const& optor = inst.cast<Op::Parametric>();
+        for (uint32_t i = 0u; i < optor.num_parameters(); ++i) {
+            if (!optor.parameter(i).is_constant()) {
+                result = std::max(result, optor.parameter(i).index() + 1);
+            }
+        }
+    });
+    return result;
+}
+
+/*! \brief Binds the symbolic parameters of a circuit, many times.
+ *
+ * The parametric instructions are found once, and each bound circuit is a
+ * copy of the original in which only their operators are replaced.  Hence
+ * the original's structure (wires and dependencies), and the work done by the
+ * passes that produced it (e.g. mapping), is reused across bindings.
+ *
+ * \param[in] original A parametric quantum circuit (__will not be modified__).
+ * \param[in] values A vector of values for the symbols, for each binding.
+ * \returns a __new__ circuit for each vector of values.
+ * \throws std::out_of_range if a vector of values is shorter than
+ *         `num_parameters(original)`.
+ */
+inline std::vector<Circuit> batch_bind_parameters(
+  Circuit const& original, std::vector<std::vector<double>> const& values)
+{
+    std::vector<InstRef> parametric;
+    original.foreach_instruction([&](InstRef ref, Instruction const& inst) {
+        if (inst.is_a<Op::Parametric>()) {
+            parametric.push_back(ref);
+        }
+    });
+    uint32_t const num_symbols = num_parameters(original);
+    for (std::vector<double> const& binding : values) {
+        if (binding.size() < num_symbols) {
+            throw std::out_of_range("Missing values for parameter symbols");
+        }
+    }
+    std::vector<Circuit> result;
+    result.reserve(values.size());
+    for (std::vector<double> const& binding : values) {
+        Circuit& bound = result.emplace_back(original);
+        for (InstRef const ref : parametric) {
+            Op::Parametric const& optor =
+              original.instruction(ref).cast<Op::Parametric>();
+            bound.set_operator(ref, optor.bind(binding));
+        }
+    }
+    return result;
+}
+
+/*! \brief Binds the symbolic parameters of a circuit.
+ *
+ * \param[in] original A parametric quantum circuit (__will not be modified__).
+ * \param[in] values The values of the symbols.
+ * \returns a __new__ circuit without parametric operators.
+ * \throws std::out_of_range if `values` is shorter than
+ *         `num_parameters(original)`.
+ */
+inline Circuit bind_parameters(
+  Circuit const& original, std::vector<double> const& values)
+{
+    return std::move(batch_bind_parameters(original, {values}).front());
+}
+
+} // namespace tweedledum
@@ -9,6 +9,8 @@
 
 namespace tweedledum {
 
+// Use `ReversedView` to avoid the copy.  (Unlike the view, this also works on
+// circuits that are not compact.)
 inline Circuit reverse(Circuit const& original)
 {
     Circuit reversed = shallow_duplicate(original);
@@ -12,6 +12,9 @@
 namespace tweedledum {
 
 /*! \brief Creates a new circuit with same wires as the original.
+ *
+ * The duplicate uses the same storage modes, i.e., it will have columnar storage
+ * and an operator arena if the original has.
  *
  * \param[in] original A quantum circuit (__will not be modified__).
  * \returns a __new__ circuit without operators.
@@ -19,6 +22,12 @@ namespace tweedledum {
 inline Circuit shallow_duplicate(Circuit const& original)
 {
     Circuit duplicate;
+    if (original.has_columns()) {
+        duplicate.enable_columns();
+    }
+    if (original.has_arena()) {
+        duplicate.enable_arena();
+    }
     original.foreach_cbit(
       [&](std::string_view name) { duplicate.create_cbit(name); });
     original.foreach_qubit(
@@ -4,6 +4,8 @@
 *-----------------------------------------------------------------------------*/
 #pragma once
 
+#include "Durations.h"
+
 #include <Eigen/Dense>
 #include <algorithm>
 #include <cstdint>
@@ -177,6 +179,17 @@ public:
         return shortest_path_.at(idx).size() - 1;
     }
 
+    // Durations of the operators on this device (see `compute_schedule`.)
+    Durations& durations()
+    {
+        return durations_;
+    }
+
+    Durations const& durations() const
+    {
+        return durations_;
+    }
+
     std::vector<Device::Edge> steiner_tree(
       std::vector<uint32_t> terminals, uint32_t root) const;
 
@@ -208,6 +221,7 @@ private:
     std::vector<Edge> edges_;
     mutable std::vector<std::vector<uint32_t>> dist_matrix_;
     mutable std::vector<std::vector<uint32_t>> shortest_path_;
+    Durations durations_;
 };
 
 inline void Device::compute_shortest_paths() const
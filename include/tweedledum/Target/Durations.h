@@ -0,0 +1,95 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include "../IR/Instruction.h"
+#include "../IR/OperatorKind.h"
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace tweedledum {
+
+/*! \brief Duration of each instruction, e.g. in nanoseconds.
+ *
+ * Durations can be given per operator kind (e.g. "std.x"), and per operator
+ * kind on a particular ordered list of qubits (e.g. a CX calibrated on
+ * qubits (0, 1)), which takes precedence.  The qubits are the qubits of the
+ * instruction, controls first, and are identified by their uid.  Instructions
+ * without a matching entry take the default duration.
+ *
+ * Meant to be passed to `compute_schedule`.
+ */
+class Durations {
+public:
+    explicit Durations(double const default_duration = 1.0)
+        : default_(default_duration)
+    {}
+
+    double default_duration() const
+    {
+        return default_;
+    }
+
+    void set(std::string_view const kind, double const duration)
+    {
+        uint32_t const id = register_operator_kind(kind);
+        if (by_kind_.size() <= id) {
+            by_kind_.resize(id + 1, -1.0);
+        }
+        by_kind_.at(id) = duration;
+    }
+
+    void set(std::string_view const kind, std::vector<uint32_t> const& qubits,
+      double const duration)
+    {
+        std::string key = kind_key(register_operator_kind(kind));
+        for (uint32_t const qubit : qubits) {
+            append(key, qubit);
+        }
+        by_qubits_[key] = duration;
+    }
+
+    double operator()(Instruction const& inst) const
+    {
+        uint32_t const id = inst.kind_id();
+        if (!by_qubits_.empty()) {
+            std::string key = kind_key(id);
+            inst.foreach_qubit(
+              [&](Qubit const qubit) { append(key, qubit.uid()); });
+            auto search = by_qubits_.find(key);
+            if (search != by_qubits_.end()) {
+                return search->second;
+            }
+        }
+        if (id < by_kind_.size() && by_kind_[id] >= 0.0) {
+            return by_kind_[id];
+        }
+        return default_;
+    }
+
+private:
+    // The kind and the qubits are packed in a string, which we can hash.
+    static std::string kind_key(uint32_t const id)
+    {
+        std::string key;
+        append(key, id);
+        return key;
+    }
+
+    static void append(std::string& key, uint32_t const value)
+    {
+        key.append(reinterpret_cast<char const*>(&value), sizeof(value));
+    }
+
+    double default_;
+    std::vector<double> by_kind_;
+    std::unordered_map<std::string, double> by_qubits_;
+};
+
+} // namespace tweedledum
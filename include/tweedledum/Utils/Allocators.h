@@ -58,7 +58,8 @@ public:
     template<typename T>
     T* allocate(size_t const num = 1)
     {
-        return static_cast<T*>(allocate(num * sizeof(T), alignof(T)));
+        return static_cast<T*>(static_cast<DerivedT*>(this)->allocate(
+          num * sizeof(T), alignof(T)));
     }
 
     /*! \brief Deallocate space for a sequence of `num` objects of type `T`. */
@@ -66,7 +67,8 @@ public:
     std::enable_if_t<!std::is_same<std::remove_cv_t<T>, void>::value, void>
     deallocate(T* ptr, size_t const num = 1)
     {
-        deallocate(static_cast<void const*>(ptr), num * sizeof(T));
+        static_cast<DerivedT*>(this)->deallocate(
+          static_cast<void const*>(ptr), num * sizeof(T));
     }
 };
 
@@ -34,16 +34,16 @@ struct Cut {
         std::sort(cbits.begin(), cbits.end());
     }
 
+    // Adds the qubits of `instruction` that are not yet in the cut (in place,
+    // keeping them sorted.)
     void add_intruction(InstRef ref, Instruction const& instruction)
     {
-        std::vector<Qubit> qs = instruction.qubits();
-        std::sort(qs.begin(), qs.end());
-
-        std::vector<Qubit> qubits_union;
-        std::set_union(qubits.begin(), qubits.end(), qs.begin(), qs.end(),
-          std::back_inserter(qubits_union));
-
-        qubits = std::move(qubits_union);
+        instruction.foreach_qubit([&](Qubit const qubit) {
+            auto it = std::lower_bound(qubits.begin(), qubits.end(), qubit);
+            if (it == qubits.end() || qubit < *it) {
+                qubits.insert(it, qubit);
+            }
+        });
         instructions.emplace_back(ref);
     }
 
@@ -4,12 +4,43 @@
 *-----------------------------------------------------------------------------*/
 #pragma once
 
+#include <cstdint>
+#include <cstring>
 #include <functional>
 #include <set>
 #include <vector>
 
 namespace tweedledum {
 
+// Finalizer of SplitMix64: a cheap bijection with good avalanche.
+inline uint64_t hash_mix(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ull;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebull;
+    x ^= x >> 31;
+    return x;
+}
+
+inline void hash_combine(uint64_t& seed, uint64_t const value)
+{
+    seed ^= hash_mix(value) + 0x9e3779b97f4a7c15ull + (seed << 12)
+          + (seed >> 4);
+}
+
+// Hashes the bits of `value`, but -0.0 and 0.0 hash the same, as they compare
+// equal.  (NaNs don't compare equal to anything, so they don't matter.)
+inline uint64_t hash_double(double value)
+{
+    if (value == 0.0) {
+        value = 0.0;
+    }
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return hash_mix(bits);
+}
+
 template<typename T>
 struct Hash : public std::hash<T> {};
 
@@ -4,12 +4,30 @@
 *-----------------------------------------------------------------------------*/
 #pragma once
 
-#include <iterator>
+#include "Hash.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <parallel_hashmap/phmap.h>
+#include <utility>
 #include <vector>
 
 namespace tweedledum {
 
 // Linear Phase Polynomial (LinerPP)
+//
+// Terms are kept in a vector, indexed by a hash set of positions in the
+// vector, so adding and extracting terms take constant (expected) time.
+// Iteration visits the terms in increasing order of parity; the vector is
+// sorted lazily, on the first iteration after terms were extracted or added
+// out of order.  The sort is guarded by a mutex, hence a polynomial can be
+// iterated concurrently (as long as no thread modifies it.)
+//
+// A parity is an ESOP of positive literals (`var << 1`, variables start at 1)
+// in increasing order.  The `uint32_t` overloads take a bitmask of variables
+// instead (bit `i` is variable `i + 1`), they never build an ESOP to look up a
+// term.
 class LinPhasePoly {
 public:
     using Parity = std::vector<uint32_t>;
@@ -17,6 +35,44 @@ public:
 
     LinPhasePoly() = default;
 
+    // Copies are sorted
+    LinPhasePoly(LinPhasePoly const& other)
+    {
+        other.sort();
+        terms_ = other.terms_;
+        reindex();
+    }
+
+    LinPhasePoly(LinPhasePoly&& other)
+        : terms_(std::move(other.terms_))
+        , sorted_(other.sorted_.load())
+    {
+        other.clear();
+        reindex();
+    }
+
+    LinPhasePoly& operator=(LinPhasePoly const& other)
+    {
+        if (this != &other) {
+            other.sort();
+            terms_ = other.terms_;
+            sorted_ = true;
+            reindex();
+        }
+        return *this;
+    }
+
+    LinPhasePoly& operator=(LinPhasePoly&& other)
+    {
+        if (this != &other) {
+            terms_ = std::move(other.terms_);
+            sorted_ = other.sorted_.load();
+            other.clear();
+            reindex();
+        }
+        return *this;
+    }
+
     uint32_t size() const
     {
         return terms_.size();
@@ -24,6 +80,7 @@ public:
 
     auto begin() const
     {
+        sort();
         return terms_.cbegin();
     }
 
@@ -34,38 +91,123 @@ public:
 
     void add_term(uint32_t parity, double const angle)
     {
-        add_term(convert(parity), angle);
+        auto it = index_.find(Mask{parity});
+        if (it != index_.end()) {
+            terms_[it->pos].second += angle;
+            return;
+        }
+        emplace(convert(parity), angle);
     }
 
     void add_term(Parity const& parity, double const angle)
     {
-        auto it = lower_bound(terms_.begin(), terms_.end(), parity);
-        if (it != terms_.end() && it->first == parity) {
-            it->second += angle;
+        auto it = index_.find(parity);
+        if (it != index_.end()) {
+            terms_[it->pos].second += angle;
             return;
         }
-        terms_.emplace(it, parity, angle);
+        emplace(parity, angle);
     }
 
     double extract_phase(uint32_t parity)
     {
-        return extract_phase(convert(parity));
+        return extract(index_.find(Mask{parity}));
     }
 
     double extract_phase(Parity const& parity)
     {
-        auto it = lower_bound(terms_.begin(), terms_.end(), parity);
-        if (it == terms_.end() || it->first != parity) {
-            return 0;
-        }
-        double const angle = it->second;
-        terms_.erase(it);
-        return angle;
+        return extract(index_.find(parity));
     }
 
 private:
-    using Iterator = typename std::vector<PhaseParity>::iterator;
-    using DistType = typename std::iterator_traits<Iterator>::difference_type;
+    // The position of a term in `terms_`
+    struct TermPos {
+        uint32_t pos;
+    };
+
+    // A parity given as a bitmask of variables
+    struct Mask {
+        uint32_t bits;
+    };
+
+    // Hashes (and compares) terms by their parity, so that they can be looked
+    // up by either an ESOP or a bitmask.
+    struct ParityHash {
+        using is_transparent = void;
+
+        size_t operator()(TermPos const term) const
+        {
+            return (*this)((*terms)[term.pos].first);
+        }
+
+        size_t operator()(Parity const& parity) const
+        {
+            uint64_t seed = 0u;
+            for (uint32_t const lit : parity) {
+                hash_combine(seed, lit);
+            }
+            return seed;
+        }
+
+        size_t operator()(Mask const mask) const
+        {
+            uint64_t seed = 0u;
+            uint32_t parity = mask.bits;
+            for (uint32_t i = 1; parity; ++i, parity >>= 1) {
+                if (parity & 1) {
+                    hash_combine(seed, (i << 1));
+                }
+            }
+            return seed;
+        }
+
+        std::vector<PhaseParity> const* terms;
+    };
+
+    struct ParityEqual {
+        using is_transparent = void;
+
+        bool operator()(TermPos const a, TermPos const b) const
+        {
+            return a.pos == b.pos;
+        }
+
+        bool operator()(TermPos const a, Parity const& b) const
+        {
+            return (*terms)[a.pos].first == b;
+        }
+
+        bool operator()(Parity const& a, TermPos const b) const
+        {
+            return (*this)(b, a);
+        }
+
+        bool operator()(TermPos const a, Mask const b) const
+        {
+            Parity const& esop = (*terms)[a.pos].first;
+            uint32_t parity = b.bits;
+            uint32_t i = 1;
+            for (uint32_t const lit : esop) {
+                for (; parity && !(parity & 1); ++i, parity >>= 1) {
+                }
+                if (!parity || lit != (i << 1)) {
+                    return false;
+                }
+                ++i;
+                parity >>= 1;
+            }
+            return parity == 0u;
+        }
+
+        bool operator()(Mask const a, TermPos const b) const
+        {
+            return (*this)(b, a);
+        }
+
+        std::vector<PhaseParity> const* terms;
+    };
+
+    using Index = phmap::flat_hash_set<TermPos, ParityHash, ParityEqual>;
 
     std::vector<uint32_t> convert(uint32_t parity) const
     {
@@ -79,27 +221,75 @@ private:
         return esop;
     }
 
-    Iterator lower_bound(Iterator first, Iterator last, Parity const& parity)
+    void emplace(Parity const& parity, double const angle)
     {
-        DistType len = std::distance(first, last);
-        while (len > 0) {
-            if (first->first == parity) {
-                break;
-            }
-            DistType half = len >> 1;
-            Iterator middle = first;
-            std::advance(middle, half);
-            if (middle->first < parity) {
-                first = ++middle;
-                len -= half + 1;
-            } else {
-                len = half;
-            }
+        if (sorted_ && !terms_.empty() && parity < terms_.back().first) {
+            sorted_ = false;
+        }
+        terms_.emplace_back(parity, angle);
+        index_.insert(TermPos{static_cast<uint32_t>(terms_.size() - 1)});
+    }
+
+    // Removes the term by moving the last one in its place.
+    double extract(Index::iterator it)
+    {
+        if (it == index_.end()) {
+            return 0;
+        }
+        uint32_t const pos = it->pos;
+        double const angle = terms_[pos].second;
+        index_.erase(it);
+        uint32_t const last = terms_.size() - 1;
+        if (pos != last) {
+            index_.erase(TermPos{last});
+            terms_[pos] = std::move(terms_.back());
+            terms_.pop_back();
+            index_.insert(TermPos{pos});
+            sorted_ = false;
+            return angle;
+        }
+        terms_.pop_back();
+        return angle;
+    }
+
+    void clear()
+    {
+        terms_.clear();
+        index_.clear();
+        sorted_ = true;
+    }
+
+    void reindex() const
+    {
+        index_.clear();
+        index_.reserve(terms_.size());
+        for (uint32_t i = 0u; i < terms_.size(); ++i) {
+            index_.insert(TermPos{i});
+        }
+    }
+
+    void sort() const
+    {
+        if (sorted_.load(std::memory_order_acquire)) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (sorted_.load(std::memory_order_relaxed)) {
+            return;
         }
-        return first;
+        std::sort(terms_.begin(), terms_.end(),
+          [](PhaseParity const& a, PhaseParity const& b) {
+              return a.first < b.first;
+          });
+        reindex();
+        sorted_.store(true, std::memory_order_release);
     }
 
-    std::vector<PhaseParity> terms_;
+    mutable std::vector<PhaseParity> terms_;
+    // The hash and equality look parities up in `terms_`
+    mutable Index index_{0, ParityHash{&terms_}, ParityEqual{&terms_}};
+    mutable std::mutex mutex_;
+    mutable std::atomic<bool> sorted_{true};
 };
 
 } // namespace tweedledum
@@ -10,6 +10,7 @@
 #include <cstring>
 #include <iterator>
 #include <limits>
+#include <memory>
 #include <type_traits>
 
 // Based this implementation on what I have seen in LLVM's SmallVector
@@ -146,6 +147,16 @@ public:
         return const_reverse_iterator(begin());
     }
 
+    pointer data()
+    {
+        return pointer(begin());
+    }
+
+    const_pointer data() const
+    {
+        return const_pointer(begin());
+    }
+
     size_type max_size() const
     {
         return std::min(
@@ -543,7 +554,8 @@ public:
         }
     }
 
-    SmallVector(SmallVector&& other)
+    // Both vectors have the same inline capacity, so this never allocates.
+    SmallVector(SmallVector&& other) noexcept
         : detail::SmallVector<T>(NumElements)
     {
         if (!other.empty()) {
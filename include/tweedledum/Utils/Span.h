@@ -0,0 +1,102 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+namespace tweedledum {
+
+/*! \brief A non-owning view over a contiguous sequence of objects.
+ *
+ * This is a (very) stripped down version of C++20's `std::span`.  It can be
+ * constructed from a pointer and a size, or from any container that provides
+ * `data()` and `size()`, e.g. `std::vector` or `SmallVector`.
+ */
+template<typename T>
+class Span {
+    template<typename Container>
+    using enable_if_container_t = std::enable_if_t<
+      std::is_convertible_v<decltype(std::declval<Container&>().data()), T*>
+      && !std::is_same_v<std::remove_cv_t<Container>, Span>>;
+
+public:
+    using element_type = T;
+    using value_type = std::remove_cv_t<T>;
+    using iterator = T*;
+
+    constexpr Span() noexcept
+        : data_(nullptr)
+        , size_(0u)
+    {}
+
+    constexpr Span(T* data, uint32_t size) noexcept
+        : data_(data)
+        , size_(size)
+    {}
+
+    template<typename Container, typename = enable_if_container_t<Container>>
+    constexpr Span(Container& container) noexcept
+        : data_(container.data())
+        , size_(container.size())
+    {}
+
+    template<typename Container, typename = enable_if_container_t<Container>>
+    constexpr Span(Container const& container) noexcept
+        : data_(container.data())
+        , size_(container.size())
+    {}
+
+    constexpr T* data() const noexcept
+    {
+        return data_;
+    }
+
+    constexpr uint32_t size() const noexcept
+    {
+        return size_;
+    }
+
+    constexpr bool empty() const noexcept
+    {
+        return size_ == 0u;
+    }
+
+    constexpr iterator begin() const noexcept
+    {
+        return data_;
+    }
+
+    constexpr iterator end() const noexcept
+    {
+        return data_ + size_;
+    }
+
+    constexpr T& operator[](uint32_t idx) const
+    {
+        assert(idx < size_);
+        return data_[idx];
+    }
+
+    constexpr T& front() const
+    {
+        assert(!empty());
+        return data_[0];
+    }
+
+    constexpr T& back() const
+    {
+        assert(!empty());
+        return data_[size_ - 1];
+    }
+
+private:
+    T* data_;
+    uint32_t size_;
+};
+
+} // namespace tweedledum
@@ -0,0 +1,171 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace tweedledum {
+
+/*! \brief A fixed set of worker threads for data-parallel loops.
+ *
+ * The only operation is `parallel_for`, which blocks until all iterations are
+ * done, i.e., it is a barrier.  The calling thread takes part in the work, so a
+ * pool with `n` threads starts `n - 1` workers.  Iterations are handed out in
+ * chunks, from a shared counter.
+ *
+ * A pool runs one loop at a time: `parallel_for` must not be called from
+ * within an iteration, nor concurrently from different threads.
+ */
+class ThreadPool {
+public:
+    // By default, use one thread per hardware thread.
+    explicit ThreadPool(uint32_t num_threads = 0u)
+    {
+        if (num_threads == 0u) {
+            num_threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        workers_.reserve(num_threads - 1);
+        for (uint32_t i = 1u; i < num_threads; ++i) {
+            workers_.emplace_back([this]() { worker_loop(); });
+        }
+    }
+
+    ThreadPool(ThreadPool const&) = delete;
+    ThreadPool& operator=(ThreadPool const&) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_.notify_all();
+        for (std::thread& worker : workers_) {
+            worker.join();
+        }
+    }
+
+    uint32_t num_threads() const
+    {
+        return workers_.size() + 1;
+    }
+
+    // Calls `fn(i)` for each `i` in [begin, end), and waits for all calls to
+    // return.  If a call throws, no new chunks are handed out, and the first
+    // exception is rethrown once the calls in flight have returned.
+    template<typename Fn>
+    void parallel_for(uint32_t const begin, uint32_t const end, Fn&& fn)
+    {
+        static_assert(std::is_invocable_r_v<void, Fn, uint32_t>);
+        if (begin >= end) {
+            return;
+        }
+        uint32_t const size = end - begin;
+        if (workers_.empty() || size == 1u) {
+            for (uint32_t i = begin; i < end; ++i) {
+                fn(i);
+            }
+            return;
+        }
+        using FnT = std::remove_reference_t<Fn>;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            task_ = const_cast<void*>(static_cast<void const*>(&fn));
+            call_ = [](void* task, uint32_t const i) {
+                (*static_cast<FnT*>(task))(i);
+            };
+            next_.store(begin, std::memory_order_relaxed);
+            end_ = end;
+            grain_ = std::max(1u, size / (4 * num_threads()));
+            num_busy_ = workers_.size();
+            ++generation_;
+        }
+        start_.notify_all();
+        run_chunks();
+        std::unique_lock<std::mutex> lock(mutex_);
+        done_.wait(lock, [this]() { return num_busy_ == 0u; });
+        task_ = nullptr;
+        if (error_) {
+            std::exception_ptr const error = std::exchange(error_, nullptr);
+            lock.unlock();
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    void worker_loop()
+    {
+        uint64_t seen = 0u;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_.wait(
+                  lock, [&]() { return stop_ || generation_ != seen; });
+                if (stop_) {
+                    return;
+                }
+                seen = generation_;
+            }
+            run_chunks();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                --num_busy_;
+            }
+            done_.notify_one();
+        }
+    }
+
+    // Must not throw: an exception escaping a worker terminates the program,
+    // and one escaping the calling thread would unwind `fn` while workers
+    // still use it.
+    void run_chunks() noexcept
+    {
+        try {
+            while (true) {
+                uint32_t const first =
+                  next_.fetch_add(grain_, std::memory_order_relaxed);
+                if (first >= end_) {
+                    return;
+                }
+                uint32_t const last = std::min(end_, first + grain_);
+                for (uint32_t i = first; i < last; ++i) {
+                    call_(task_, i);
+                }
+            }
+        } catch (...) {
+            next_.store(end_, std::memory_order_relaxed);
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (!error_) {
+                error_ = std::current_exception();
+            }
+        }
+    }
+
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable start_;
+    std::condition_variable done_;
+    bool stop_ = false;
+    uint64_t generation_ = 0u;
+    uint32_t num_busy_ = 0u;
+    // Current loop
+    void* task_ = nullptr;
+    void (*call_)(void*, uint32_t) = nullptr;
+    std::atomic<uint32_t> next_{0u};
+    uint32_t end_ = 0u;
+    uint32_t grain_ = 1u;
+    std::exception_ptr error_;
+};
+
+} // namespace tweedledum
@@ -18,10 +18,10 @@ void init_Passes(pybind11::module& module)
     namespace py = pybind11;
 
     // Analysis
-    module.def("compute_alap_layers", &compute_alap_layers, 
+    module.def("compute_alap_layers", &compute_alap_layers<Circuit>, 
         "Compute instructions' ALAP layer.");
 
-    module.def("compute_asap_layers", &compute_asap_layers, 
+    module.def("compute_asap_layers", &compute_asap_layers<Circuit>, 
         "Compute instructions' ASAP layer.");
 
     module.def("compute_critical_paths", &compute_critical_paths, 
@@ -29,9 +29,9 @@ void init_Passes(pybind11::module& module)
 
     module.def("compute_cuts", &compute_cuts, "Compute circuit cuts.");
 
-    module.def("compute_depth", &compute_depth, "Compute circuit depth.");
+    module.def("compute_depth", &compute_depth<Circuit>, "Compute circuit depth.");
 
-    module.def("count_operators", &count_operators, "Operators couting pass.");
+    module.def("count_operators", &count_operators<Circuit>, "Operators couting pass.");
 
 
     // Decomposition
@@ -58,18 +58,29 @@ void init_Passes(pybind11::module& module)
     module.def("sabre_map", &sabre_map);
 
     // Optimization
+    module.def("commutative_cancellation", &commutative_cancellation,
+        "Gate cancellation modulo commutation, with rotation merging.");
+
     module.def("gate_cancellation", &gate_cancellation, "Gate cancellation optimization.");
 
     module.def("linear_resynth", &linear_resynth, 
         py::arg("original"), py::arg("config") = nlohmann::json(),
         "Resynthesize linear parts of the quantum circuit.");
 
+    module.def("one_qubit_fusion", &one_qubit_fusion,
+        py::arg("original"), py::arg("config") = nlohmann::json(),
+        "Fuse runs of one-qubit gates.");
+
     module.def("phase_folding", &phase_folding, "Phase folding optimization.");
 
     module.def("steiner_resynth", &steiner_resynth, 
         py::arg("device"), py::arg("original"), py::arg("config") = nlohmann::json(),
         "Coupling-aware resynthesize linear parts of the quantum circuit.");
 
+    module.def("two_qubit_resynth", &two_qubit_resynth,
+        py::arg("original"), py::arg("config") = nlohmann::json(),
+        "Resynthesize two-qubit blocks with the minimal number of CX.");
+
     // Utility
     module.def("inverse", &inverse,
         "Invert (take adjoint of) a circuit.");
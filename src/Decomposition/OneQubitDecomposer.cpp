@@ -121,10 +121,11 @@ double OneQubitDecomposer::add_rx(
     return 0.0;
 }
 
-void OneQubitDecomposer::add_ry(Circuit& circuit, Instruction const& inst,
+double OneQubitDecomposer::add_ry(Circuit& circuit, Instruction const& inst,
   double angle, [[maybe_unused]] double atol)
 {
     circuit.apply_operator(Op::Ry(angle), inst.qubits(), inst.cbits());
+    return angle / 2;
 }
 
 double OneQubitDecomposer::add_rz(
@@ -168,7 +169,8 @@ bool OneQubitDecomposer::circuit_xz_xy(Circuit& circuit,
     double global_phase = params.phase - ((params.phi + params.lambda) / 2);
     if (std::abs(params.theta) < config.atol) {
         double total = params.phi + params.lambda;
-        circuit.global_phase() += add_rx_rz(circuit, inst, total, config.atol);
+        global_phase += add_rx_rz(circuit, inst, total, config.atol);
+        circuit.global_phase() += global_phase;
         return true;
     }
     if (std::abs(params.theta - numbers::pi) < config.atol) {
@@ -177,8 +179,11 @@ bool OneQubitDecomposer::circuit_xz_xy(Circuit& circuit,
         params.phi = 0;
     }
     global_phase += add_rx_rz(circuit, inst, params.lambda, config.atol);
-    // Do not optimized this one:
-    add_rx_ry(circuit, inst, params.theta, std::numeric_limits<double>::min());
+    // Do not optimized this one (but it might get normalized, e.g. Rx(pi) is
+    // emitted as Rx(-pi)):
+    global_phase += add_rx_ry(circuit, inst, params.theta,
+                      std::numeric_limits<double>::min())
+                  - (params.theta / 2);
     global_phase += add_rx_rz(circuit, inst, params.phi, config.atol);
     circuit.global_phase() += global_phase;
     return true;
@@ -199,7 +204,7 @@ bool OneQubitDecomposer::circuit_pz_xsx(Circuit& circuit,
     if (std::abs(params.theta - numbers::pi_div_2) < config.atol) {
         circuit.global_phase() +=
           add_phase(circuit, inst, params.lambda - numbers::pi_div_2);
-        add_x(circuit, inst);
+        circuit.global_phase() += add_x(circuit, inst);
         circuit.global_phase() +=
           add_phase(circuit, inst, params.phi + numbers::pi_div_2);
         return true;
@@ -240,7 +245,8 @@ bool OneQubitDecomposer::decompose(Circuit& circuit, Instruction const& inst)
         break;
 
     case Basis::zsxx:
-        break;
+        // Not implemented
+        return false;
 
     case Basis::zxz:
         circuit_xz_xy(circuit, inst, zxz_params, add_rz, add_rx);
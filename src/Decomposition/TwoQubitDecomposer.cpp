@@ -0,0 +1,371 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/Decomposition/TwoQubitDecomposer.h"
+
+#include "tweedledum/Operators/Extension/Unitary.h"
+#include "tweedledum/Operators/Standard/Rx.h"
+#include "tweedledum/Operators/Standard/Ry.h"
+#include "tweedledum/Operators/Standard/Rz.h"
+#include "tweedledum/Operators/Standard/X.h"
+#include "tweedledum/Utils/Numbers.h"
+
+#include <Eigen/Eigenvalues>
+#include <array>
+#include <cmath>
+#include <random>
+
+namespace tweedledum {
+
+namespace {
+
+using namespace std::complex_literals;
+
+// Local operators are 4x4 matrices of the form A1 x A0, where A0 acts on the
+// first qubit (the least significant bit of the matrix indices.)
+UMatrix4 kron(UMatrix2 const& a1, UMatrix2 const& a0)
+{
+    UMatrix4 result;
+    for (uint32_t i = 0u; i < 4u; ++i) {
+        for (uint32_t j = 0u; j < 4u; ++j) {
+            result(i, j) = a1(i >> 1, j >> 1) * a0(i & 1, j & 1);
+        }
+    }
+    return result;
+}
+
+struct Paulis {
+    UMatrix2 x;
+    UMatrix2 y;
+    UMatrix2 z;
+    // Pauli products XX, YY and ZZ.
+    std::array<UMatrix4, 3> pp;
+
+    Paulis()
+    {
+        x << 0, 1, 1, 0;
+        y << 0, -1i, 1i, 0;
+        z << 1, 0, 0, -1;
+        pp = {kron(x, x), kron(y, y), kron(z, z)};
+    }
+};
+
+Paulis const paulis;
+
+// The "magic" basis, in which local operators are real orthogonal matrices and
+// the interaction exp(i(a XX + b YY + c ZZ)) is diagonal.
+UMatrix4 magic_basis()
+{
+    UMatrix4 magic;
+    // clang-format off
+    magic << 1,  0,  0,  1i,
+             0,  1i, 1,  0,
+             0,  1i, -1, 0,
+             1,  0,  0,  -1i;
+    // clang-format on
+    return magic / std::sqrt(2.0);
+}
+
+UMatrix4 const magic = magic_basis();
+
+// U = e^{i phase} l1 exp(i(a XX + b YY + c ZZ)) l2, with l1 and l2 local.
+struct KAK {
+    double phase;
+    std::array<double, 3> coords;
+    UMatrix4 l1;
+    UMatrix4 l2;
+};
+
+// Diagonalizes the complex symmetric unitary `s` with a real orthogonal
+// matrix.  The real and imaginary parts of `s` are real symmetric matrices
+// that commute, so a random combination of them has the same eigenvectors
+// (unless we are unlucky, hence the retries.)
+Eigen::Matrix4d diagonalize(UMatrix4 const& s, double const atol)
+{
+    std::mt19937 rng(1u);
+    std::uniform_real_distribution<double> dist(-1.0, 1.0);
+    Eigen::Matrix4d p = Eigen::Matrix4d::Identity();
+    for (uint32_t i = 0u; i < 16u; ++i) {
+        Eigen::Matrix4d const m = dist(rng) * s.real() + dist(rng) * s.imag();
+        Eigen::SelfAdjointEigenSolver<Eigen::Matrix4d> solver(m);
+        p = solver.eigenvectors();
+        UMatrix4 d = p.transpose().cast<Complex>() * s * p.cast<Complex>();
+        d.diagonal().setZero();
+        if (d.norm() < atol) {
+            break;
+        }
+    }
+    if (p.determinant() < 0) {
+        p.col(0) *= -1;
+    }
+    return p;
+}
+
+KAK compute_kak(UMatrix4 const& matrix, double const atol)
+{
+    KAK kak;
+    kak.phase = std::arg(matrix.determinant()) / 4;
+    UMatrix4 const su = matrix * std::exp(Complex(0, -kak.phase));
+    UMatrix4 const su_magic = magic.adjoint() * su * magic;
+    UMatrix4 const s = su_magic.transpose() * su_magic;
+    UMatrix4 const p = diagonalize(s, atol).cast<Complex>();
+    UMatrix4 const d = p.transpose() * s * p;
+
+    // The diagonal of the interaction, in the magic basis, is e^{i theta}.
+    // Its determinant must be one.  (The sum of the thetas is a multiple of
+    // pi, changing theta_0 by pi only flips the sign of a column of k1.)
+    Eigen::Vector4d theta;
+    for (uint32_t i = 0u; i < 4u; ++i) {
+        theta(i) = std::arg(d(i, i)) / 2;
+    }
+    theta(0) -= std::round(theta.sum() / numbers::pi) * numbers::pi;
+    UMatrix4 const interaction =
+      (theta.cast<Complex>() * 1i).array().exp().matrix().asDiagonal();
+    UMatrix4 const k1 = su_magic * p * interaction.adjoint();
+    kak.l1 = magic * k1 * magic.adjoint();
+    kak.l2 = magic * p.transpose() * magic.adjoint();
+    for (uint32_t i = 0u; i < 3u; ++i) {
+        UMatrix4 const pp = magic.adjoint() * paulis.pp.at(i) * magic;
+        kak.coords.at(i) = pp.diagonal().real().dot(theta) / 4;
+    }
+    return kak;
+}
+
+// Moves the coordinates into the Weyl chamber, pi/4 >= a >= b >= |c| (with
+// c >= 0 when a = pi/4), updating the local operators accordingly.
+void canonicalize(KAK& kak, double const atol)
+{
+    auto& coords = kak.coords;
+    // exp(i a PP) = exp(i(a - m pi/2) PP) (i PP)^m, and PP commutes with the
+    // interaction.
+    auto shift = [&](uint32_t const i, double const m) {
+        coords.at(i) -= m * numbers::pi_div_2;
+        kak.phase += m * numbers::pi_div_2;
+        if (static_cast<int64_t>(m) % 2) {
+            kak.l2 = paulis.pp.at(i) * kak.l2;
+        }
+    };
+    // Conjugating by a Pauli on one qubit flips the sign of the two other
+    // coordinates.
+    auto flip = [&](uint32_t const i, uint32_t const j) {
+        UMatrix2 const& pauli = (i + j == 1u) ? paulis.z
+                              : (i + j == 2u) ? paulis.y
+                                              : paulis.x;
+        UMatrix4 const local = kron(UMatrix2::Identity(), pauli);
+        coords.at(i) = -coords.at(i);
+        coords.at(j) = -coords.at(j);
+        kak.l1 = kak.l1 * local;
+        kak.l2 = local * kak.l2;
+    };
+    // Conjugating by S x S exchanges XX and YY, and by H x H, XX and ZZ.
+    auto swap = [&](uint32_t const i, uint32_t const j) {
+        UMatrix2 local;
+        if (i + j == 1u) {
+            local << 1, 0, 0, 1i;
+        } else {
+            local << 1, 1, 1, -1;
+            local /= std::sqrt(2.0);
+        }
+        UMatrix4 const k = kron(local, local);
+        std::swap(coords.at(i), coords.at(j));
+        kak.l1 = kak.l1 * k.adjoint();
+        kak.l2 = k * kak.l2;
+    };
+    auto swap_bc = [&]() {
+        swap(0, 1);
+        swap(0, 2);
+        swap(0, 1);
+    };
+
+    for (uint32_t i = 0u; i < 3u; ++i) {
+        double m = std::round(coords.at(i) / numbers::pi_div_2);
+        if (coords.at(i) - m * numbers::pi_div_2 < -numbers::pi_div_4 + atol) {
+            m -= 1;
+        }
+        shift(i, m);
+    }
+    if (std::abs(coords.at(0)) < std::abs(coords.at(1))) {
+        swap(0, 1);
+    }
+    if (std::abs(coords.at(0)) < std::abs(coords.at(2))) {
+        swap(0, 2);
+    }
+    if (std::abs(coords.at(1)) < std::abs(coords.at(2))) {
+        swap_bc();
+    }
+    if (coords.at(0) < 0) {
+        flip(0, 2);
+    }
+    if (coords.at(1) < 0) {
+        flip(1, 2);
+    }
+    if (coords.at(0) > numbers::pi_div_4 - atol && coords.at(2) < 0) {
+        flip(0, 2);
+        shift(0, -1);
+    }
+}
+
+KAK canonical_kak(UMatrix4 const& matrix, double const atol)
+{
+    KAK kak = compute_kak(matrix, atol);
+    canonicalize(kak, atol);
+    return kak;
+}
+
+uint32_t count_cx(std::array<double, 3> const& coords, double const atol)
+{
+    if (std::abs(coords.at(2)) > atol) {
+        return 3u;
+    }
+    if (std::abs(coords.at(1)) > atol) {
+        return 2u;
+    }
+    if (std::abs(coords.at(0) - numbers::pi_div_4) < atol) {
+        return 1u;
+    }
+    return std::abs(coords.at(0)) > atol ? 2u : 0u;
+}
+
+UMatrix unitary_of(Circuit const& circuit)
+{
+    Op::UnitaryBuilder builder(circuit.num_qubits(), circuit.global_phase());
+    circuit.foreach_instruction([&](Instruction const& inst) {
+        std::vector<uint32_t> qubits;
+        inst.foreach_qubit(
+          [&](Qubit const qubit) { qubits.push_back(qubit.uid()); });
+        builder.apply_operator(inst, qubits);
+    });
+    return builder.finished().matrix();
+}
+
+// A circuit with `num_cx` CX operators whose interaction has the given
+// (canonical) coordinates.
+Circuit interaction_circuit(
+  uint32_t const num_cx, std::array<double, 3> const& coords)
+{
+    Circuit circuit;
+    Qubit const q0 = circuit.create_qubit();
+    Qubit const q1 = circuit.create_qubit();
+    auto const [a, b, c] = coords;
+    switch (num_cx) {
+    case 1u:
+        circuit.apply_operator(Op::X(), {q0, q1});
+        break;
+
+    // CX (X x I) CX = XX and CX (I x Z) CX = ZZ.
+    case 2u:
+        circuit.apply_operator(Op::X(), {q0, q1});
+        circuit.apply_operator(Op::Rx(-2 * a), {q0});
+        circuit.apply_operator(Op::Rz(-2 * b), {q1});
+        circuit.apply_operator(Op::X(), {q0, q1});
+        break;
+
+    // Vatan and Williams, "Optimal quantum circuits for general two-qubit
+    // gates", Phys. Rev. A 69, 032315 (2004).
+    case 3u:
+        circuit.apply_operator(Op::X(), {q1, q0});
+        circuit.apply_operator(Op::Rz(2 * a + numbers::pi_div_2), {q0});
+        circuit.apply_operator(Op::Ry(2 * b + numbers::pi_div_2), {q1});
+        circuit.apply_operator(Op::X(), {q0, q1});
+        circuit.apply_operator(Op::Ry(2 * c + numbers::pi_div_2), {q1});
+        circuit.apply_operator(Op::X(), {q1, q0});
+        break;
+
+    default:
+        break;
+    }
+    return circuit;
+}
+
+// Splits a local operator into A1 x A0.
+std::pair<UMatrix2, UMatrix2> split_local(UMatrix4 const& local)
+{
+    uint32_t row = 0u;
+    uint32_t col = 0u;
+    double max_norm = 0.0;
+    for (uint32_t i = 0u; i < 2u; ++i) {
+        for (uint32_t j = 0u; j < 2u; ++j) {
+            double const norm = local.block<2, 2>(2 * i, 2 * j).norm();
+            if (norm > max_norm) {
+                max_norm = norm;
+                row = i;
+                col = j;
+            }
+        }
+    }
+    UMatrix2 a0 = local.block<2, 2>(2 * row, 2 * col);
+    a0 /= std::sqrt(a0.determinant());
+    UMatrix2 a1;
+    for (uint32_t i = 0u; i < 2u; ++i) {
+        for (uint32_t j = 0u; j < 2u; ++j) {
+            UMatrix2 const block = local.block<2, 2>(2 * i, 2 * j);
+            a1(i, j) = (a0.adjoint() * block).trace() / 2.0;
+        }
+    }
+    return {a1, a0};
+}
+
+} // namespace
+
+TwoQubitDecomposer::Config::Config(nlohmann::json const& config)
+    : atol(1e-9)
+{
+    auto kak_config = config.find("two_qubit_decomp");
+    if (kak_config != config.end()) {
+        if (kak_config->contains("atol")) {
+            atol = kak_config->at("atol");
+        }
+    }
+}
+
+uint32_t TwoQubitDecomposer::num_cx(UMatrix const& matrix) const
+{
+    assert(matrix.rows() == 4 && matrix.cols() == 4);
+    KAK const kak = canonical_kak(matrix, config.atol);
+    return count_cx(kak.coords, config.atol);
+}
+
+bool TwoQubitDecomposer::decompose(Circuit& circuit, Instruction const& inst)
+{
+    std::optional<UMatrix> const matrix = inst.matrix();
+    if (!matrix || matrix->rows() != 4 || inst.num_qubits() != 2u) {
+        return false;
+    }
+    KAK const kak = canonical_kak(*matrix, config.atol);
+    uint32_t const num_cx = count_cx(kak.coords, config.atol);
+
+    // Instead of working out the local operators of each interaction circuit
+    // by hand, we decompose the circuit itself: both have the same canonical
+    // interaction, hence U = e^{i phase} (l1 l1'^-1) circuit (l2'^-1 l2).
+    Circuit const interaction = interaction_circuit(num_cx, kak.coords);
+    KAK const interaction_kak =
+      canonical_kak(unitary_of(interaction), config.atol);
+    auto const [a1, a0] = split_local(interaction_kak.l2.adjoint() * kak.l2);
+    auto const [b1, b0] = split_local(kak.l1 * interaction_kak.l1.adjoint());
+
+    Circuit decomposed;
+    Qubit const q0 = decomposed.create_qubit();
+    Qubit const q1 = decomposed.create_qubit();
+    decomposed.global_phase() = kak.phase - interaction_kak.phase;
+    auto add_local = [&](UMatrix2 const& local, Qubit const qubit) {
+        Instruction const local_inst(
+          Op::Unitary(local), Span<Qubit const>(&qubit, 1u), {});
+        return one_qubit_decomposer_.decompose(decomposed, local_inst);
+    };
+    if (!add_local(a0, q0) || !add_local(a1, q1)) {
+        return false;
+    }
+    decomposed.append(interaction, {q0, q1}, {});
+    if (!add_local(b0, q0) || !add_local(b1, q1)) {
+        return false;
+    }
+    if (!unitary_of(decomposed).isApprox(*matrix, config.atol * 1e3)) {
+        return false;
+    }
+    circuit.append(decomposed, inst.qubits(), {});
+    circuit.global_phase() += decomposed.global_phase();
+    return true;
+}
+
+} // namespace tweedledum
@@ -58,8 +58,9 @@ void Parser::parse_creg(Circuit& circuit)
     uint32_t size = expect_and_consume_token(Token::Kinds::nninteger);
     expect_and_consume_token(Token::Kinds::r_square);
     expect_and_consume_token(Token::Kinds::semicolon);
+    std::string const register_name = fmt::format("{}_", name);
     for (uint32_t i = 0u; i < size; ++i) {
-        circuit.create_cbit(fmt::format("{}_{}", name, i));
+        circuit.create_cbit(register_name, i);
     }
     return;
 }
@@ -73,8 +74,9 @@ void Parser::parse_qreg(Circuit& circuit)
     uint32_t size = expect_and_consume_token(Token::Kinds::nninteger);
     expect_and_consume_token(Token::Kinds::r_square);
     expect_and_consume_token(Token::Kinds::semicolon);
+    std::string const register_name = fmt::format("{}_", name);
     for (uint32_t i = 0u; i < size; ++i) {
-        circuit.create_qubit(fmt::format("{}_{}", name, i));
+        circuit.create_qubit(register_name, i);
     }
     return;
 }
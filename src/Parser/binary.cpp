@@ -0,0 +1,756 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/Parser/binary.h"
+#include "tweedledum/IR/OperatorTraits.h"
+#include "tweedledum/Operators/Extension/Bridge.h"
+#include "tweedledum/Operators/Extension/Parity.h"
+#include "tweedledum/Operators/Extension/Unitary.h"
+#include "tweedledum/Operators/Ising.h"
+#include "tweedledum/Operators/Meta.h"
+#include "tweedledum/Operators/Standard.h"
+#include "tweedledum/Utils/SmallVector.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define TWEEDLEDUM_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace tweedledum::binary {
+namespace detail {
+
+struct Codec {
+    std::string_view kind;
+    void (*encode)(Instruction const&, std::vector<double>&);
+    Operator (*decode)(Span<double const>);
+    // Whether an instruction with that many qubits and parameters is valid,
+    // i.e. whether it can be decoded and has enough qubits for its targets.
+    bool (*accepts)(uint32_t num_qubits, uint32_t num_parameters);
+};
+
+} // namespace detail
+
+namespace {
+
+using detail::Codec;
+
+constexpr char magic[8] = {'T', 'W', 'D', 'L', 'C', 'I', 'R', 'C'};
+constexpr uint32_t byte_order_mark = 0x01020304u;
+constexpr uint32_t negative_wire = 1u << 31;
+
+struct Header {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+};
+static_assert(sizeof(Header) == 16u);
+
+struct RecordHeader {
+    uint32_t kind;
+    uint16_t num_qubits;
+    uint16_t num_cbits;
+    uint32_t num_parameters;
+    uint32_t reserved;
+};
+static_assert(sizeof(RecordHeader) == 16u);
+
+struct Trailer {
+    uint64_t num_instructions;
+    uint64_t offsets;
+    uint64_t kinds;
+    uint64_t names;
+    uint32_t num_kinds;
+    uint32_t num_qubits;
+    uint32_t num_cbits;
+    uint32_t reserved;
+    double global_phase;
+    char magic[8];
+};
+static_assert(sizeof(Trailer) == 64u);
+
+uint64_t align(uint64_t const position)
+{
+    return (position + 7u) & ~uint64_t(7u);
+}
+
+// Size of a record, without padding at the end.
+uint64_t wires_end(RecordHeader const& header)
+{
+    return sizeof(RecordHeader)
+         + 4u * (uint64_t(header.num_qubits) + header.num_cbits);
+}
+
+template<typename OpT>
+uint32_t num_targets(OpT const& optor)
+{
+    if constexpr (has_num_targets_v<OpT>) {
+        return optor.num_targets();
+    } else {
+        return 1u;
+    }
+}
+
+// Codecs
+template<typename OpT>
+Codec stateless()
+{
+    return {OpT::kind(), [](Instruction const&, std::vector<double>&) {},
+      [](Span<double const>) -> Operator { return OpT(); },
+      [](uint32_t num_qubits, uint32_t num_parameters) {
+          return num_parameters == 0u && num_qubits >= num_targets(OpT());
+      }};
+}
+
+template<typename OpT>
+Codec rotation()
+{
+    return {OpT::kind(),
+      [](Instruction const& inst, std::vector<double>& parameters) {
+          parameters.push_back(inst.cast<OpT>().angle());
+      },
+      [](Span<double const> parameters) -> Operator {
+          assert(parameters.size() == 1u);
+          return OpT(parameters[0]);
+      },
+      [](uint32_t num_qubits, uint32_t num_parameters) {
+          return num_parameters == 1u && num_qubits >= num_targets(OpT(0.0));
+      }};
+}
+
+Codec u_codec()
+{
+    return {Op::U::kind(),
+      [](Instruction const& inst, std::vector<double>& parameters) {
+          Op::U const& u = inst.cast<Op::U>();
+          parameters.insert(parameters.end(), {u.theta(), u.phi(), u.lambda()});
+      },
+      [](Span<double const> parameters) -> Operator {
+          assert(parameters.size() == 3u);
+          return Op::U(parameters[0], parameters[1], parameters[2]);
+      },
+      [](uint32_t num_qubits, uint32_t num_parameters) {
+          return num_parameters == 3u && num_qubits >= 1u;
+      }};
+}
+
+// Column-major, real and imaginary parts interleaved.
+Codec unitary_codec()
+{
+    return {Op::Unitary::kind(),
+      [](Instruction const& inst, std::vector<double>& parameters) {
+          UMatrix const& matrix = inst.cast<Op::Unitary>().matrix();
+          for (uint32_t i = 0u; i < matrix.size(); ++i) {
+              parameters.push_back(matrix.data()[i].real());
+              parameters.push_back(matrix.data()[i].imag());
+          }
+      },
+      [](Span<double const> parameters) -> Operator {
+          uint32_t const dimension = std::sqrt(parameters.size() / 2);
+          assert(2u * dimension * dimension == parameters.size());
+          UMatrix matrix(dimension, dimension);
+          for (uint32_t i = 0u; i < matrix.size(); ++i) {
+              matrix.data()[i] =
+                Complex(parameters[2 * i], parameters[2 * i + 1]);
+          }
+          return Op::Unitary(std::move(matrix));
+      },
+      // The matrix acts on (the targets) at most all of the qubits.
+      [](uint32_t num_qubits, uint32_t num_parameters) {
+          for (uint32_t n = 1u; n <= std::min(num_qubits, 15u); ++n) {
+              if (num_parameters == (2u << (2u * n))) {
+                  return true;
+              }
+          }
+          return false;
+      }};
+}
+
+std::unordered_map<std::string_view, Codec> const& codecs()
+{
+    static std::unordered_map<std::string_view, Codec> const codecs = [] {
+        std::unordered_map<std::string_view, Codec> result;
+        for (Codec const& codec : {
+               // Standard
+               stateless<Op::H>(), stateless<Op::Measure>(),
+               rotation<Op::P>(), rotation<Op::Rx>(), rotation<Op::Ry>(),
+               rotation<Op::Rz>(), stateless<Op::S>(), stateless<Op::Sdg>(),
+               stateless<Op::Sx>(), stateless<Op::Sxdg>(),
+               stateless<Op::Swap>(), stateless<Op::T>(),
+               stateless<Op::Tdg>(), u_codec(), stateless<Op::X>(),
+               stateless<Op::Y>(), stateless<Op::Z>(),
+               // Ising
+               rotation<Op::Rxx>(), rotation<Op::Ryy>(), rotation<Op::Rzz>(),
+               // Extension and meta
+               stateless<Op::Bridge>(), stateless<Op::Parity>(),
+               unitary_codec(), stateless<Op::Barrier>()}) {
+            result.emplace(codec.kind, codec);
+        }
+        return result;
+    }();
+    return codecs;
+}
+
+Codec const* find_codec(std::string_view const kind)
+{
+    auto search = codecs().find(kind);
+    if (search == codecs().end()) {
+        return nullptr;
+    }
+    return &search->second;
+}
+
+template<typename WireT>
+uint32_t encode_wire(WireT const wire)
+{
+    return wire.uid() | (wire.polarity() == WireT::Polarity::negative
+                           ? negative_wire
+                           : 0u);
+}
+
+template<typename WireT>
+WireT decode_wire(uint32_t const data)
+{
+    return WireT(data & ~negative_wire, (data & negative_wire)
+                                          ? WireT::Polarity::negative
+                                          : WireT::Polarity::positive);
+}
+
+} // namespace
+
+bool is_supported(std::string_view const kind)
+{
+    return find_codec(kind) != nullptr;
+}
+
+// Writer
+Writer::Writer(std::ostream& os)
+    : os_(os)
+    , position_(0u)
+    , global_phase_(0.0)
+{
+    Header header;
+    std::memcpy(header.magic, magic, sizeof(magic));
+    header.version = version;
+    header.byte_order = byte_order_mark;
+    write_bytes(&header, sizeof(header));
+}
+
+Qubit Writer::create_qubit(std::string_view const name)
+{
+    qubit_names_.emplace_back(name);
+    return Qubit(qubit_names_.size() - 1);
+}
+
+Cbit Writer::create_cbit(std::string_view const name)
+{
+    cbit_names_.emplace_back(name);
+    return Cbit(cbit_names_.size() - 1);
+}
+
+void Writer::set_global_phase(double const phase)
+{
+    global_phase_ = phase;
+}
+
+bool Writer::write_instruction(Instruction const& inst)
+{
+    uint32_t const kind = file_kind(inst);
+    if (kind == kinds_.size()) {
+        return false;
+    }
+    parameters_.clear();
+    kinds_.at(kind)->encode(inst, parameters_);
+
+    assert(inst.num_qubits() <= std::numeric_limits<uint16_t>::max());
+    assert(inst.num_cbits() <= std::numeric_limits<uint16_t>::max());
+    RecordHeader header;
+    header.kind = kind;
+    header.num_qubits = inst.num_qubits();
+    header.num_cbits = inst.num_cbits();
+    header.num_parameters = parameters_.size();
+    header.reserved = 0u;
+    offsets_.push_back(position_);
+    write_bytes(&header, sizeof(header));
+    inst.foreach_qubit([&](Qubit const qubit) {
+        assert(qubit.uid() < qubit_names_.size());
+        uint32_t const data = encode_wire(qubit);
+        write_bytes(&data, sizeof(data));
+    });
+    inst.foreach_cbit([&](Cbit const cbit) {
+        assert(cbit.uid() < cbit_names_.size());
+        uint32_t const data = encode_wire(cbit);
+        write_bytes(&data, sizeof(data));
+    });
+    write_padding();
+    write_bytes(parameters_.data(), parameters_.size() * sizeof(double));
+    return true;
+}
+
+bool Writer::finish()
+{
+    Trailer trailer;
+    trailer.num_instructions = offsets_.size();
+    trailer.offsets = position_;
+    write_bytes(offsets_.data(), offsets_.size() * sizeof(uint64_t));
+
+    trailer.kinds = position_;
+    for (Codec const* codec : kinds_) {
+        uint32_t const size = codec->kind.size();
+        write_bytes(&size, sizeof(size));
+        write_bytes(codec->kind.data(), size);
+    }
+    write_padding();
+
+    trailer.names = position_;
+    uint64_t offset = 0u;
+    write_bytes(&offset, sizeof(offset));
+    for (std::string const& name : qubit_names_) {
+        offset += name.size();
+        write_bytes(&offset, sizeof(offset));
+    }
+    for (std::string const& name : cbit_names_) {
+        offset += name.size();
+        write_bytes(&offset, sizeof(offset));
+    }
+    for (std::string const& name : qubit_names_) {
+        write_bytes(name.data(), name.size());
+    }
+    for (std::string const& name : cbit_names_) {
+        write_bytes(name.data(), name.size());
+    }
+    write_padding();
+
+    trailer.num_kinds = kinds_.size();
+    trailer.num_qubits = qubit_names_.size();
+    trailer.num_cbits = cbit_names_.size();
+    trailer.reserved = 0u;
+    trailer.global_phase = global_phase_;
+    std::memcpy(trailer.magic, magic, sizeof(magic));
+    write_bytes(&trailer, sizeof(trailer));
+    os_.flush();
+    return static_cast<bool>(os_);
+}
+
+void Writer::write_bytes(void const* data, uint64_t const size)
+{
+    os_.write(static_cast<char const*>(data), size);
+    position_ += size;
+}
+
+void Writer::write_padding()
+{
+    constexpr char zeros[8] = {};
+    write_bytes(zeros, align(position_) - position_);
+}
+
+// Returns `kinds_.size()` if the operator is not supported.
+uint32_t Writer::file_kind(Instruction const& inst)
+{
+    auto search = kind_index_.find(inst.kind_id());
+    if (search != kind_index_.end()) {
+        return search->second;
+    }
+    Codec const* codec = find_codec(inst.kind());
+    if (codec == nullptr) {
+        return kinds_.size();
+    }
+    kinds_.push_back(codec);
+    kind_index_.emplace(inst.kind_id(), kinds_.size() - 1);
+    return kinds_.size() - 1;
+}
+
+bool write(Circuit const& circuit, std::ostream& os)
+{
+    // Check upfront, so that we never write a valid-looking partial file.
+    bool supported = true;
+    circuit.foreach_instruction([&](Instruction const& inst) {
+        supported = supported && is_supported(inst.kind());
+    });
+    if (!supported) {
+        return false;
+    }
+    Writer writer(os);
+    circuit.foreach_qubit(
+      [&](std::string_view name) { writer.create_qubit(name); });
+    circuit.foreach_cbit(
+      [&](std::string_view name) { writer.create_cbit(name); });
+    writer.set_global_phase(circuit.global_phase());
+    circuit.foreach_instruction(
+      [&](Instruction const& inst) { writer.write_instruction(inst); });
+    return writer.finish();
+}
+
+bool write_file(Circuit const& circuit, std::string_view path)
+{
+    std::string const filename(path);
+    std::ofstream os(filename, std::ios::binary);
+    if (!os) {
+        return false;
+    }
+    if (!write(circuit, os)) {
+        os.close();
+        std::remove(filename.c_str());
+        return false;
+    }
+    return true;
+}
+
+// MappedCircuit
+std::optional<MappedCircuit> MappedCircuit::open(std::string_view path)
+{
+    MappedCircuit result;
+#if defined(TWEEDLEDUM_HAS_MMAP)
+    int const fd = ::open(std::string(path).c_str(), O_RDONLY);
+    if (fd < 0) {
+        return std::nullopt;
+    }
+    struct stat info;
+    if (::fstat(fd, &info) != 0 || info.st_size == 0) {
+        ::close(fd);
+        return std::nullopt;
+    }
+    void* mapping =
+      ::mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        return std::nullopt;
+    }
+    result.mapping_ = mapping;
+    result.data_ = static_cast<uint8_t const*>(mapping);
+    result.size_ = info.st_size;
+#else
+    std::ifstream is(std::string(path), std::ios::binary);
+    if (!is) {
+        return std::nullopt;
+    }
+    std::string const content(
+      (std::istreambuf_iterator<char>(is)), std::istreambuf_iterator<char>());
+    return from_buffer(content);
+#endif
+    if (!result.initialize()) {
+        return std::nullopt;
+    }
+    return result;
+}
+
+std::optional<MappedCircuit> MappedCircuit::from_buffer(std::string_view buffer)
+{
+    MappedCircuit result;
+    // Use 64-bit words, so that the parameters are properly aligned.
+    result.buffer_.resize((buffer.size() + 7u) / 8u);
+    std::memcpy(result.buffer_.data(), buffer.data(), buffer.size());
+    result.data_ = reinterpret_cast<uint8_t const*>(result.buffer_.data());
+    result.size_ = buffer.size();
+    if (!result.initialize()) {
+        return std::nullopt;
+    }
+    return result;
+}
+
+MappedCircuit::MappedCircuit(MappedCircuit&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+MappedCircuit& MappedCircuit::operator=(MappedCircuit&& other) noexcept
+{
+    if (this == &other) {
+        return *this;
+    }
+    release();
+    bool const owns_buffer = other.mapping_ == nullptr;
+    data_ = other.data_;
+    size_ = other.size_;
+    mapping_ = other.mapping_;
+    buffer_ = std::move(other.buffer_);
+    if (owns_buffer) {
+        // Moving a vector keeps its storage, but let's not rely on it.
+        data_ = reinterpret_cast<uint8_t const*>(buffer_.data());
+    }
+    num_instructions_ = other.num_instructions_;
+    num_qubits_ = other.num_qubits_;
+    num_cbits_ = other.num_cbits_;
+    global_phase_ = other.global_phase_;
+    offsets_ = other.offsets_;
+    names_ = other.names_;
+    kinds_ = std::move(other.kinds_);
+    other.data_ = nullptr;
+    other.size_ = 0u;
+    other.mapping_ = nullptr;
+    return *this;
+}
+
+MappedCircuit::~MappedCircuit()
+{
+    release();
+}
+
+void MappedCircuit::release()
+{
+#if defined(TWEEDLEDUM_HAS_MMAP)
+    if (mapping_ != nullptr) {
+        ::munmap(mapping_, size_);
+    }
+#endif
+    mapping_ = nullptr;
+    data_ = nullptr;
+    size_ = 0u;
+    buffer_.clear();
+}
+
+template<typename T>
+T MappedCircuit::read(uint64_t const position) const
+{
+    assert(position + sizeof(T) <= size_);
+    T value;
+    std::memcpy(&value, data_ + position, sizeof(T));
+    return value;
+}
+
+// Everything that is later read without checks is validated here: the tables,
+// and each record's bounds, kind, number of parameters and wires.  (Parameter
+// values and names are not checksummed.)
+bool MappedCircuit::initialize()
+{
+    if (size_ < sizeof(Header) + sizeof(Trailer)) {
+        return false;
+    }
+    Header const header = read<Header>(0u);
+    if (std::memcmp(header.magic, magic, sizeof(magic)) != 0
+        || header.byte_order != byte_order_mark || header.version != version) {
+        return false;
+    }
+    uint64_t const end = size_ - sizeof(Trailer);
+    Trailer const trailer = read<Trailer>(end);
+    if (std::memcmp(trailer.magic, magic, sizeof(magic)) != 0
+        || trailer.reserved != 0u) {
+        return false;
+    }
+    // Check each term on its own first, so that the sums cannot overflow.
+    uint64_t const num_wires = uint64_t(trailer.num_qubits) + trailer.num_cbits;
+    if (trailer.num_instructions > end / 8u || num_wires >= end / 8u
+        || trailer.offsets > end || trailer.kinds > end
+        || trailer.names > end) {
+        return false;
+    }
+    if (trailer.offsets % 8u != 0u || trailer.offsets < sizeof(Header)
+        || trailer.offsets + 8u * trailer.num_instructions > trailer.kinds
+        || trailer.kinds > trailer.names || trailer.names % 8u != 0u
+        || trailer.names + 8u * (num_wires + 1) > end) {
+        return false;
+    }
+    num_instructions_ = trailer.num_instructions;
+    num_qubits_ = trailer.num_qubits;
+    num_cbits_ = trailer.num_cbits;
+    global_phase_ = trailer.global_phase;
+    offsets_ = trailer.offsets;
+    names_ = trailer.names;
+
+    // Kinds are few, so we resolve them upfront.
+    uint64_t position = trailer.kinds;
+    for (uint32_t i = 0u; i < trailer.num_kinds; ++i) {
+        if (position + sizeof(uint32_t) > trailer.names) {
+            return false;
+        }
+        uint32_t const length = read<uint32_t>(position);
+        position += sizeof(uint32_t);
+        if (length > trailer.names - position) {
+            return false;
+        }
+        std::string_view const kind(
+          reinterpret_cast<char const*>(data_ + position), length);
+        position += length;
+        Codec const* codec = find_codec(kind);
+        if (codec == nullptr) {
+            return false;
+        }
+        kinds_.push_back(codec);
+    }
+
+    // Name offsets must start at 0 and never decrease.
+    uint64_t const chars = names_ + 8u * (num_wires + 1);
+    uint64_t previous = 0u;
+    for (uint64_t i = 0u; i <= num_wires; ++i) {
+        uint64_t const offset = read<uint64_t>(names_ + 8u * i);
+        if ((i == 0u && offset != 0u) || offset < previous
+            || offset > end - chars) {
+            return false;
+        }
+        previous = offset;
+    }
+
+    // Records must lie before the offsets table.  Wires must exist and be
+    // distinct within a record.
+    std::vector<uint32_t> last_use(num_wires, 0u);
+    for (uint32_t i = 0u; i < num_instructions_; ++i) {
+        uint64_t const begin = read<uint64_t>(offsets_ + 8u * i);
+        if (begin % 8u != 0u || begin < sizeof(Header)
+            || begin > offsets_ - sizeof(RecordHeader)) {
+            return false;
+        }
+        RecordHeader const record = read<RecordHeader>(begin);
+        if (record.kind >= kinds_.size() || record.reserved != 0u
+            || !kinds_[record.kind]->accepts(
+              record.num_qubits, record.num_parameters)) {
+            return false;
+        }
+        uint64_t const parameters = begin + align(wires_end(record));
+        if (parameters > offsets_
+            || record.num_parameters > (offsets_ - parameters) / 8u) {
+            return false;
+        }
+        uint64_t const wires = begin + sizeof(RecordHeader);
+        for (uint32_t j = 0u; j < record.num_qubits + record.num_cbits; ++j) {
+            uint32_t const data = read<uint32_t>(wires + 4u * j);
+            uint32_t uid = data & ~negative_wire;
+            if (j < record.num_qubits ? uid >= num_qubits_
+                                      : uid >= num_cbits_) {
+                return false;
+            }
+            uid += j < record.num_qubits ? 0u : num_qubits_;
+            if (last_use[uid] == i + 1) {
+                return false;
+            }
+            last_use[uid] = i + 1;
+        }
+    }
+    return true;
+}
+
+std::string_view MappedCircuit::name(Qubit const qubit) const
+{
+    assert(qubit.uid() < num_qubits_);
+    uint64_t const begin = read<uint64_t>(names_ + 8u * qubit.uid());
+    uint64_t const end = read<uint64_t>(names_ + 8u * (qubit.uid() + 1));
+    uint64_t const chars = names_ + 8u * (num_qubits_ + num_cbits_ + 1);
+    return {reinterpret_cast<char const*>(data_ + chars + begin), end - begin};
+}
+
+std::string_view MappedCircuit::name(Cbit const cbit) const
+{
+    assert(cbit.uid() < num_cbits_);
+    uint32_t const idx = num_qubits_ + cbit.uid();
+    uint64_t const begin = read<uint64_t>(names_ + 8u * idx);
+    uint64_t const end = read<uint64_t>(names_ + 8u * (idx + 1));
+    uint64_t const chars = names_ + 8u * (num_qubits_ + num_cbits_ + 1);
+    return {reinterpret_cast<char const*>(data_ + chars + begin), end - begin};
+}
+
+uint64_t MappedCircuit::record(InstRef const ref) const
+{
+    assert(ref < num_instructions_);
+    return read<uint64_t>(offsets_ + 8u * ref);
+}
+
+std::string_view MappedCircuit::kind(InstRef const ref) const
+{
+    return kinds_.at(read<RecordHeader>(record(ref)).kind)->kind;
+}
+
+uint32_t MappedCircuit::num_qubits(InstRef const ref) const
+{
+    return read<RecordHeader>(record(ref)).num_qubits;
+}
+
+uint32_t MappedCircuit::num_cbits(InstRef const ref) const
+{
+    return read<RecordHeader>(record(ref)).num_cbits;
+}
+
+Qubit MappedCircuit::qubit(InstRef const ref, uint32_t const idx) const
+{
+    assert(idx < num_qubits(ref));
+    uint64_t const position = record(ref) + sizeof(RecordHeader) + 4u * idx;
+    return decode_wire<Qubit>(read<uint32_t>(position));
+}
+
+Cbit MappedCircuit::cbit(InstRef const ref, uint32_t const idx) const
+{
+    assert(idx < num_cbits(ref));
+    uint64_t const position =
+      record(ref) + sizeof(RecordHeader) + 4u * (num_qubits(ref) + idx);
+    return decode_wire<Cbit>(read<uint32_t>(position));
+}
+
+Span<double const> MappedCircuit::parameters(InstRef const ref) const
+{
+    uint64_t const position = record(ref);
+    RecordHeader const header = read<RecordHeader>(position);
+    uint64_t const begin = position + align(wires_end(header));
+    assert(begin + sizeof(double) * header.num_parameters <= size_);
+    return {reinterpret_cast<double const*>(data_ + begin),
+      header.num_parameters};
+}
+
+Operator MappedCircuit::decode(InstRef const ref) const
+{
+    RecordHeader const header = read<RecordHeader>(record(ref));
+    return kinds_.at(header.kind)->decode(parameters(ref));
+}
+
+Instruction MappedCircuit::instruction(InstRef const ref) const
+{
+    SmallVector<Qubit, 4> qubits;
+    for (uint32_t i = 0u; i < num_qubits(ref); ++i) {
+        qubits.push_back(qubit(ref, i));
+    }
+    SmallVector<Cbit, 2> cbits;
+    for (uint32_t i = 0u; i < num_cbits(ref); ++i) {
+        cbits.push_back(cbit(ref, i));
+    }
+    return Instruction(
+      decode(ref), Span<Qubit const>(qubits), Span<Cbit const>(cbits));
+}
+
+Circuit MappedCircuit::load() const
+{
+    Circuit circuit;
+    for (uint32_t i = 0u; i < num_cbits_; ++i) {
+        circuit.create_cbit(name(Cbit(i)));
+    }
+    for (uint32_t i = 0u; i < num_qubits_; ++i) {
+        circuit.create_qubit(name(Qubit(i)));
+    }
+    circuit.global_phase() = global_phase_;
+    SmallVector<Qubit, 4> qubits;
+    SmallVector<Cbit, 2> cbits;
+    for (uint32_t i = 0u; i < num_instructions_; ++i) {
+        InstRef const ref(i);
+        qubits.clear();
+        for (uint32_t j = 0u; j < num_qubits(ref); ++j) {
+            qubits.push_back(qubit(ref, j));
+        }
+        cbits.clear();
+        for (uint32_t j = 0u; j < num_cbits(ref); ++j) {
+            cbits.push_back(cbit(ref, j));
+        }
+        circuit.apply_operator(
+          decode(ref), Span<Qubit const>(qubits), Span<Cbit const>(cbits));
+    }
+    return circuit;
+}
+
+std::optional<Circuit> read_file(std::string_view path)
+{
+    std::optional<MappedCircuit> mapped = MappedCircuit::open(path);
+    if (!mapped) {
+        return std::nullopt;
+    }
+    return mapped->load();
+}
+
+} // namespace tweedledum::binary
@@ -0,0 +1,81 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/Passes/Decomposition/subcircuit_decomp.h"
+
+#include "tweedledum/Operators/Extension/Subcircuit.h"
+#include "tweedledum/Passes/Utility/inverse.h"
+#include "tweedledum/Passes/Utility/shallow_duplicate.h"
+
+#include <cassert>
+#include <optional>
+#include <unordered_map>
+#include <utility>
+
+namespace tweedledum {
+
+namespace {
+class Inliner {
+public:
+    // Copies `inst` to `circuit`, inlining it if it is a subcircuit.
+    void apply(Circuit& circuit, Instruction const& inst)
+    {
+        if (!inst.is_a<Op::Subcircuit>()) {
+            circuit.apply_operator(inst);
+            return;
+        }
+        Op::Subcircuit const& subcircuit = inst.cast<Op::Subcircuit>();
+        Circuit const& body = subcircuit.is_adjoint()
+                            ? flat_adjoint(subcircuit.body())
+                            : flat(subcircuit.body());
+        circuit.append(body, inst.qubits(), inst.cbits());
+        circuit.global_phase() += body.global_phase();
+    }
+
+private:
+    Circuit const& flat(Circuit const& body)
+    {
+        auto it = flat_.find(&body);
+        if (it != flat_.end()) {
+            return it->second;
+        }
+        Circuit result = shallow_duplicate(body);
+        result.global_phase() = body.global_phase();
+        body.foreach_instruction(
+          [&](Instruction const& inst) { apply(result, inst); });
+        return flat_.emplace(&body, std::move(result)).first->second;
+    }
+
+    Circuit const& flat_adjoint(Circuit const& body)
+    {
+        auto it = flat_adjoint_.find(&body);
+        if (it != flat_adjoint_.end()) {
+            return it->second;
+        }
+        Circuit const& flat_body = flat(body);
+        // Subcircuits only have an adjoint if all operators of the body have
+        // one, and so does its flattened version.
+        std::optional<Circuit> result = inverse(flat_body);
+        assert(result);
+        result->global_phase() = -flat_body.global_phase();
+        return flat_adjoint_.emplace(&body, std::move(*result)).first->second;
+    }
+
+    // Bodies are shared, so we can key them by address.
+    std::unordered_map<Circuit const*, Circuit> flat_;
+    std::unordered_map<Circuit const*, Circuit> flat_adjoint_;
+};
+} // namespace
+
+Circuit subcircuit_decomp(Circuit const& original)
+{
+    Inliner inliner;
+    Circuit decomposed = shallow_duplicate(original);
+    decomposed.global_phase() = original.global_phase();
+    original.foreach_instruction(
+      [&](Instruction const& inst) { inliner.apply(decomposed, inst); });
+    return decomposed;
+}
+
+} // namespace tweedledum
@@ -8,12 +8,17 @@ namespace tweedledum {
 
 void SabreRePlacer::do_run()
 {
-    current_->foreach_output([&](InstRef const ref, Instruction const& inst) {
+    auto add_to_front = [&](InstRef const ref, Instruction const& inst) {
         visited_.at(ref) += 1;
         if (visited_.at(ref) == inst.num_wires()) {
             front_layer_.push_back(ref);
         }
-    });
+    };
+    if (forward_) {
+        original_.foreach_input(add_to_front);
+    } else {
+        original_.foreach_output(add_to_front);
+    }
 
     uint32_t num_swap_searches = 0u;
     while (!front_layer_.empty()) {
@@ -38,7 +43,7 @@ bool SabreRePlacer::add_front_layer()
     bool added_at_least_one = false;
     std::vector<InstRef> new_front_layer;
     for (InstRef ref : front_layer_) {
-        Instruction const& inst = current_->instruction(ref);
+        Instruction const& inst = original_.instruction(ref);
         if (add_instruction(inst) == false) {
             new_front_layer.push_back(ref);
             auto const qubits = inst.qubits();
@@ -47,13 +52,12 @@ bool SabreRePlacer::add_front_layer()
             continue;
         }
         added_at_least_one = true;
-        current_->foreach_child(
-          ref, [&](InstRef cref, Instruction const& child) {
-              visited_.at(cref) += 1;
-              if (visited_.at(cref) == child.num_wires()) {
-                  new_front_layer.push_back(cref);
-              }
-          });
+        foreach_next(ref, [&](InstRef nref, Instruction const& next) {
+            visited_.at(nref) += 1;
+            if (visited_.at(nref) == next.num_wires()) {
+                new_front_layer.push_back(nref);
+            }
+        });
     }
     front_layer_ = std::move(new_front_layer);
     return added_at_least_one;
@@ -67,17 +71,16 @@ void SabreRePlacer::select_extended_layer()
     while (!tmp_layer.empty()) {
         std::vector<InstRef> new_tmp_layer;
         for (InstRef const ref : tmp_layer) {
-            current_->foreach_child(
-              ref, [&](InstRef cref, Instruction const& child) {
-                  visited_.at(cref) += 1;
-                  incremented.push_back(cref);
-                  if (visited_.at(cref) == child.num_wires()) {
-                      new_tmp_layer.push_back(cref);
-                      if (child.num_qubits() == 2u) {
-                          extended_layer_.emplace_back(cref);
-                      }
-                  }
-              });
+            foreach_next(ref, [&](InstRef nref, Instruction const& next) {
+                visited_.at(nref) += 1;
+                incremented.push_back(nref);
+                if (visited_.at(nref) == next.num_wires()) {
+                    new_tmp_layer.push_back(nref);
+                    if (next.num_qubits() == 2u) {
+                        extended_layer_.emplace_back(nref);
+                    }
+                }
+            });
             if (extended_layer_.size() >= e_set_size_) {
                 goto undo_increment;
             }
@@ -168,7 +171,7 @@ double SabreRePlacer::compute_cost(
 {
     double cost = 0.0;
     for (InstRef ref : layer) {
-        Instruction const& inst = current_->instruction(ref);
+        Instruction const& inst = original_.instruction(ref);
         Qubit const v0 = inst.qubit(0);
         Qubit const v1 = inst.qubit(1);
         cost += (device_.distance(v_to_phy.at(v0), v_to_phy.at(v1)) - 1);
@@ -17,7 +17,7 @@ std::pair<Circuit, Mapping> JitRouter::run()
     }
     mapped_ = &mapped;
 
-    original_.foreach_output([&](InstRef const ref, Instruction const& inst) {
+    original_.foreach_input([&](InstRef const ref, Instruction const& inst) {
         visited_.at(ref) += 1;
         if (visited_.at(ref) == inst.num_wires()) {
             front_layer_.push_back(ref);
@@ -53,16 +53,17 @@ std::pair<Circuit, Mapping> JitRouter::run()
             add_delayed(v);
         }
     }
-    Circuit const result = reverse(mapped);
+    // Qubits are placed as they are needed, so we only know the full initial
+    // placement once we undo the swaps, starting from the final one.
     Mapping mapping(placement_);
-    result.foreach_instruction([&](Instruction const& inst) {
+    mapped.foreach_r_instruction([&](Instruction const& inst) {
         if (inst.is_one<Op::Swap>()) {
             Qubit const t0 = inst.target(0u);
             Qubit const t1 = inst.target(1u);
-            mapping.placement.swap_qubits(t0, t1);
+            mapping.init_placement.swap_qubits(t0, t1);
         }
     });
-    return {result, mapping};
+    return {mapped, mapping};
 }
 
 bool JitRouter::add_front_layer()
@@ -79,11 +80,11 @@ bool JitRouter::add_front_layer()
             continue;
         }
         added_at_least_one = true;
-        original_.foreach_child(
-          ref, [&](InstRef cref, Instruction const& child) {
-              visited_.at(cref) += 1;
-              if (visited_.at(cref) == child.num_wires()) {
-                  new_front_layer.push_back(cref);
+        original_.foreach_successor(
+          ref, [&](InstRef sref, Instruction const& successor) {
+              visited_.at(sref) += 1;
+              if (visited_.at(sref) == successor.num_wires()) {
+                  new_front_layer.push_back(sref);
               }
           });
     }
@@ -99,14 +100,14 @@ void JitRouter::select_extended_layer()
     while (!tmp_layer.empty()) {
         std::vector<InstRef> new_tmp_layer;
         for (InstRef const ref : tmp_layer) {
-            original_.foreach_child(
-              ref, [&](InstRef cref, Instruction const& child) {
-                  visited_.at(cref) += 1;
-                  incremented.push_back(cref);
-                  if (visited_.at(cref) == child.num_wires()) {
-                      new_tmp_layer.push_back(cref);
-                      if (child.num_qubits() == 2u) {
-                          extended_layer_.emplace_back(cref);
+            original_.foreach_successor(
+              ref, [&](InstRef sref, Instruction const& successor) {
+                  visited_.at(sref) += 1;
+                  incremented.push_back(sref);
+                  if (visited_.at(sref) == successor.num_wires()) {
+                      new_tmp_layer.push_back(sref);
+                      if (successor.num_qubits() == 2u) {
+                          extended_layer_.emplace_back(sref);
                       }
                   }
               });
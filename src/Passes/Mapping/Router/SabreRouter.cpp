@@ -17,7 +17,7 @@ std::pair<Circuit, Mapping> SabreRouter::run()
     }
     mapped_ = &mapped;
 
-    original_.foreach_output([&](InstRef const ref, Instruction const& inst) {
+    original_.foreach_input([&](InstRef const ref, Instruction const& inst) {
         visited_.at(ref) += 1;
         if (visited_.at(ref) == inst.num_wires()) {
             front_layer_.push_back(ref);
@@ -40,8 +40,7 @@ std::pair<Circuit, Mapping> SabreRouter::run()
         add_swap(phy0, phy1);
         std::fill(involved_phy_.begin(), involved_phy_.end(), 0);
     }
-    std::swap(mapping_.init_placement, mapping_.placement);
-    return {reverse(mapped), mapping_};
+    return {mapped, mapping_};
 }
 
 bool SabreRouter::add_front_layer()
@@ -58,11 +57,11 @@ bool SabreRouter::add_front_layer()
             continue;
         }
         added_at_least_one = true;
-        original_.foreach_child(
-          ref, [&](InstRef cref, Instruction const& child) {
-              visited_.at(cref) += 1;
-              if (visited_.at(cref) == child.num_wires()) {
-                  new_front_layer.push_back(cref);
+        original_.foreach_successor(
+          ref, [&](InstRef sref, Instruction const& successor) {
+              visited_.at(sref) += 1;
+              if (visited_.at(sref) == successor.num_wires()) {
+                  new_front_layer.push_back(sref);
               }
           });
     }
@@ -78,14 +77,14 @@ void SabreRouter::select_extended_layer()
     while (!tmp_layer.empty()) {
         std::vector<InstRef> new_tmp_layer;
         for (InstRef const ref : tmp_layer) {
-            original_.foreach_child(
-              ref, [&](InstRef cref, Instruction const& child) {
-                  visited_.at(cref) += 1;
-                  incremented.push_back(cref);
-                  if (visited_.at(cref) == child.num_wires()) {
-                      new_tmp_layer.push_back(cref);
-                      if (child.num_qubits() == 2u) {
-                          extended_layer_.emplace_back(cref);
+            original_.foreach_successor(
+              ref, [&](InstRef sref, Instruction const& successor) {
+                  visited_.at(sref) += 1;
+                  incremented.push_back(sref);
+                  if (visited_.at(sref) == successor.num_wires()) {
+                      new_tmp_layer.push_back(sref);
+                      if (successor.num_qubits() == 2u) {
+                          extended_layer_.emplace_back(sref);
                       }
                   }
               });
@@ -0,0 +1,438 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/Passes/Optimization/commutative_cancellation.h"
+#include "tweedledum/Operators/Ising.h"
+#include "tweedledum/Operators/Standard.h"
+#include "tweedledum/Passes/Analysis/compute_commutation_dag.h"
+#include "tweedledum/Passes/Utility/shallow_duplicate.h"
+#include "tweedledum/Utils/Numbers.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace tweedledum {
+namespace {
+
+// Instructions that are powers of T (in units of π/4, modulo 8), or of √X
+// (in units of π/2, modulo 4).
+enum class Family : uint8_t {
+    none,
+    t_power,
+    sx_power,
+};
+
+struct Power {
+    Family family;
+    uint32_t exponent;
+};
+
+Power power_of(Operator const& optor)
+{
+    if (optor.is_a<Op::T>()) {
+        return {Family::t_power, 1u};
+    } else if (optor.is_a<Op::S>()) {
+        return {Family::t_power, 2u};
+    } else if (optor.is_a<Op::Z>()) {
+        return {Family::t_power, 4u};
+    } else if (optor.is_a<Op::Sdg>()) {
+        return {Family::t_power, 6u};
+    } else if (optor.is_a<Op::Tdg>()) {
+        return {Family::t_power, 7u};
+    } else if (optor.is_a<Op::Sx>()) {
+        return {Family::sx_power, 1u};
+    } else if (optor.is_a<Op::X>()) {
+        return {Family::sx_power, 2u};
+    } else if (optor.is_a<Op::Sxdg>()) {
+        return {Family::sx_power, 3u};
+    }
+    return {Family::none, 0u};
+}
+
+// Returns the operator `family^exponent` if it is a single gate.
+std::optional<Operator> make_power(Family const family, uint32_t const exponent)
+{
+    if (family == Family::t_power) {
+        switch (exponent % 8u) {
+        case 1u:
+            return Op::T();
+        case 2u:
+            return Op::S();
+        case 4u:
+            return Op::Z();
+        case 6u:
+            return Op::Sdg();
+        case 7u:
+            return Op::Tdg();
+        default:
+            return std::nullopt;
+        }
+    }
+    switch (exponent % 4u) {
+    case 1u:
+        return Op::Sx();
+    case 2u:
+        return Op::X();
+    case 3u:
+        return Op::Sxdg();
+    default:
+        return std::nullopt;
+    }
+}
+
+// Rotation with angle `angle` of the same kind of `optor`.  Note that P is
+// 2π-periodic, while the other rotations are 4π-periodic.
+std::optional<Operator> make_rotation(Operator const& optor, double const angle)
+{
+    if (optor.is_a<Op::Rx>()) {
+        return Op::Rx(angle);
+    } else if (optor.is_a<Op::Ry>()) {
+        return Op::Ry(angle);
+    } else if (optor.is_a<Op::Rz>()) {
+        return Op::Rz(angle);
+    } else if (optor.is_a<Op::P>()) {
+        return Op::P(angle);
+    } else if (optor.is_a<Op::Rxx>()) {
+        return Op::Rxx(angle);
+    } else if (optor.is_a<Op::Ryy>()) {
+        return Op::Ryy(angle);
+    } else if (optor.is_a<Op::Rzz>()) {
+        return Op::Rzz(angle);
+    }
+    return std::nullopt;
+}
+
+bool is_identity_rotation(Operator const& optor, double const angle)
+{
+    constexpr double atol = 1e-12;
+    double const period = optor.is_a<Op::P>() ? 2 * numbers::pi
+                                              : 4 * numbers::pi;
+    double const remainder = std::abs(std::remainder(angle, period));
+    return remainder < atol;
+}
+
+bool same_qubits(Instruction const& a, Instruction const& b)
+{
+    if (a.num_qubits() != b.num_qubits()
+        || a.num_controls() != b.num_controls()) {
+        return false;
+    }
+    for (uint32_t i = 0u; i < a.num_qubits(); ++i) {
+        if (a.qubit(i) != b.qubit(i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Cancels and merges instructions in a single pass, in program order.
+//
+// Each wire keeps a stack of the commutation groups (see `CommutationDag`) of
+// the instructions kept so far.  An instruction can be brought next to any
+// instruction that is in the top group on all of its wires.  When a pair
+// cancels, the groups of the earlier instruction might become empty, and are
+// popped: the instructions around the pair can then be matched in turn, e.g.
+// the outer pair of H·Y·Y·H.  Hence nested pairs are all removed in one pass.
+class Cancellation {
+public:
+    Cancellation(Circuit const& circuit)
+        : circuit_(circuit)
+        , top_(circuit.num_qubits() + circuit.num_cbits(), no_group)
+        , offset_(circuit.num_refs(), 0u)
+        , removed_(circuit.num_refs(), 0u)
+    {}
+
+    void run()
+    {
+        circuit_.foreach_instruction([&](InstRef ref, Instruction const& inst) {
+            if (inst.num_cbits() == 0u && match(ref, inst)) {
+                return;
+            }
+            push(ref, inst);
+        });
+    }
+
+    Circuit rebuild() const
+    {
+        Circuit result = shallow_duplicate(circuit_);
+        result.global_phase() = circuit_.global_phase();
+        circuit_.foreach_instruction([&](InstRef ref, Instruction const& inst) {
+            if (removed_.at(ref)) {
+                return;
+            }
+            auto search = replacement_.find(ref);
+            if (search == replacement_.end()) {
+                result.apply_operator(inst);
+                return;
+            }
+            result.apply_operator(search->second, inst.qubits(), inst.cbits());
+        });
+        return result;
+    }
+
+private:
+    static constexpr uint32_t no_group = CommutationDag::no_group;
+
+    enum class Match {
+        none,
+        cancel,
+        merge,
+    };
+
+    struct Group {
+        uint32_t wire;
+        uint32_t previous;
+        WireAction action;
+        uint32_t num_members;
+    };
+
+    Instruction const& instruction(InstRef const ref) const
+    {
+        return circuit_.instruction(ref);
+    }
+
+    Operator const& operator_of(InstRef const ref) const
+    {
+        auto search = replacement_.find(ref);
+        if (search != replacement_.end()) {
+            return search->second;
+        }
+        return instruction(ref);
+    }
+
+    // Instructions that can be merged share a bucket: powers of the same
+    // family, whatever their kind, and otherwise operators of the same kind.
+    static uint32_t kind_key(Operator const& optor)
+    {
+        Power const power = power_of(optor);
+        if (power.family == Family::none) {
+            return optor.kind_id();
+        }
+        return ~static_cast<uint32_t>(power.family);
+    }
+
+    static std::string key(Span<uint32_t const> groups, uint32_t kind)
+    {
+        std::string result;
+        auto append = [&](uint32_t const value) {
+            result.append(reinterpret_cast<char const*>(&value), sizeof(value));
+        };
+        for (uint32_t const group : groups) {
+            append(group);
+        }
+        append(kind);
+        return result;
+    }
+
+    // Looks for an instruction in the top groups of the qubits of `inst` with
+    // which it cancels or merges.  Returns false if there is none.
+    bool match(InstRef const ref, Instruction const& inst)
+    {
+        std::vector<uint32_t> groups;
+        groups.reserve(inst.num_qubits());
+        inst.foreach_qubit(
+          [&](Qubit const qubit) { groups.push_back(top_.at(qubit.uid())); });
+        if (std::find(groups.begin(), groups.end(), no_group) != groups.end()) {
+            return false;
+        }
+        Span<uint32_t const> const span(groups.data(), groups.size());
+        uint32_t const kind = kind_key(inst);
+        if (match_in(key(span, kind), ref, inst)) {
+            return true;
+        }
+        // The adjoint might be of another kind, e.g. a custom operator
+        std::optional<Operator> const adjoint = inst.adjoint();
+        return adjoint && kind_key(*adjoint) != kind
+            && match_in(key(span, kind_key(*adjoint)), ref, inst);
+    }
+
+    bool match_in(std::string const& bucket_key, InstRef const ref,
+      Instruction const& inst)
+    {
+        auto search = buckets_.find(bucket_key);
+        if (search == buckets_.end()) {
+            return false;
+        }
+        std::vector<InstRef>& bucket = search->second;
+        for (InstRef const other : bucket) {
+            if (!same_qubits(inst, instruction(other))) {
+                continue;
+            }
+            Match const match = try_match(other, inst);
+            if (match == Match::none) {
+                continue;
+            }
+            removed_.at(ref) = 1u;
+            if (match == Match::cancel) {
+                remove(bucket, other);
+            } else {
+                absorb(bucket, other);
+            }
+            return true;
+        }
+        return false;
+    }
+
+    // A merge changes the operator of `merged`, which might then combine with
+    // another instruction of its bucket, e.g. T·S·Sdg → Tdg·S → T.
+    void absorb(std::vector<InstRef>& bucket, InstRef merged)
+    {
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (InstRef const other : bucket) {
+                if (other == merged
+                    || !same_qubits(instruction(merged), instruction(other))) {
+                    continue;
+                }
+                Operator const optor = operator_of(merged);
+                Match const match = try_match(other, optor);
+                if (match == Match::none) {
+                    continue;
+                }
+                remove(bucket, merged);
+                if (match == Match::cancel) {
+                    remove(bucket, other);
+                    return;
+                }
+                merged = other;
+                changed = true;
+                break;
+            }
+        }
+    }
+
+    // Removes an instruction from its bucket and from the top groups of its
+    // wires, and pops the groups that become empty.
+    void remove(std::vector<InstRef>& bucket, InstRef const ref)
+    {
+        bucket.erase(std::find(bucket.begin(), bucket.end(), ref));
+        removed_.at(ref) = 1u;
+        replacement_.erase(ref);
+        uint32_t const begin = offset_.at(ref);
+        uint32_t const end = begin + instruction(ref).num_wires();
+        for (uint32_t i = begin; i < end; ++i) {
+            Group& group = groups_.at(inst_groups_.at(i));
+            assert(top_.at(group.wire) == inst_groups_.at(i));
+            group.num_members -= 1;
+            if (group.num_members == 0u) {
+                top_.at(group.wire) = group.previous;
+            }
+        }
+    }
+
+    void push(InstRef const ref, Instruction const& inst)
+    {
+        offset_.at(ref) = inst_groups_.size();
+        uint32_t i = 0u;
+        inst.foreach_qubit([&](Qubit const qubit) {
+            inst_groups_.push_back(
+              join(qubit.uid(), cache_.qubit_action(inst, i)));
+            ++i;
+        });
+        inst.foreach_cbit([&](Cbit const cbit) {
+            inst_groups_.push_back(
+              join(circuit_.num_qubits() + cbit.uid(), WireAction::other));
+        });
+        if (inst.num_cbits() == 0u) {
+            Span<uint32_t const> const groups(
+              inst_groups_.data() + offset_.at(ref), inst.num_qubits());
+            buckets_[key(groups, kind_key(inst))].push_back(ref);
+        }
+    }
+
+    // Same grouping as `CommutationDag`
+    uint32_t join(uint32_t const wire, WireAction const action)
+    {
+        uint32_t const top = top_.at(wire);
+        if (top != no_group && action != WireAction::other
+            && groups_.at(top).action == action) {
+            groups_.at(top).num_members += 1;
+            return top;
+        }
+        uint32_t const group = groups_.size();
+        groups_.push_back({wire, top, action, 1u});
+        top_.at(wire) = group;
+        return group;
+    }
+
+    // Tries to combine the (earlier) operator of `other` with `inst`, which
+    // act on the same qubits and can be brought next to each other.  On a
+    // merge, the new operator replaces the one of `other`.
+    Match try_match(InstRef const other, Operator const& inst)
+    {
+        Operator const& optor = operator_of(other);
+        std::optional<Operator> const adjoint = inst.adjoint();
+        if (adjoint && optor == *adjoint) {
+            return Match::cancel;
+        }
+        Power const power0 = power_of(optor);
+        Power const power1 = power_of(inst);
+        if (power0.family != Family::none && power0.family == power1.family) {
+            uint32_t const exponent = power0.exponent + power1.exponent;
+            uint32_t const period = power0.family == Family::t_power ? 8u : 4u;
+            if (exponent % period == 0u) {
+                return Match::cancel;
+            }
+            std::optional<Operator> merged =
+              make_power(power0.family, exponent);
+            if (!merged) {
+                return Match::none;
+            }
+            return replace(other, std::move(*merged));
+        }
+        if (optor.kind_id() != inst.kind_id()) {
+            return Match::none;
+        }
+        std::optional<double> const angle0 = optor.angle();
+        std::optional<double> const angle1 = inst.angle();
+        if (!angle0 || !angle1) {
+            return Match::none;
+        }
+        double const angle = *angle0 + *angle1;
+        if (is_identity_rotation(optor, angle)) {
+            return Match::cancel;
+        }
+        std::optional<Operator> merged = make_rotation(optor, angle);
+        if (!merged) {
+            return Match::none;
+        }
+        return replace(other, std::move(*merged));
+    }
+
+    Match replace(InstRef const ref, Operator&& optor)
+    {
+        replacement_.insert_or_assign(ref, std::move(optor));
+        return Match::merge;
+    }
+
+    Circuit const& circuit_;
+    WireActionCache cache_;
+    // Groups, and the top group on each wire
+    std::vector<Group> groups_;
+    std::vector<uint32_t> top_;
+    // Groups of the kept instructions, one per wire, from `offset_[ref]`
+    std::vector<uint32_t> offset_;
+    std::vector<uint32_t> inst_groups_;
+    std::vector<uint8_t> removed_;
+    std::unordered_map<uint32_t, Operator> replacement_;
+    // Kept instructions (without cbits) by groups and kind
+    std::unordered_map<std::string, std::vector<InstRef>> buckets_;
+};
+
+} // namespace
+
+Circuit commutative_cancellation(Circuit const& original)
+{
+    Cancellation cancellation(original);
+    cancellation.run();
+    return cancellation.rebuild();
+}
+
+} // namespace tweedledum
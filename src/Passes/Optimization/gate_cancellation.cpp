@@ -3,47 +3,89 @@
 | See accompanying file /LICENSE for details.
 *-----------------------------------------------------------------------------*/
 #include "tweedledum/Passes/Optimization/gate_cancellation.h"
+#include "tweedledum/IR/InstructionTable.h"
 #include "tweedledum/Passes/Utility/shallow_duplicate.h"
 
 #include <vector>
 
 namespace tweedledum {
+namespace {
+
+// The cancellation only needs to know the wires of an instruction and their
+// children.  When the circuit has columnar storage we read them from there and
+// only touch the instruction (its operator) when checking for adjointness.
+template<typename Fn>
+void foreach_qubit(Circuit const& circuit, InstRef ref, Fn&& fn)
+{
+    if (circuit.has_columns()) {
+        InstructionColumns const& columns = circuit.columns();
+        Span<Qubit const> qubits = columns.qubits(ref);
+        Span<InstRef const> children = columns.qubits_children(ref);
+        for (uint32_t i = 0u; i < qubits.size(); ++i) {
+            fn(qubits[i], children[i]);
+        }
+        return;
+    }
+    circuit.instruction(ref).foreach_qubit(fn);
+}
+
+template<typename Fn>
+void foreach_cbit(Circuit const& circuit, InstRef ref, Fn&& fn)
+{
+    if (circuit.has_columns()) {
+        InstructionColumns const& columns = circuit.columns();
+        Span<Cbit const> cbits = columns.cbits(ref);
+        Span<InstRef const> children = columns.cbits_children(ref);
+        for (uint32_t i = 0u; i < cbits.size(); ++i) {
+            fn(cbits[i], children[i]);
+        }
+        return;
+    }
+    circuit.instruction(ref).foreach_cbit(fn);
+}
+
+} // namespace
 
 Circuit gate_cancellation(Circuit const& original)
 {
-    std::vector<uint32_t> to_remove(original.num_instructions(), 0u);
+    InstructionTable<uint8_t> to_remove(original.num_refs(), 0u);
     std::vector<InstRef> qubit_last(original.num_qubits(), InstRef::invalid());
     std::vector<InstRef> cbit_last(original.num_cbits(), InstRef::invalid());
-    original.foreach_instruction([&](InstRef ref, Instruction const& inst) {
+    auto update_last = [&](InstRef ref) {
+        foreach_qubit(original, ref,
+          [&](Qubit const qubit, InstRef) { qubit_last.at(qubit) = ref; });
+        foreach_cbit(original, ref,
+          [&](Cbit const cbit, InstRef) { cbit_last.at(cbit) = ref; });
+    };
+    original.foreach_instruction([&](InstRef ref) {
         // Check children
-        InstRef temp = qubit_last.at(inst.qubit(0u));
-        bool all_equal = false;
-        inst.foreach_qubit([&](Qubit const qubit) {
-            all_equal = (temp == qubit_last.at(qubit));
+        InstRef temp = InstRef::invalid();
+        bool all_equal = true;
+        foreach_qubit(original, ref, [&](Qubit const qubit, InstRef) {
+            if (temp == InstRef::invalid()) {
+                temp = qubit_last.at(qubit);
+            }
+            all_equal &= (temp == qubit_last.at(qubit));
+        });
+        foreach_cbit(original, ref, [&](Cbit const cbit, InstRef) {
+            all_equal &= (temp == cbit_last.at(cbit));
         });
-        inst.foreach_cbit(
-          [&](Cbit const cbit) { all_equal = (temp == cbit_last.at(cbit)); });
         if (!all_equal || temp == InstRef::invalid()) {
-            inst.foreach_qubit(
-              [&](Qubit const qubit) { qubit_last.at(qubit) = ref; });
-            inst.foreach_cbit(
-              [&](Cbit const cbit) { cbit_last.at(cbit) = ref; });
+            update_last(ref);
             return;
         }
+        Instruction const& inst = original.instruction(ref);
         Instruction const& other = original.instruction(temp);
         if (!inst.is_adjoint(other)) {
-            inst.foreach_qubit(
-              [&](Qubit const qubit) { qubit_last.at(qubit) = ref; });
-            inst.foreach_cbit(
-              [&](Cbit const cbit) { cbit_last.at(cbit) = ref; });
+            update_last(ref);
             return;
         }
         to_remove.at(temp) = 1u;
         to_remove.at(ref) = 1u;
-        other.foreach_qubit([&](Qubit const qubit, InstRef child) {
+        foreach_qubit(original, temp, [&](Qubit const qubit, InstRef child) {
             qubit_last.at(qubit) = child;
         });
-        other.foreach_cbit(
+        foreach_cbit(original, temp,
           [&](Cbit const cbit, InstRef child) { cbit_last.at(cbit) = child; });
     });
 
@@ -4,6 +4,7 @@
 *-----------------------------------------------------------------------------*/
 #include "tweedledum/Passes/Optimization/linear_resynth.h"
 
+#include "tweedledum/IR/InstructionTable.h"
 #include "tweedledum/Operators/Extension/Parity.h"
 #include "tweedledum/Operators/Standard/X.h"
 #include "tweedledum/Passes/Utility/shallow_duplicate.h"
@@ -19,7 +20,7 @@ struct Slice {
 
 inline std::vector<Slice> partition_into_silces(Circuit const& original)
 {
-    std::vector<uint32_t> to_slice(original.num_instructions(), 0);
+    InstructionTable<uint32_t> to_slice(original.num_refs(), 0u);
     std::vector<Slice> slices;
     original.foreach_instruction([&](InstRef ref, Instruction const& inst) {
         uint32_t max = 0;
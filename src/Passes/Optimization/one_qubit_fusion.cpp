@@ -0,0 +1,106 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/Passes/Optimization/one_qubit_fusion.h"
+#include "tweedledum/Decomposition/OneQubitDecomposer.h"
+#include "tweedledum/Operators/Extension/Unitary.h"
+#include "tweedledum/Passes/Utility/shallow_duplicate.h"
+#include "tweedledum/Utils/Matrix.h"
+
+#include <cmath>
+#include <vector>
+
+namespace tweedledum {
+namespace {
+
+struct Run {
+    std::vector<InstRef> instructions;
+    UMatrix2 matrix = UMatrix2::Identity();
+};
+
+class OneQubitFusion {
+public:
+    OneQubitFusion(Circuit const& original, nlohmann::json const& config)
+        : original_(original)
+        , decomposer_(config)
+        , runs_(original.num_qubits())
+    {}
+
+    Circuit run()
+    {
+        Circuit optimized = shallow_duplicate(original_);
+        optimized.global_phase() = original_.global_phase();
+        original_.foreach_instruction([&](InstRef ref,
+                                        Instruction const& inst) {
+            if (inst.num_qubits() == 1u && inst.num_cbits() == 0u) {
+                std::optional<UMatrix> const matrix = inst.matrix();
+                if (matrix) {
+                    Run& run = runs_.at(inst.target());
+                    run.instructions.push_back(ref);
+                    run.matrix = *matrix * run.matrix;
+                    return;
+                }
+            }
+            inst.foreach_qubit(
+              [&](Qubit qubit) { flush(optimized, qubit.uid()); });
+            optimized.apply_operator(inst);
+        });
+        optimized.foreach_qubit([&](Qubit qubit) { flush(optimized, qubit); });
+        return optimized;
+    }
+
+private:
+    void flush(Circuit& optimized, Qubit const qubit)
+    {
+        Run& run = runs_.at(qubit);
+        if (run.instructions.empty()) {
+            return;
+        }
+        double const atol = decomposer_.config.atol;
+        UMatrix2 const& matrix = run.matrix;
+        if (std::abs(matrix(0, 1)) < atol && std::abs(matrix(1, 0)) < atol
+            && std::abs(matrix(0, 0) - matrix(1, 1)) < atol) {
+            optimized.global_phase() += std::arg(matrix(0, 0));
+        } else if (!emit_decomposition(optimized, qubit, matrix,
+                     run.instructions.size())) {
+            for (InstRef const ref : run.instructions) {
+                optimized.apply_operator(original_.instruction(ref));
+            }
+        }
+        run.instructions.clear();
+        run.matrix = UMatrix2::Identity();
+    }
+
+    // Returns whether the decomposition was emitted, i.e. whether it has less
+    // than `max_size` instructions.
+    bool emit_decomposition(Circuit& optimized, Qubit const qubit,
+      UMatrix2 const& matrix, uint32_t const max_size)
+    {
+        Circuit decomposed;
+        Qubit const q0 = decomposed.create_qubit();
+        Instruction const inst(
+          Op::Unitary(matrix), Span<Qubit const>(&q0, 1u), {});
+        if (!decomposer_.decompose(decomposed, inst)
+            || decomposed.num_instructions() >= max_size) {
+            return false;
+        }
+        optimized.append(decomposed, {qubit}, {});
+        optimized.global_phase() += decomposed.global_phase();
+        return true;
+    }
+
+    Circuit const& original_;
+    OneQubitDecomposer decomposer_;
+    std::vector<Run> runs_;
+};
+
+} // namespace
+
+Circuit one_qubit_fusion(Circuit const& original, nlohmann::json const& config)
+{
+    OneQubitFusion fusion(original, config);
+    return fusion.run();
+}
+
+} // namespace tweedledum
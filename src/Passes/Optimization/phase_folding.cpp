@@ -5,118 +5,243 @@
 #include "tweedledum/Passes/Optimization/phase_folding.h"
 #include "tweedledum/Operators/All.h"
 #include "tweedledum/Operators/Utils.h"
-#include "tweedledum/Utils/LinPhasePoly.h"
+#include "tweedledum/Utils/Hash.h"
+
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+#include <vector>
 
 namespace tweedledum {
+namespace {
 
-Circuit phase_folding(Circuit const& original)
-{
-    using ESOP = std::vector<uint32_t>;
-    Circuit optimized;
-    uint32_t num_path_vars = 1u;
-    std::vector<ESOP> qubit_pathsum;
-    std::vector<uint8_t> skipped(original.num_instructions(), 0);
-
-    original.foreach_cbit(
-      [&](std::string_view name) { optimized.create_cbit(name); });
-    original.foreach_qubit([&](std::string_view name) {
-        optimized.create_qubit(name);
-        qubit_pathsum.emplace_back(1u, (num_path_vars++ << 1));
-    });
-
-    LinPhasePoly phase_parities;
-    original.foreach_instruction([&](InstRef ref, Instruction const& inst) {
-        uint32_t const t = inst.target(0u);
-        std::optional<double> const angle = rotation_angle(inst);
-        if (inst.num_cbits() || (inst.num_qubits() > 2)) {
-            goto new_vars_end;
+// Parity (XOR) of path variables, as a packed bitset.  A dense bitset would
+// need one bit per path variable of the whole circuit, so only the words
+// between the first and the last nonzero words are stored.
+class Parity {
+public:
+    static Parity variable(uint32_t const var)
+    {
+        Parity parity;
+        parity.offset_ = var / 64u;
+        parity.words_.push_back(uint64_t(1) << (var % 64u));
+        return parity;
+    }
+
+    bool operator==(Parity const& other) const
+    {
+        return offset_ == other.offset_ && words_ == other.words_;
+    }
+
+    Parity& operator^=(Parity const& other)
+    {
+        if (other.words_.empty()) {
+            return *this;
         }
-        if (inst.num_targets() == 2) {
-            if (inst.is_one<Op::Swap>()) {
-                uint32_t const t1 = inst.target(1u);
-                std::swap(qubit_pathsum.at(t), qubit_pathsum.at(t1));
-                return;
-            }
-            goto new_vars_end;
+        if (words_.empty()) {
+            return *this = other;
         }
-        if (inst.is_one<Op::X>()) {
-            if (inst.num_controls() == 0) {
-                if (qubit_pathsum.at(t).at(0) == 1u) {
-                    qubit_pathsum.at(t).erase(qubit_pathsum.at(t).begin());
-                    return;
-                }
-                qubit_pathsum.at(t).insert(qubit_pathsum.at(t).begin(), 1u);
-                return;
-            }
-            uint32_t c = inst.control();
-            std::vector<uint32_t> esop;
-            std::set_symmetric_difference(qubit_pathsum.at(c).begin(),
-              qubit_pathsum.at(c).end(), qubit_pathsum.at(t).begin(),
-              qubit_pathsum.at(t).end(), std::back_inserter(esop));
-            qubit_pathsum.at(t) = esop;
-            return;
+        uint32_t const begin = std::min(offset_, other.offset_);
+        uint32_t const end = std::max(this->end(), other.end());
+        if (begin < offset_ || end > this->end()) {
+            std::vector<uint64_t> words(end - begin, 0u);
+            std::copy(words_.begin(), words_.end(),
+              words.begin() + (offset_ - begin));
+            words_ = std::move(words);
+            offset_ = begin;
         }
-        if (angle) {
-            phase_parities.add_term(qubit_pathsum.at(t), angle.value());
+        uint64_t* words = words_.data() + (other.offset_ - offset_);
+        for (uint64_t const word : other.words_) {
+            *words++ ^= word;
         }
-        return;
-
-    new_vars_end:
-        skipped.at(ref) = 1u;
-        inst.foreach_target([&](Qubit wref) {
-            uint32_t const qubit = wref;
-            qubit_pathsum.at(qubit).clear();
-            qubit_pathsum.at(qubit).emplace_back((num_path_vars++ << 1));
-        });
-    });
+        trim();
+        return *this;
+    }
+
+    uint64_t hash() const
+    {
+        uint64_t seed = offset_;
+        for (uint64_t const word : words_) {
+            hash_combine(seed, word);
+        }
+        return seed;
+    }
 
-    num_path_vars = 1u;
-    for (uint32_t i = 0; i < original.num_qubits(); ++i) {
-        qubit_pathsum.at(i) = {(num_path_vars++ << 1)};
+private:
+    uint32_t end() const
+    {
+        return offset_ + words_.size();
     }
 
-    original.foreach_instruction([&](InstRef ref, Instruction const& inst) {
-        if (skipped.at(ref)) {
-            inst.foreach_target([&](Qubit wref) {
-                uint32_t const qubit = wref;
-                qubit_pathsum.at(qubit).clear();
-                qubit_pathsum.at(qubit).emplace_back((num_path_vars++ << 1));
-            });
-            optimized.apply_operator(inst);
+    void trim()
+    {
+        while (!words_.empty() && words_.back() == 0u) {
+            words_.pop_back();
         }
-        // Rotations
-        if (inst.is_one<Op::P, Op::S, Op::Sdg, Op::T, Op::Tdg, Op::Z>()) {
-            return;
+        auto it = std::find_if(
+          words_.begin(), words_.end(), [](uint64_t word) { return word; });
+        offset_ += std::distance(words_.begin(), it);
+        words_.erase(words_.begin(), it);
+        if (words_.empty()) {
+            offset_ = 0u;
         }
+    }
 
-        uint32_t const t = inst.target();
-        if (inst.is_one<Op::Swap>()) {
-            uint32_t const t1 = inst.target(1u);
-            std::swap(qubit_pathsum.at(t), qubit_pathsum.at(t1));
-        }
-        if (inst.is_one<Op::X>()) {
-            if (inst.num_controls() == 0) {
-                if (qubit_pathsum.at(t).at(0) == 1u) {
-                    qubit_pathsum.at(t).erase(qubit_pathsum.at(t).begin());
-                }
-                qubit_pathsum.at(t).insert(qubit_pathsum.at(t).begin(), 1u);
+    uint32_t offset_ = 0u;
+    std::vector<uint64_t> words_;
+};
+
+struct ParityHash {
+    std::size_t operator()(Parity const& parity) const
+    {
+        return parity.hash();
+    }
+};
+
+// The value of a qubit: a parity, possibly negated.
+struct PathSum {
+    Parity parity;
+    bool negated = false;
+};
+
+// Diagonal single-qubit operators, up to global phase, as P(angle) gates.
+std::optional<double> phase_angle(Instruction const& inst)
+{
+    if (inst.num_qubits() != 1u
+        || !inst.is_one<Op::P, Op::S, Op::Sdg, Op::T, Op::Tdg, Op::Z,
+          Op::Rz>()) {
+        return std::nullopt;
+    }
+    return rotation_angle(inst);
+}
+
+class PhaseFolder {
+public:
+    PhaseFolder(Circuit const& original)
+        : original_(original)
+    {}
+
+    Circuit run()
+    {
+        // Accumulate the phases of the parities
+        reset_path_sums();
+        original_.foreach_instruction([&](Instruction const& inst) {
+            std::optional<double> const angle = phase_angle(inst);
+            if (!angle) {
+                update(inst);
+                return;
+            }
+            PathSum const& sum = path_sums_.at(inst.target());
+            double& phase = phases_[sum.parity];
+            if (sum.negated) {
+                // P(θ) on ¬f = e^{iθ} P(-θ) on f
+                phase -= *angle;
+                global_phase_ += *angle;
             } else {
-                uint32_t c = inst.control();
-                std::vector<uint32_t> esop;
-                std::set_symmetric_difference(qubit_pathsum.at(c).begin(),
-                  qubit_pathsum.at(c).end(), qubit_pathsum.at(t).begin(),
-                  qubit_pathsum.at(t).end(), std::back_inserter(esop));
-                qubit_pathsum.at(t) = esop;
+                phase += *angle;
+            }
+            if (inst.is_a<Op::Rz>()) {
+                global_phase_ -= *angle / 2;
+            }
+        });
+
+        // Apply all the phases of a parity where it first appears
+        Circuit optimized;
+        original_.foreach_cbit(
+          [&](std::string_view name) { optimized.create_cbit(name); });
+        original_.foreach_qubit(
+          [&](std::string_view name) { optimized.create_qubit(name); });
+        optimized.global_phase() = original_.global_phase() + global_phase_;
+        reset_path_sums();
+        optimized.foreach_qubit([&](Qubit qubit) { fold(optimized, qubit); });
+        original_.foreach_instruction([&](Instruction const& inst) {
+            if (phase_angle(inst)) {
+                return;
+            }
+            optimized.apply_operator(inst);
+            if (update(inst)) {
+                inst.foreach_target(
+                  [&](Qubit qubit) { fold(optimized, qubit.uid()); });
+            }
+        });
+        return optimized;
+    }
+
+private:
+    void reset_path_sums()
+    {
+        num_path_vars_ = 0u;
+        path_sums_.clear();
+        for (uint32_t i = 0u; i < original_.num_qubits(); ++i) {
+            path_sums_.push_back({Parity::variable(num_path_vars_++), false});
+        }
+    }
+
+    // Returns whether the parity of the targets might have changed.
+    bool update(Instruction const& inst)
+    {
+        if (inst.num_cbits() == 0u && inst.is_a<Op::X>()) {
+            if (inst.num_controls() == 0u) {
+                PathSum& target = path_sums_.at(inst.target());
+                target.negated = !target.negated;
+                return false;
+            }
+            if (inst.num_controls() == 1u) {
+                Qubit const control = inst.control();
+                bool const negative =
+                  control.polarity() == Qubit::Polarity::negative;
+                PathSum const& source = path_sums_.at(control);
+                PathSum& target = path_sums_.at(inst.target());
+                target.parity ^= source.parity;
+                target.negated ^= source.negated ^ negative;
+                return true;
             }
         }
-        optimized.apply_operator(inst);
-        double const angle = phase_parities.extract_phase(qubit_pathsum.at(t));
-        if (angle == 0.0) {
+        if (inst.num_cbits() == 0u && inst.is_a<Op::Swap>()
+            && inst.num_controls() == 0u) {
+            std::swap(path_sums_.at(inst.target(0u)),
+              path_sums_.at(inst.target(1u)));
+            return false;
+        }
+        // Any other instruction gives new path variables to its targets.
+        inst.foreach_target([&](Qubit qubit) {
+            path_sums_.at(qubit) = {Parity::variable(num_path_vars_++), false};
+        });
+        return true;
+    }
+
+    void fold(Circuit& optimized, Qubit const qubit)
+    {
+        PathSum const& sum = path_sums_.at(qubit);
+        auto search = phases_.find(sum.parity);
+        if (search == phases_.end()) {
+            return;
+        }
+        double angle = std::remainder(search->second, 2 * numbers::pi);
+        phases_.erase(search);
+        if (std::abs(angle) < 1e-12) {
             return;
         }
-        apply_identified_phase(optimized, angle, inst.target());
-    });
-    return optimized;
+        if (sum.negated) {
+            angle = -angle;
+            optimized.global_phase() -= angle;
+        }
+        apply_identified_phase(optimized, angle, qubit);
+    }
+
+    Circuit const& original_;
+    uint32_t num_path_vars_ = 0u;
+    std::vector<PathSum> path_sums_;
+    std::unordered_map<Parity, double, ParityHash> phases_;
+    double global_phase_ = 0.0;
+};
+
+} // namespace
+
+Circuit phase_folding(Circuit const& original)
+{
+    PhaseFolder folder(original);
+    return folder.run();
 }
 
 } // namespace tweedledum
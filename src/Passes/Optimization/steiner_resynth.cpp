@@ -4,6 +4,7 @@
 *-----------------------------------------------------------------------------*/
 #include "tweedledum/Passes/Optimization/steiner_resynth.h"
 
+#include "tweedledum/IR/InstructionTable.h"
 #include "tweedledum/Operators/Extension/Bridge.h"
 #include "tweedledum/Operators/Extension/Parity.h"
 #include "tweedledum/Operators/Standard/Swap.h"
@@ -21,7 +22,7 @@ struct Slice {
 
 inline std::vector<Slice> partition_into_silces(Circuit const& original)
 {
-    std::vector<uint32_t> to_slice(original.num_instructions(), 0);
+    InstructionTable<uint32_t> to_slice(original.num_refs(), 0u);
     std::vector<Slice> slices;
     original.foreach_instruction([&](InstRef ref, Instruction const& inst) {
         uint32_t max = 0;
@@ -0,0 +1,220 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/Passes/Optimization/two_qubit_resynth.h"
+#include "tweedledum/Decomposition/TwoQubitDecomposer.h"
+#include "tweedledum/IR/InstructionTable.h"
+#include "tweedledum/Operators/Extension/Unitary.h"
+#include "tweedledum/Passes/Analysis/compute_cuts.h"
+#include "tweedledum/Passes/Utility/shallow_duplicate.h"
+
+#include <array>
+#include <optional>
+#include <vector>
+
+namespace tweedledum {
+namespace {
+
+class TwoQubitResynth {
+public:
+    TwoQubitResynth(Circuit const& original, nlohmann::json const& config)
+        : original_(original)
+        , decomposer_(config)
+        , cuts_(compute_cuts(original, 2u))
+        , cut_of_(original.num_refs(), 0u)
+        , replacements_(cuts_.size())
+        , emitted_(original.num_refs(), 0u)
+    {
+        for (uint32_t i = 0u; i < cuts_.size(); ++i) {
+            for (InstRef const ref : cuts_.at(i).instructions) {
+                cut_of_.at(ref) = i;
+            }
+        }
+    }
+
+    Circuit run()
+    {
+        for (uint32_t i = 0u; i < cuts_.size(); ++i) {
+            if (is_candidate(i)) {
+                replacements_.at(i) = resynthesize(cuts_.at(i));
+            }
+        }
+        Circuit optimized = shallow_duplicate(original_);
+        optimized.global_phase() = original_.global_phase();
+        emit_all(optimized);
+        return optimized;
+    }
+
+private:
+    // A cut can be replaced when all its instructions act on the same two
+    // qubits, have a matrix, and are contiguous on both qubits.  (Cuts are not
+    // necessarily convex: an instruction of another cut might come between
+    // two of its instructions on one of the qubits.)
+    bool is_candidate(uint32_t const cut_idx) const
+    {
+        Cut const& cut = cuts_.at(cut_idx);
+        if (cut.num_qubits() != 2u || !cut.cbits.empty()) {
+            return false;
+        }
+        bool has_two_qubit = false;
+        uint32_t num_entries = 0u;
+        for (InstRef const ref : cut.instructions) {
+            Instruction const& inst = original_.instruction(ref);
+            if (inst.num_cbits() != 0u || !inst.matrix()) {
+                return false;
+            }
+            bool negative = false;
+            inst.foreach_qubit([&](Qubit const qubit, InstRef const child) {
+                negative |= qubit.polarity() == Qubit::Polarity::negative;
+                num_entries += child == InstRef::invalid()
+                            || cut_of_.at(child) != cut_idx;
+            });
+            if (negative) {
+                return false;
+            }
+            has_two_qubit |= inst.num_qubits() == 2u;
+        }
+        return has_two_qubit && num_entries == 2u;
+    }
+
+    UMatrix cut_matrix(Cut const& cut) const
+    {
+        Op::UnitaryBuilder builder(2u);
+        uint32_t const q0 = cut.qubits.at(0).uid();
+        for (InstRef const ref : cut.instructions) {
+            Instruction const& inst = original_.instruction(ref);
+            std::vector<uint32_t> qubits;
+            inst.foreach_qubit([&](Qubit const qubit) {
+                qubits.push_back(qubit.uid() == q0 ? 0u : 1u);
+            });
+            builder.apply_operator(inst, qubits);
+        }
+        return builder.finished().matrix();
+    }
+
+    // Number of CX operators needed to implement the instruction.
+    uint32_t num_cx(Instruction const& inst) const
+    {
+        if (inst.num_qubits() != 2u) {
+            return 0u;
+        }
+        Op::UnitaryBuilder builder(2u);
+        builder.apply_operator(inst, std::vector<uint32_t>({0u, 1u}));
+        return decomposer_.num_cx(builder.finished().matrix());
+    }
+
+    std::optional<Circuit> resynthesize(Cut const& cut)
+    {
+        uint32_t cost = 0u;
+        for (InstRef const ref : cut.instructions) {
+            cost += num_cx(original_.instruction(ref));
+        }
+        UMatrix const matrix = cut_matrix(cut);
+        uint32_t const new_cost = decomposer_.num_cx(matrix);
+        if (new_cost > cost) {
+            return std::nullopt;
+        }
+        Circuit block;
+        Qubit const q0 = block.create_qubit();
+        Qubit const q1 = block.create_qubit();
+        std::array<Qubit, 2> const qubits = {q0, q1};
+        Instruction const inst(
+          Op::Unitary(matrix), Span<Qubit const>(qubits), {});
+        if (!decomposer_.decompose(block, inst)) {
+            return std::nullopt;
+        }
+        if (new_cost == cost
+            && block.num_instructions() >= cut.instructions.size()) {
+            return std::nullopt;
+        }
+        return block;
+    }
+
+    bool is_replaced(InstRef const ref) const
+    {
+        return replacements_.at(cut_of_.at(ref)).has_value();
+    }
+
+    // Calls `fn` on the instructions that must be emitted before `ref`, i.e.,
+    // its children, or the children of the whole cut if it is replaced.
+    template<typename Fn>
+    void foreach_dependency(InstRef const ref, Fn&& fn) const
+    {
+        if (!is_replaced(ref)) {
+            original_.foreach_child(ref, fn);
+            return;
+        }
+        uint32_t const cut_idx = cut_of_.at(ref);
+        for (InstRef const inst_ref : cuts_.at(cut_idx).instructions) {
+            original_.foreach_child(inst_ref, [&](InstRef const child) {
+                if (cut_of_.at(child) != cut_idx) {
+                    fn(child);
+                }
+            });
+        }
+    }
+
+    void emit(Circuit& optimized, InstRef const ref)
+    {
+        if (!is_replaced(ref)) {
+            optimized.apply_operator(original_.instruction(ref));
+            emitted_.at(ref) = 1u;
+            return;
+        }
+        Cut const& cut = cuts_.at(cut_of_.at(ref));
+        Circuit const& block = *replacements_.at(cut_of_.at(ref));
+        optimized.append(block, cut.qubits, {});
+        optimized.global_phase() += block.global_phase();
+        for (InstRef const inst_ref : cut.instructions) {
+            emitted_.at(inst_ref) = 1u;
+        }
+    }
+
+    // Replaced cuts are emitted as a whole, hence the instructions can no
+    // longer be emitted in program order: an instruction of another cut might
+    // need to come before the last instruction of a replaced cut.  This is a
+    // depth-first topological sort, where replaced cuts are single nodes.
+    void emit_all(Circuit& optimized)
+    {
+        std::vector<InstRef> stack;
+        original_.foreach_instruction([&](InstRef const ref) {
+            stack.push_back(ref);
+            while (!stack.empty()) {
+                InstRef const top = stack.back();
+                if (emitted_.at(top)) {
+                    stack.pop_back();
+                    continue;
+                }
+                bool ready = true;
+                foreach_dependency(top, [&](InstRef const child) {
+                    if (!emitted_.at(child)) {
+                        ready = false;
+                        stack.push_back(child);
+                    }
+                });
+                if (ready) {
+                    stack.pop_back();
+                    emit(optimized, top);
+                }
+            }
+        });
+    }
+
+    Circuit const& original_;
+    TwoQubitDecomposer decomposer_;
+    std::vector<Cut> cuts_;
+    InstructionTable<uint32_t> cut_of_;
+    std::vector<std::optional<Circuit>> replacements_;
+    InstructionTable<uint8_t> emitted_;
+};
+
+} // namespace
+
+Circuit two_qubit_resynth(Circuit const& original, nlohmann::json const& config)
+{
+    TwoQubitResynth resynth(original, config);
+    return resynth.run();
+}
+
+} // namespace tweedledum
@@ -4,7 +4,18 @@
 *-----------------------------------------------------------------------------*/
 #include "tweedledum/IR/Circuit.h"
 
+#include <algorithm>
+#include <array>
 #include <catch.hpp>
+#include <fmt/format.h>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+// Containers of circuits (e.g. `std::vector<Circuit>`) only move them when
+// moving can't throw.
+static_assert(std::is_nothrow_move_constructible_v<tweedledum::Circuit>);
+static_assert(std::is_nothrow_move_assignable_v<tweedledum::Circuit>);
 
 TEST_CASE("Circuit qubits and cbits", "[circuit][ir]")
 {
@@ -54,6 +65,68 @@ TEST_CASE("Circuit qubits and cbits", "[circuit][ir]")
     CHECK(circuit.qubits() == std::vector<Qubit>({Qubit(0), a0, qubit}));
 }
 
+TEST_CASE("Circuit wire names", "[circuit][ir]")
+{
+    using namespace tweedledum;
+    Circuit circuit;
+    circuit.create_qubit();
+    circuit.create_ancilla();
+    Qubit const a3 = circuit.create_qubit("a", 3u);
+    Qubit const a12 = circuit.create_qubit("a12");
+    Qubit const q007 = circuit.create_qubit("q007");
+    Qubit const q = circuit.create_qubit("q");
+    Qubit const q0 = circuit.create_qubit("q_0");
+    Qubit const big = circuit.create_qubit("x12345678901");
+    Cbit const c = circuit.create_cbit();
+    Cbit const r1 = circuit.create_cbit("r_", 1u);
+
+    std::string_view const name = circuit.name(a3);
+    CHECK(name == "a3");
+    CHECK(circuit.name(a12) == "a12");
+    CHECK(circuit.name(q007) == "q007");
+    CHECK(circuit.name(q) == "q");
+    CHECK(circuit.name(q0) == "q_0");
+    CHECK(circuit.name(big) == "x12345678901");
+    CHECK(circuit.name(c) == "__c0");
+    CHECK(circuit.name(r1) == "r_1");
+
+    // Names remain valid as the circuit grows
+    for (uint32_t i = 0u; i < 100u; ++i) {
+        circuit.create_qubit(fmt::format("reg{}_", i), i);
+    }
+    CHECK(name == "a3");
+    CHECK(circuit.name(Qubit(107)) == "reg99_99");
+
+    std::vector<std::string> names;
+    circuit.foreach_qubit(
+      [&](std::string_view wire_name) { names.emplace_back(wire_name); });
+    CHECK(names.size() == circuit.num_qubits());
+    CHECK(names.at(0) == "__q0");
+    CHECK(names.at(1) == "__a1");
+    CHECK(names.at(3) == "a12");
+    CHECK(names.at(4) == "q007");
+    circuit.foreach_qubit([&](Qubit qubit, std::string_view wire_name) {
+        CHECK(circuit.name(qubit) == wire_name);
+    });
+
+    // Copies can name their wires by themselves
+    Circuit const copy = circuit;
+    CHECK(copy.name(a3) == "a3");
+    CHECK(copy.name(big) == "x12345678901");
+
+    // Names can be asked for concurrently
+    Circuit const other = circuit;
+    uint32_t const num_qubits = other.num_qubits();
+    std::vector<std::string_view> views(4u * num_qubits);
+    ThreadPool pool(4u);
+    pool.parallel_for(0u, views.size(), [&](uint32_t const i) {
+        views.at(i) = other.name(Qubit(i % num_qubits));
+    });
+    for (uint32_t i = 0u; i < views.size(); ++i) {
+        CHECK(views.at(i) == circuit.name(Qubit(i % num_qubits)));
+    }
+}
+
 class Dummy {
 public:
     Dummy()
@@ -141,3 +214,492 @@ TEST_CASE("Circuit apply operator", "[circuit][ir]")
           duplicate.instruction(InstRef(0)) == circuit.instruction(InstRef(0)));
     }
 }
+
+// Too big to be stored inline in an operator
+class BigDummy {
+public:
+    BigDummy() = default;
+
+    BigDummy(BigDummy const& other) = default;
+
+    ~BigDummy()
+    {
+        ++destructed;
+    }
+
+    static constexpr std::string_view kind()
+    {
+        return "big_dummy_optor";
+    }
+
+    bool operator==(BigDummy const& other) const
+    {
+        return data == other.data;
+    }
+
+    std::array<double, 8> data = {};
+    static uint32_t destructed;
+};
+
+uint32_t BigDummy::destructed;
+
+TEST_CASE("Circuit operator arena", "[circuit][ir]")
+{
+    using namespace tweedledum;
+    BigDummy::destructed = 0u;
+    BigDummy dummy;
+    {
+        Circuit circuit;
+        Qubit q0 = circuit.create_qubit();
+        CHECK_FALSE(circuit.has_arena());
+        circuit.enable_arena();
+        REQUIRE(circuit.has_arena());
+        for (uint32_t i = 0; i < 2048u; ++i) {
+            dummy.data[0] = i;
+            circuit.apply_operator(dummy, {q0});
+        }
+        CHECK(circuit.arena()->num_bytes_allocated()
+              == 2048u * sizeof(BigDummy));
+        CHECK(circuit.instruction(InstRef(42)).cast<BigDummy>().data[0] == 42);
+
+        // Copies get their own arena, moves take it.
+        Circuit copy = circuit;
+        CHECK(copy.has_arena());
+        CHECK(copy.arena() != circuit.arena());
+        CHECK(copy.instruction(InstRef(7)) == circuit.instruction(InstRef(7)));
+        BumpAllocator const* arena = circuit.arena();
+        Circuit moved = std::move(circuit);
+        CHECK(moved.arena() == arena);
+        CHECK(moved.instruction(InstRef(7)) == copy.instruction(InstRef(7)));
+
+        BigDummy::destructed = 0u;
+        copy = std::move(moved);
+        CHECK(copy.arena() == arena);
+        CHECK(copy.instruction(InstRef(2047)).cast<BigDummy>().data[0] == 2047);
+    }
+    // All payloads were destroyed: the copied ones, and the ones in the arena
+    CHECK(BigDummy::destructed == 2u * 2048u);
+}
+
+TEST_CASE("Circuit apply operator wire forms", "[circuit][ir]")
+{
+    using namespace tweedledum;
+    Circuit circuit;
+    Cbit c0 = circuit.create_cbit();
+    Qubit q0 = circuit.create_qubit();
+    Qubit q1 = circuit.create_qubit();
+    Qubit q2 = circuit.create_qubit();
+
+    std::vector<Qubit> const qubits = {q0, q1};
+    SmallVector<Qubit, 4> small_qubits;
+    small_qubits.push_back(q1);
+    small_qubits.push_back(!q2);
+    circuit.apply_operator(Dummy(), qubits, {c0});
+    circuit.apply_operator(Dummy(), {q0, q1}, {c0});
+    circuit.apply_operator(Dummy(), Span<Qubit const>(small_qubits));
+    circuit.apply_operator(
+      Dummy(), Span<Qubit const>(qubits), Span<Cbit const>(&c0, 1u));
+    REQUIRE(circuit.num_instructions() == 4u);
+    CHECK(circuit.instruction(InstRef(0)) == circuit.instruction(InstRef(1)));
+    CHECK(circuit.instruction(InstRef(1)) == circuit.instruction(InstRef(3)));
+    CHECK(circuit.instruction(InstRef(2)).qubits()
+          == std::vector<Qubit>({q1, !q2}));
+    CHECK(circuit.instruction(InstRef(2)).cbits().empty());
+
+    // Append, remapping wires (and keeping polarities)
+    Circuit result;
+    Cbit r0 = result.create_cbit();
+    Qubit r1 = result.create_qubit();
+    Qubit r2 = result.create_qubit();
+    Qubit r3 = result.create_qubit();
+    result.append(circuit, {r3, r1, r2}, {r0});
+    REQUIRE(result.num_instructions() == 4u);
+    CHECK(result.instruction(InstRef(0)).qubits()
+          == std::vector<Qubit>({r3, r1}));
+    CHECK(result.instruction(InstRef(0)).cbits() == std::vector<Cbit>({r0}));
+    CHECK(result.instruction(InstRef(2)).qubits()
+          == std::vector<Qubit>({r1, !r2}));
+    std::vector<uint32_t> children;
+    result.foreach_child(
+      InstRef(3), [&](InstRef child) { children.push_back(child); });
+    CHECK(children == std::vector<uint32_t>({1u, 1u, 2u}));
+}
+
+TEST_CASE("Circuit successors and inputs", "[circuit][ir]")
+{
+    using namespace tweedledum;
+    Circuit circuit;
+    Cbit c0 = circuit.create_cbit();
+    Qubit q0 = circuit.create_qubit();
+    Qubit q1 = circuit.create_qubit();
+    Qubit q2 = circuit.create_qubit();
+    circuit.apply_operator(Dummy(), {q0});
+    circuit.apply_operator(Dummy(), {q0, q1});
+    circuit.apply_operator(Dummy(), {q1}, {c0});
+    circuit.apply_operator(Dummy(), {q0, q1});
+
+    std::vector<uint32_t> inputs;
+    circuit.foreach_input([&](InstRef ref) { inputs.push_back(ref); });
+    CHECK(inputs == std::vector<uint32_t>({0u, 1u, 2u}));
+
+    std::vector<uint32_t> successors;
+    circuit.foreach_successor(
+      InstRef(1), [&](InstRef ref) { successors.push_back(ref); });
+    CHECK(successors == std::vector<uint32_t>({3u, 2u}));
+
+    // The index is kept up to date when the circuit is modified
+    circuit.apply_operator(Dummy(), {q2, q0});
+    successors.clear();
+    circuit.foreach_successor(
+      InstRef(3), [&](InstRef ref) { successors.push_back(ref); });
+    CHECK(successors == std::vector<uint32_t>({4u}));
+    inputs.clear();
+    circuit.foreach_input([&](InstRef ref) { inputs.push_back(ref); });
+    CHECK(inputs == std::vector<uint32_t>({0u, 1u, 4u, 2u}));
+
+    // Successors are the reverse of children
+    circuit.foreach_instruction([&](InstRef ref) {
+        circuit.foreach_child(ref, [&](InstRef child) {
+            uint32_t found = 0u;
+            circuit.foreach_successor(child, [&](InstRef successor) {
+                found += (successor == ref);
+            });
+            CHECK(found > 0u);
+        });
+    });
+}
+
+namespace {
+using namespace tweedledum;
+
+// Checks that children, successors, inputs and outputs agree with the program
+// order of the instructions on each wire.
+void check_links(Circuit const& circuit)
+{
+    std::vector<std::vector<InstRef>> on_qubit(circuit.num_qubits());
+    std::vector<std::vector<InstRef>> on_cbit(circuit.num_cbits());
+    circuit.foreach_instruction([&](InstRef ref, Instruction const& inst) {
+        CHECK_FALSE(circuit.is_removed(ref));
+        inst.foreach_qubit([&](Qubit qubit, InstRef child) {
+            std::vector<InstRef>& refs = on_qubit.at(qubit);
+            CHECK((refs.empty() ? InstRef::invalid() : refs.back()) == child);
+            refs.push_back(ref);
+        });
+        inst.foreach_cbit([&](Cbit cbit, InstRef child) {
+            std::vector<InstRef>& refs = on_cbit.at(cbit);
+            CHECK((refs.empty() ? InstRef::invalid() : refs.back()) == child);
+            refs.push_back(ref);
+        });
+    });
+    std::vector<uint32_t> expected_inputs;
+    std::vector<uint32_t> expected_outputs;
+    auto check_wire = [&](std::vector<InstRef> const& refs) {
+        if (refs.empty()) {
+            return;
+        }
+        expected_inputs.push_back(refs.front());
+        expected_outputs.push_back(refs.back());
+        for (uint32_t i = 1u; i < refs.size(); ++i) {
+            uint32_t found = 0u;
+            circuit.foreach_successor(refs.at(i - 1), [&](InstRef successor) {
+                found += (successor == refs.at(i));
+            });
+            CHECK(found > 0u);
+        }
+    };
+    std::for_each(on_qubit.begin(), on_qubit.end(), check_wire);
+    std::for_each(on_cbit.begin(), on_cbit.end(), check_wire);
+    std::vector<uint32_t> inputs;
+    circuit.foreach_input([&](InstRef ref) { inputs.push_back(ref); });
+    CHECK(inputs == expected_inputs);
+    std::vector<uint32_t> outputs;
+    circuit.foreach_output([&](InstRef ref) { outputs.push_back(ref); });
+    CHECK(outputs == expected_outputs);
+}
+
+std::vector<uint32_t> program_order(Circuit const& circuit)
+{
+    std::vector<uint32_t> order;
+    circuit.foreach_instruction([&](InstRef ref) { order.push_back(ref); });
+    return order;
+}
+} // namespace
+
+TEST_CASE("Circuit in-place editing", "[circuit][ir]")
+{
+    using namespace tweedledum;
+    Circuit circuit;
+    Cbit c0 = circuit.create_cbit();
+    Qubit q0 = circuit.create_qubit();
+    Qubit q1 = circuit.create_qubit();
+    Qubit q2 = circuit.create_qubit();
+    circuit.apply_operator(Dummy(), {q0});
+    circuit.apply_operator(Dummy(), {q0, q1});
+    circuit.apply_operator(Dummy(), {q1}, {c0});
+    circuit.apply_operator(Dummy(), {q0, q1});
+    circuit.enable_columns();
+    CHECK(circuit.is_compact());
+
+    SECTION("Remove")
+    {
+        circuit.remove_instruction(InstRef(1));
+        CHECK_FALSE(circuit.is_compact());
+        CHECK_FALSE(circuit.has_columns());
+        CHECK(circuit.is_removed(InstRef(1)));
+        CHECK(circuit.num_instructions() == 3u);
+        CHECK(program_order(circuit) == std::vector<uint32_t>({0u, 2u, 3u}));
+        check_links(circuit);
+
+        circuit.remove_instruction(InstRef(3));
+        circuit.remove_instruction(InstRef(0));
+        CHECK(program_order(circuit) == std::vector<uint32_t>({2u}));
+        check_links(circuit);
+    }
+    SECTION("Append after remove")
+    {
+        circuit.remove_instruction(InstRef(1));
+        InstRef const i4 = circuit.apply_operator(Dummy(), {q1, q2});
+        CHECK(i4 == InstRef(4));
+        CHECK(circuit.instruction(i4).qubit(0) == q1);
+        CHECK(program_order(circuit)
+              == std::vector<uint32_t>({0u, 2u, 3u, 4u}));
+        check_links(circuit);
+
+        Circuit other;
+        Qubit o_q0 = other.create_qubit();
+        other.apply_operator(Dummy(), {o_q0});
+        circuit.append(other, {q1}, {});
+        InstRef const i6 = circuit.apply_operator(Dummy(), {q1});
+        CHECK(i6 == InstRef(6));
+        CHECK(program_order(circuit)
+              == std::vector<uint32_t>({0u, 2u, 3u, 4u, 5u, 6u}));
+        check_links(circuit);
+        std::vector<InstRef> children;
+        circuit.foreach_child(i6, [&](InstRef ref) { children.push_back(ref); });
+        CHECK(children == std::vector<InstRef>({InstRef(5)}));
+    }
+    SECTION("Insert")
+    {
+        // Neither neighbor acts on q2
+        InstRef const i4 = circuit.insert_before(InstRef(3), Dummy(), {q2});
+        CHECK(i4 == InstRef(4));
+        InstRef const i5 = circuit.insert_after(InstRef(0), Dummy(), {q0, q2});
+        CHECK(program_order(circuit)
+              == std::vector<uint32_t>({0u, 5u, 1u, 2u, 4u, 3u}));
+        CHECK(circuit.instruction(i4).qubit(0) == q2);
+        check_links(circuit);
+
+        // New instructions are applied at the end of the program
+        circuit.apply_operator(Dummy(), {q2, q1});
+        InstRef const i7 = circuit.insert_before(InstRef(0), Dummy(), {q1});
+        CHECK(i7 == InstRef(7));
+        CHECK(program_order(circuit)
+              == std::vector<uint32_t>({7u, 0u, 5u, 1u, 2u, 4u, 3u, 6u}));
+        check_links(circuit);
+
+        std::vector<uint32_t> reversed;
+        circuit.foreach_r_instruction(
+          [&](InstRef ref) { reversed.push_back(ref); });
+        CHECK(reversed == std::vector<uint32_t>({6u, 3u, 4u, 2u, 1u, 5u, 0u, 7u}));
+        CHECK(i5 == InstRef(5));
+    }
+    SECTION("Replace and compact")
+    {
+        Circuit replacement;
+        Cbit r_c0 = replacement.create_cbit();
+        Qubit r_q0 = replacement.create_qubit();
+        Qubit r_q1 = replacement.create_qubit();
+        replacement.apply_operator(Dummy(), {r_q1, r_q0});
+        replacement.apply_operator(Dummy(), {r_q0}, {r_c0});
+        circuit.replace_instruction(InstRef(1), replacement, {q2, q0}, {c0});
+        CHECK(circuit.num_instructions() == 5u);
+        CHECK(program_order(circuit)
+              == std::vector<uint32_t>({0u, 4u, 5u, 2u, 3u}));
+        check_links(circuit);
+
+        circuit.compact();
+        CHECK(circuit.is_compact());
+        CHECK(circuit.has_columns());
+        CHECK(circuit.columns().num_instructions() == 5u);
+        CHECK(program_order(circuit)
+              == std::vector<uint32_t>({0u, 1u, 2u, 3u, 4u}));
+        check_links(circuit);
+        std::vector<std::vector<Qubit>> qubits;
+        circuit.foreach_instruction(
+          [&](Instruction const& inst) { qubits.push_back(inst.qubits()); });
+        CHECK(qubits
+              == std::vector<std::vector<Qubit>>(
+                {{q0}, {q0, q2}, {q2}, {q1}, {q0, q1}}));
+    }
+}
+
+TEST_CASE("Circuit instruction attributes", "[circuit][ir]")
+{
+    using namespace tweedledum;
+    Circuit circuit;
+    Qubit q0 = circuit.create_qubit();
+    Qubit q1 = circuit.create_qubit();
+    InstRef const i0 = circuit.apply_operator(Dummy(), {q0});
+    InstRef const i1 = circuit.apply_operator(Dummy(), {q0, q1});
+    CHECK(circuit.find_attribute<double>("duration") == nullptr);
+
+    InstructionTable<double>& durations = circuit.attribute("duration", 1.0);
+    CHECK(durations.size() == 2u);
+    durations[i0] = 0.5;
+    durations[i1] = 2.0;
+    CHECK(&circuit.attribute<double>("duration") == &durations);
+    InstructionTable<double> const* found =
+      circuit.find_attribute<double>("duration");
+    REQUIRE(found == &durations);
+    CHECK_THROWS_AS(circuit.attribute<uint32_t>("duration"),
+      std::invalid_argument);
+    CHECK_THROWS_AS(circuit.find_attribute<uint32_t>("duration"),
+      std::invalid_argument);
+
+    // Tables grow with the circuit
+    InstRef const i2 = circuit.apply_operator(Dummy(), {q1});
+    CHECK(durations.size() == 3u);
+    CHECK(durations[i2] == 1.0);
+
+    // Copies get their own tables
+    Circuit copy = circuit;
+    copy.attribute<double>("duration")[i0] = 4.0;
+    CHECK(durations[i0] == 0.5);
+
+    // Entries move along with their instructions when compacting
+    InstRef const i3 = circuit.insert_before(i1, Dummy(), {q1});
+    CHECK(durations.size() == 4u);
+    durations[i3] = 3.0;
+    circuit.remove_instruction(i0);
+    circuit.compact();
+    CHECK(durations.size() == 3u);
+    std::vector<double> values(durations.values().begin(),
+      durations.values().end());
+    CHECK(values == std::vector<double>({3.0, 2.0, 1.0}));
+
+    circuit.remove_attribute("duration");
+    CHECK(circuit.find_attribute<double>("duration") == nullptr);
+}
+
+TEST_CASE("Circuit incremental layers", "[circuit][ir]")
+{
+    using namespace tweedledum;
+    // Recomputes the layers from scratch
+    auto check_layers = [](Circuit const& circuit) {
+        std::vector<uint32_t> expected(circuit.num_refs(), 0u);
+        uint32_t depth = 0u;
+        circuit.foreach_instruction([&](InstRef const ref) {
+            uint32_t layer = 0u;
+            circuit.foreach_child(ref, [&](InstRef const child) {
+                layer = std::max(layer, expected.at(child) + 1);
+            });
+            expected.at(ref) = layer;
+            depth = std::max(depth, layer + 1);
+            CHECK(circuit.layer(ref) == layer);
+        });
+        CHECK(circuit.depth() == depth);
+    };
+    Circuit circuit;
+    Qubit q0 = circuit.create_qubit();
+    Qubit q1 = circuit.create_qubit();
+    Qubit q2 = circuit.create_qubit();
+    Cbit c0 = circuit.create_cbit();
+    InstRef const i0 = circuit.apply_operator(Dummy(), {q0});
+    InstRef const i1 = circuit.apply_operator(Dummy(), {q0, q1});
+    circuit.enable_layers();
+    CHECK(circuit.has_layers());
+    CHECK(circuit.depth() == 2u);
+    CHECK(circuit.depth(q2) == 0u);
+
+    InstRef const i2 = circuit.apply_operator(Dummy(), {q1, q2});
+    InstRef const i3 = circuit.apply_operator(Dummy(), {q2}, {c0});
+    InstRef const i4 = circuit.apply_operator(Dummy(), {q0});
+    CHECK(circuit.layer(i1) == 1u);
+    CHECK(circuit.layer(i3) == 3u);
+    CHECK(circuit.layer(i4) == 2u);
+    CHECK(circuit.depth() == 4u);
+    CHECK(circuit.depth(q0) == 3u);
+    CHECK(circuit.depth(c0) == 4u);
+    check_layers(circuit);
+
+    SECTION("Insertions push the following instructions")
+    {
+        circuit.insert_before(i1, Dummy(), {q0});
+        CHECK(circuit.layer(i1) == 2u);
+        CHECK(circuit.layer(i4) == 3u);
+        CHECK(circuit.depth() == 5u);
+        check_layers(circuit);
+        circuit.insert_after(i0, Dummy(), {q2});
+        check_layers(circuit);
+    }
+    SECTION("Removals pull the following instructions")
+    {
+        circuit.remove_instruction(i0);
+        CHECK(circuit.layer(i1) == 0u);
+        CHECK(circuit.depth() == 3u);
+        check_layers(circuit);
+        circuit.remove_instruction(i3);
+        CHECK(circuit.depth() == 2u);
+        CHECK(circuit.depth(c0) == 0u);
+        check_layers(circuit);
+        circuit.remove_instruction(i2);
+        circuit.remove_instruction(i1);
+        CHECK(circuit.depth() == 1u);
+        check_layers(circuit);
+    }
+    SECTION("Compacting keeps the layers")
+    {
+        circuit.remove_instruction(i2);
+        circuit.insert_after(i4, Dummy(), {q0, q2});
+        circuit.compact();
+        CHECK(circuit.has_layers());
+        CHECK(circuit.depth() == 4u);
+        check_layers(circuit);
+        Circuit copy = circuit;
+        copy.apply_operator(Dummy(), {q0, q1});
+        CHECK(copy.depth() == 5u);
+        CHECK(circuit.depth() == 4u);
+    }
+    circuit.disable_layers();
+    CHECK_FALSE(circuit.has_layers());
+}
+
+TEST_CASE("Circuit parallel layer traversal", "[circuit][ir]")
+{
+    using namespace tweedledum;
+    Circuit circuit;
+    std::vector<Qubit> qubits;
+    for (uint32_t i = 0u; i < 8u; ++i) {
+        qubits.push_back(circuit.create_qubit());
+    }
+    for (uint32_t i = 0u; i < 200u; ++i) {
+        Qubit const a = qubits.at((i * 5u) % 8u);
+        Qubit const b = qubits.at((i * 3u + 1u) % 8u);
+        if (a == b) {
+            circuit.apply_operator(Dummy(), {a});
+        } else {
+            circuit.apply_operator(Dummy(), {a, b});
+        }
+    }
+    auto check = [&](ThreadPool& pool) {
+        // When visiting an instruction, all of its children have been visited
+        std::vector<uint8_t> visited(circuit.num_refs(), 0u);
+        std::atomic<uint32_t> num_visited = 0u;
+        std::atomic<uint32_t> num_errors = 0u;
+        circuit.parallel_foreach_layer(pool, [&](InstRef const ref) {
+            circuit.foreach_child(ref, [&](InstRef const child) {
+                num_errors += visited.at(child) ? 0u : 1u;
+            });
+            visited.at(ref) = 1u;
+            ++num_visited;
+        });
+        CHECK(num_visited == circuit.num_instructions());
+        CHECK(num_errors == 0u);
+    };
+    ThreadPool pool(4u);
+    check(pool);
+    circuit.enable_layers();
+    check(pool);
+    circuit.remove_instruction(InstRef(3));
+    check(pool);
+}
@@ -255,3 +255,82 @@ TEST_CASE("Check two-target, two-qubit adjointness", "[instruction][ir]")
         }
     }
 }
+
+TEST_CASE("Move instructions", "[instruction][ir]")
+{
+    using namespace tweedledum;
+    static_assert(std::is_nothrow_move_constructible_v<Operator>);
+    static_assert(std::is_nothrow_move_constructible_v<Instruction>);
+
+    Circuit circuit;
+    Qubit q0 = circuit.create_qubit();
+    Qubit q1 = circuit.create_qubit();
+    UMatrix const matrix = Op::Swap().matrix();
+    circuit.apply_operator(Op::Unitary(matrix), {q0, q1});
+    circuit.apply_operator(Op::Rz(numbers::pi_div_4), {q0, q1});
+
+    Instruction unitary = circuit.instruction(InstRef(0));
+    Instruction rz = circuit.instruction(InstRef(1));
+    void const* payload = unitary.cast<Op::Unitary>().matrix().data();
+
+    Instruction moved_unitary(std::move(unitary));
+    CHECK(moved_unitary.cast<Op::Unitary>().matrix().data() == payload);
+    CHECK(moved_unitary == circuit.instruction(InstRef(0)));
+
+    Instruction moved_rz(std::move(rz));
+    CHECK(moved_rz == circuit.instruction(InstRef(1)));
+    CHECK(moved_rz.angle() == numbers::pi_div_4);
+
+    moved_rz = std::move(moved_unitary);
+    CHECK(moved_rz.cast<Op::Unitary>().matrix().data() == payload);
+    CHECK(moved_rz.num_qubits() == 2u);
+    CHECK(moved_rz.num_controls() == 0u);
+
+    // Heap-allocated operators give away their payload
+    kitty::dynamic_truth_table tt(2u);
+    kitty::create_from_hex_string(tt, "8");
+    Operator table = Op::TruthTable(tt);
+    void const* table_payload = &table.cast<Op::TruthTable>();
+    Operator moved_table(std::move(table));
+    CHECK(&moved_table.cast<Op::TruthTable>() == table_payload);
+}
+
+namespace {
+struct MyOp {
+    static constexpr std::string_view kind()
+    {
+        return "test.my_op";
+    }
+};
+} // namespace
+
+TEST_CASE("Operator kind identifiers", "[instruction][ir]")
+{
+    using namespace tweedledum;
+    Operator x = Op::X();
+    Operator t = Op::T();
+    CHECK(x.kind_id() == operator_kind_id<Op::X>());
+    CHECK(operator_kind_name(x.kind_id()) == Op::X::kind());
+    CHECK(x.is_a<Op::X>());
+    CHECK_FALSE(x.is_a<Op::Y>());
+    CHECK(t.is_one<Op::S, Op::T, Op::Z>());
+    CHECK_FALSE(t.is_one<Op::S, Op::Tdg, Op::Z>());
+
+    // Copies, moves and re-assignments keep the identifier in sync
+    Operator copy = x;
+    CHECK(copy.is_a<Op::X>());
+    Operator moved(std::move(copy));
+    CHECK(moved.is_a<Op::X>());
+    moved = t;
+    CHECK(moved.is_a<Op::T>());
+    moved = Op::H();
+    CHECK(moved.is_a<Op::H>());
+
+    // Custom operators register themselves on first use, and explicit
+    // registration of the same kind returns the same identifier.
+    Operator custom = MyOp();
+    CHECK(custom.is_a<MyOp>());
+    CHECK(register_operator_kind("test.my_op") == custom.kind_id());
+    CHECK(custom.kind_id() < num_operator_kinds());
+    CHECK_FALSE(custom == x);
+}
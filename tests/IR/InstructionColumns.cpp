@@ -0,0 +1,120 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/IR/InstructionColumns.h"
+
+#include "tweedledum/IR/Circuit.h"
+#include "tweedledum/Operators/All.h"
+#include "tweedledum/Passes/Analysis/compute_alap_layers.h"
+#include "tweedledum/Passes/Analysis/compute_asap_layers.h"
+#include "tweedledum/Passes/Analysis/count_operators.h"
+#include "tweedledum/Passes/Optimization/gate_cancellation.h"
+#include "tweedledum/Passes/Utility/inverse.h"
+#include "tweedledum/Utils/Numbers.h"
+
+#include "../test_circuits.h"
+
+#include <catch.hpp>
+#include <string_view>
+#include <vector>
+
+TEST_CASE("Columns mirror instructions", "[columns][ir]")
+{
+    using namespace tweedledum;
+    Circuit circuit;
+    Cbit c0 = circuit.create_cbit();
+    Qubit q0 = circuit.create_qubit();
+    Qubit q1 = circuit.create_qubit();
+    Qubit q2 = circuit.create_qubit();
+    circuit.apply_operator(Op::H(), {q0});
+    circuit.enable_columns();
+    circuit.apply_operator(Op::Rz(numbers::pi_div_4), {q0});
+    circuit.apply_operator(Op::X(), {q0, q1});
+    circuit.apply_operator(Op::X(), {q1, q2, q0});
+    circuit.apply_operator(Op::Measure(), {q2}, {c0});
+    circuit.apply_operator(Op::H(), {q1});
+    REQUIRE(circuit.has_columns());
+
+    InstructionColumns const& columns = circuit.columns();
+    REQUIRE(columns.num_instructions() == circuit.num_instructions());
+    circuit.foreach_instruction([&](InstRef ref, Instruction const& inst) {
+        CHECK(columns.kind(ref) == inst.kind());
+        CHECK(columns.kind_id(ref) == inst.kind_id());
+        CHECK(columns.num_qubits(ref) == inst.num_qubits());
+        CHECK(columns.num_cbits(ref) == inst.num_cbits());
+        CHECK(columns.num_controls(ref) == inst.num_controls());
+        std::optional<double> const angle = inst.angle();
+        CHECK(columns.has_parameter(ref) == angle.has_value());
+        if (angle) {
+            CHECK(columns.parameter(ref) == *angle);
+        }
+        uint32_t i = 0u;
+        inst.foreach_qubit([&](Qubit qubit, InstRef child) {
+            CHECK(columns.qubits(ref)[i] == qubit);
+            CHECK(columns.qubits_children(ref)[i] == child);
+            ++i;
+        });
+        i = 0u;
+        inst.foreach_cbit([&](Cbit cbit, InstRef child) {
+            CHECK(columns.cbits(ref)[i] == cbit);
+            CHECK(columns.cbits_children(ref)[i] == child);
+            ++i;
+        });
+    });
+    CHECK(columns.kind(InstRef(0)) == columns.kind(InstRef(5)));
+    CHECK(columns.kind_id(InstRef(2)) == columns.kind_id(InstRef(3)));
+    CHECK(columns.kind_id(InstRef(2)) == operator_kind_id<Op::X>());
+
+    circuit.disable_columns();
+    CHECK_FALSE(circuit.has_columns());
+}
+
+namespace {
+// An operator with more targets than fit in a byte
+class Wide {
+public:
+    static constexpr std::string_view kind()
+    {
+        return "test.wide";
+    }
+
+    uint32_t num_targets() const
+    {
+        return 300u;
+    }
+};
+} // namespace
+
+TEST_CASE("Columns of wide operators", "[columns][ir]")
+{
+    using namespace tweedledum;
+    Circuit circuit;
+    std::vector<Qubit> qubits;
+    for (uint32_t i = 0u; i < 302u; ++i) {
+        qubits.push_back(circuit.create_qubit());
+    }
+    circuit.enable_columns();
+    InstRef const ref = circuit.apply_operator(Wide(), qubits);
+    CHECK(circuit.columns().num_targets(ref) == 300u);
+    CHECK(circuit.columns().num_controls(ref) == 2u);
+}
+
+TEST_CASE("Analyses on columnar circuits", "[columns][ir]")
+{
+    using namespace tweedledum;
+    Circuit circuit = toffoli();
+    std::optional<Circuit> adjoint = inverse(circuit);
+    REQUIRE(adjoint);
+    circuit.append(*adjoint, circuit.qubits(), circuit.cbits());
+
+    Circuit columnar = circuit;
+    columnar.enable_columns();
+    CHECK(compute_asap_layers(circuit) == compute_asap_layers(columnar));
+    CHECK(compute_alap_layers(circuit) == compute_alap_layers(columnar));
+    CHECK(count_operators(circuit) == count_operators(columnar));
+
+    Circuit optimized = gate_cancellation(columnar);
+    CHECK(optimized.has_columns());
+    CHECK(optimized.num_instructions() == 0u);
+}
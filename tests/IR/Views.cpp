@@ -0,0 +1,134 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/IR/Views.h"
+
+#include "tweedledum/IR/Circuit.h"
+#include "tweedledum/Operators/All.h"
+#include "tweedledum/Passes/Analysis/compute_alap_layers.h"
+#include "tweedledum/Passes/Analysis/compute_asap_layers.h"
+#include "tweedledum/Passes/Analysis/compute_cuts.h"
+#include "tweedledum/Passes/Analysis/compute_depth.h"
+#include "tweedledum/Passes/Analysis/count_operators.h"
+#include "tweedledum/Passes/Utility/reverse.h"
+
+#include "../test_circuits.h"
+
+#include <catch.hpp>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+namespace {
+using namespace tweedledum;
+
+// A view must give the same analyses results as its materialized copy.
+template<typename ViewT>
+void check_view(ViewT const& view)
+{
+    Circuit const copy = view.materialize();
+    CHECK(view.num_instructions() == copy.num_instructions());
+    CHECK(compute_asap_layers(view) == compute_asap_layers(copy));
+    CHECK(compute_alap_layers(view) == compute_alap_layers(copy));
+    CHECK(count_operators(view) == count_operators(copy));
+    view.foreach_instruction([&](InstRef ref, Instruction const& inst) {
+        CHECK(&inst == &view.circuit().instruction(view.circuit_ref(ref)));
+        CHECK(inst.kind() == copy.instruction(ref).kind());
+        CHECK(inst.qubits() == copy.instruction(ref).qubits());
+    });
+}
+} // namespace
+
+TEST_CASE("Slice view", "[views][ir]")
+{
+    using namespace tweedledum;
+    Circuit circuit = toffoli();
+    SliceView all(circuit, InstRef(0), InstRef(circuit.num_instructions()));
+    CHECK(compute_asap_layers(all) == compute_asap_layers(circuit));
+    CHECK(count_operators(all) == count_operators(circuit));
+    check_view(all);
+
+    SliceView slice(circuit, InstRef(3), InstRef(9));
+    CHECK(slice.num_instructions() == 6u);
+    CHECK(slice.circuit_ref(InstRef(0)) == InstRef(3));
+    CHECK(slice.view_ref(InstRef(2)) == InstRef::invalid());
+    check_view(slice);
+
+    SliceView empty(circuit, InstRef(4), InstRef(4));
+    CHECK(empty.num_instructions() == 0u);
+    CHECK(empty.materialize().num_instructions() == 0u);
+}
+
+TEST_CASE("Reversed view", "[views][ir]")
+{
+    using namespace tweedledum;
+    Circuit circuit = toffoli();
+    ReversedView reversed(circuit);
+    Circuit const copy = reverse(circuit);
+    CHECK(compute_asap_layers(reversed) == compute_asap_layers(copy));
+    CHECK(compute_alap_layers(reversed) == compute_alap_layers(copy));
+    CHECK(compute_depth(reversed) == compute_depth(circuit));
+    check_view(reversed);
+
+    // Edited circuits are reversed in program order, but cannot be viewed
+    Circuit edited;
+    Qubit const q0 = edited.create_qubit();
+    Qubit const q1 = edited.create_qubit();
+    InstRef const h = edited.apply_operator(Op::H(), {q0});
+    InstRef const t = edited.apply_operator(Op::T(), {q0});
+    edited.apply_operator(Op::X(), {q0, q1});
+    edited.insert_before(t, Op::S(), {q0});
+    edited.remove_instruction(t);
+    edited.insert_before(h, Op::Y(), {q1});
+    CHECK_THROWS_AS(ReversedView(edited), std::invalid_argument);
+    std::vector<std::string_view> kinds;
+    reverse(edited).foreach_instruction(
+      [&](Instruction const& inst) { kinds.push_back(inst.kind()); });
+    CHECK(kinds
+          == std::vector<std::string_view>(
+            {"std.x", "std.s", "std.h", "std.y"}));
+    edited.compact();
+    Circuit const expected = reverse(edited);
+    CHECK(ReversedView(edited).materialize().structural_hash()
+          == expected.structural_hash());
+}
+
+TEST_CASE("Qubit subset and layer views", "[views][ir]")
+{
+    using namespace tweedledum;
+    Circuit circuit = toffoli();
+    QubitSubsetView q2_only(circuit, {Qubit(2)});
+    CHECK(q2_only.num_instructions() == 10u);
+    check_view(q2_only);
+
+    QubitSubsetView q0_q1(circuit, {Qubit(0), Qubit(1)});
+    CHECK(q0_q1.num_instructions() == 9u);
+    check_view(q0_q1);
+
+    std::vector<uint32_t> const layers = compute_asap_layers(circuit);
+    uint32_t num_instructions = 0u;
+    for (uint32_t i = 0u; i < compute_depth(circuit); ++i) {
+        LayerView layer(circuit, layers, i);
+        CHECK(layer.num_instructions() > 0u);
+        CHECK(compute_depth(layer) == 1u);
+        num_instructions += layer.num_instructions();
+    }
+    CHECK(num_instructions == circuit.num_instructions());
+    LayerView some_layers(circuit, layers, 2u, 5u);
+    CHECK(compute_depth(some_layers) == 3u);
+    check_view(some_layers);
+}
+
+TEST_CASE("Cut views", "[views][ir]")
+{
+    using namespace tweedledum;
+    Circuit circuit = toffoli();
+    uint32_t num_instructions = 0u;
+    for (Cut const& cut : compute_cuts(circuit, 2u)) {
+        SubsetView view(circuit, cut.instructions);
+        num_instructions += view.num_instructions();
+        check_view(view);
+    }
+    CHECK(num_instructions == circuit.num_instructions());
+}
@@ -0,0 +1,214 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/Parser/binary.h"
+#include "tweedledum/Operators/All.h"
+#include "tweedledum/Utils/Numbers.h"
+
+#include "../test_circuits.h"
+
+#include <catch.hpp>
+#include <cstdio>
+#include <filesystem>
+#include <random>
+#include <sstream>
+
+namespace {
+using namespace tweedledum;
+
+void check_equal(Circuit const& expected, Circuit const& actual)
+{
+    REQUIRE(actual.num_instructions() == expected.num_instructions());
+    CHECK(actual.num_qubits() == expected.num_qubits());
+    CHECK(actual.num_cbits() == expected.num_cbits());
+    CHECK(actual.global_phase() == expected.global_phase());
+    expected.foreach_qubit([&](Qubit qubit, std::string_view name) {
+        CHECK(actual.name(qubit) == name);
+    });
+    expected.foreach_cbit([&](Cbit cbit, std::string_view name) {
+        CHECK(actual.name(cbit) == name);
+    });
+    expected.foreach_instruction([&](InstRef ref, Instruction const& inst) {
+        Instruction const& other = actual.instruction(ref);
+        CHECK(inst == other);
+        CHECK(inst.qubits() == other.qubits());
+        CHECK(inst.cbits() == other.cbits());
+        inst.foreach_qubit([&](Qubit qubit, InstRef child) {
+            uint32_t i = 0u;
+            other.foreach_qubit([&](Qubit other_qubit, InstRef other_child) {
+                if (other_qubit == qubit) {
+                    CHECK(other_child == child);
+                    ++i;
+                }
+            });
+            CHECK(i == 1u);
+        });
+    });
+}
+
+Circuit all_kinds()
+{
+    Circuit circuit;
+    Qubit q0 = circuit.create_qubit("a");
+    Qubit q1 = circuit.create_qubit("b");
+    Qubit q2 = circuit.create_qubit();
+    Cbit c0 = circuit.create_cbit("c");
+    circuit.global_phase() = numbers::pi_div_4;
+    circuit.apply_operator(Op::H(), {q0});
+    circuit.apply_operator(Op::X(), {!q0, q1, q2});
+    circuit.apply_operator(Op::Rx(0.25), {q1});
+    circuit.apply_operator(Op::P(-1.5), {q1, q2});
+    circuit.apply_operator(Op::U(0.1, 0.2, 0.3), {q2});
+    circuit.apply_operator(Op::Rzz(numbers::pi), {q0, q2});
+    circuit.apply_operator(Op::Swap(), {q0, q1});
+    circuit.apply_operator(Op::Unitary(Op::Rxx(0.5).matrix()), {q1, q2});
+    circuit.apply_operator(Op::Barrier(), {q0, q1, q2});
+    circuit.apply_operator(Op::Measure(), {q0}, {c0});
+    circuit.apply_operator(Op::X(), {q2}, {!c0});
+    return circuit;
+}
+} // namespace
+
+TEST_CASE("Binary round trip", "[binary][parser]")
+{
+    using namespace tweedledum;
+    for (Circuit const& circuit : {Circuit(), toffoli(), all_kinds()}) {
+        std::ostringstream os;
+        REQUIRE(binary::write(circuit, os));
+        std::optional<binary::MappedCircuit> mapped =
+          binary::MappedCircuit::from_buffer(os.str());
+        REQUIRE(mapped);
+        CHECK(mapped->num_instructions() == circuit.num_instructions());
+        check_equal(circuit, mapped->load());
+    }
+}
+
+TEST_CASE("Binary lazy access", "[binary][parser]")
+{
+    using namespace tweedledum;
+    Circuit circuit = all_kinds();
+    std::ostringstream os;
+    REQUIRE(binary::write(circuit, os));
+    std::optional<binary::MappedCircuit> mapped =
+      binary::MappedCircuit::from_buffer(os.str());
+    REQUIRE(mapped);
+    CHECK(mapped->num_qubits() == 3u);
+    CHECK(mapped->num_cbits() == 1u);
+    CHECK(mapped->name(Qubit(1)) == "b");
+    CHECK(mapped->name(Cbit(0)) == "c");
+    CHECK(mapped->kind(InstRef(4)) == "std.u");
+    CHECK(mapped->parameters(InstRef(4)).size() == 3u);
+    CHECK(mapped->parameters(InstRef(4))[1] == 0.2);
+    CHECK(mapped->num_qubits(InstRef(1)) == 3u);
+    CHECK(mapped->qubit(InstRef(1), 0) == !Qubit(0));
+    CHECK(mapped->cbit(InstRef(10), 0) == !Cbit(0));
+    CHECK(mapped->instruction(InstRef(7)) == circuit.instruction(InstRef(7)));
+
+    // Moving keeps the data valid
+    binary::MappedCircuit moved = std::move(*mapped);
+    CHECK(moved.kind(InstRef(2)) == "std.rx");
+}
+
+TEST_CASE("Binary streaming writer", "[binary][parser]")
+{
+    using namespace tweedledum;
+    std::ostringstream os;
+    binary::Writer writer(os);
+    Qubit q0 = writer.create_qubit("q0");
+    Qubit q1 = writer.create_qubit("q1");
+    std::vector<Qubit> const target = {q1};
+    std::vector<Qubit> const qubits = {q0, q1};
+    Circuit expected;
+    expected.create_qubit("q0");
+    expected.create_qubit("q1");
+    for (uint32_t i = 0u; i < 100u; ++i) {
+        Instruction inst(Op::Rz(i * 0.5), target, {});
+        CHECK(writer.write_instruction(inst));
+        CHECK(writer.write_instruction(Instruction(Op::X(), qubits, {})));
+        expected.apply_operator(Op::Rz(i * 0.5), {q1});
+        expected.apply_operator(Op::X(), {q0, q1});
+    }
+    // Unsupported operators are not written
+    Instruction table(
+      Op::TruthTable(kitty::dynamic_truth_table(1)), qubits, {});
+    CHECK_FALSE(writer.write_instruction(table));
+    CHECK(writer.num_instructions() == 200u);
+    REQUIRE(writer.finish());
+
+    std::optional<binary::MappedCircuit> mapped =
+      binary::MappedCircuit::from_buffer(os.str());
+    REQUIRE(mapped);
+    check_equal(expected, mapped->load());
+}
+
+TEST_CASE("Binary files", "[binary][parser]")
+{
+    using namespace tweedledum;
+    std::string const path =
+      (std::filesystem::temp_directory_path() / "tweedledum_binary_test.twdl")
+        .string();
+    Circuit circuit = all_kinds();
+    REQUIRE(binary::write_file(circuit, path));
+    std::optional<Circuit> loaded = binary::read_file(path);
+    REQUIRE(loaded);
+    check_equal(circuit, *loaded);
+
+    // Corrupted files are rejected
+    std::ostringstream os;
+    REQUIRE(binary::write(circuit, os));
+    std::string buffer = os.str();
+    CHECK_FALSE(binary::MappedCircuit::from_buffer(buffer.substr(0, 40)));
+    buffer[0] = 'X';
+    CHECK_FALSE(binary::MappedCircuit::from_buffer(buffer));
+    std::remove(path.c_str());
+    CHECK_FALSE(binary::read_file(path));
+}
+
+TEST_CASE("Binary unsupported operators", "[binary][parser]")
+{
+    using namespace tweedledum;
+    Circuit circuit;
+    Qubit q0 = circuit.create_qubit();
+    Qubit q1 = circuit.create_qubit();
+    circuit.apply_operator(Op::H(), {q0});
+    circuit.apply_operator(
+      Op::TruthTable(kitty::dynamic_truth_table(1)), {q0, q1});
+    circuit.apply_operator(Op::X(), {q0, q1});
+
+    // Nothing is written
+    std::ostringstream os;
+    CHECK_FALSE(binary::write(circuit, os));
+    CHECK(os.str().empty());
+
+    std::string const path =
+      (std::filesystem::temp_directory_path() / "tweedledum_unsupported.twdl")
+        .string();
+    CHECK_FALSE(binary::write_file(circuit, path));
+    CHECK_FALSE(std::filesystem::exists(path));
+}
+
+TEST_CASE("Binary corrupted buffers", "[binary][parser]")
+{
+    using namespace tweedledum;
+    std::ostringstream os;
+    REQUIRE(binary::write(all_kinds(), os));
+    std::string const buffer = os.str();
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<uint32_t> position(0u, buffer.size() - 1);
+    std::uniform_int_distribution<uint32_t> bit(0u, 7u);
+    // Flipped bits must either be rejected at open or yield a loadable
+    // circuit, never a crash.
+    for (uint32_t i = 0u; i < 1000u; ++i) {
+        std::string corrupted = buffer;
+        for (uint32_t j = 0u; j < 3u; ++j) {
+            corrupted[position(gen)] ^= char(1u << bit(gen));
+        }
+        std::optional<binary::MappedCircuit> mapped =
+          binary::MappedCircuit::from_buffer(corrupted);
+        if (mapped) {
+            Circuit const loaded = mapped->load();
+            CHECK(loaded.num_instructions() == mapped->num_instructions());
+        }
+    }
+}
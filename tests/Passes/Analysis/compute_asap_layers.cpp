@@ -43,3 +43,20 @@ TEST_CASE("Compute intructions' ASAP layer", "[compute_asap_layers][analysis]")
         CHECK(expected == asap_layers);
     }
 }
+
+TEST_CASE("Compute ASAP layers of an edited circuit",
+  "[compute_asap_layers][analysis]")
+{
+    using namespace tweedledum;
+    Circuit circuit;
+    Qubit q0 = circuit.create_qubit();
+    Qubit q1 = circuit.create_qubit();
+    circuit.apply_operator(Op::X(), {q0});
+    InstRef const ref = circuit.apply_operator(Op::X(), {q1, q0});
+    circuit.apply_operator(Op::X(), {q1});
+    circuit.remove_instruction(ref);
+    circuit.insert_before(InstRef(0), Op::X(), {q1});
+    // Removed instructions keep layer 0
+    std::vector<uint32_t> expected = {0, 0, 1, 0};
+    CHECK(compute_asap_layers(circuit) == expected);
+}
@@ -0,0 +1,68 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/Passes/Analysis/compute_commutation_dag.h"
+
+#include "tweedledum/IR/Circuit.h"
+#include "tweedledum/Operators/All.h"
+
+#include <algorithm>
+#include <catch.hpp>
+#include <vector>
+
+TEST_CASE("Commutation DAG", "[compute_commutation_dag][analysis]")
+{
+    using namespace tweedledum;
+    Circuit circuit;
+    Qubit q0 = circuit.create_qubit();
+    Qubit q1 = circuit.create_qubit();
+    Qubit q2 = circuit.create_qubit();
+    Qubit q3 = circuit.create_qubit();
+    Cbit c0 = circuit.create_cbit();
+    InstRef const cx0 = circuit.apply_operator(Op::X(), {q0, q1});
+    InstRef const cx1 = circuit.apply_operator(Op::X(), {q0, q2});
+    InstRef const z = circuit.apply_operator(Op::Z(), {q0});
+    InstRef const cx2 = circuit.apply_operator(Op::X(), {q3, q1});
+    InstRef const h = circuit.apply_operator(Op::H(), {q0});
+    // Classified by their matrices
+    InstRef const u_rz =
+      circuit.apply_operator(Op::Unitary(Op::Rz(0.3).matrix()), {q1});
+    InstRef const u_rx =
+      circuit.apply_operator(Op::Unitary(Op::Rx(0.3).matrix()), {q2});
+    InstRef const m0 = circuit.apply_operator(Op::Measure(), {q3}, {c0});
+    InstRef const m1 = circuit.apply_operator(Op::Measure(), {q2}, {c0});
+
+    CommutationDag const dag = compute_commutation_dag(circuit);
+    // Shared control, and shared target
+    CHECK(dag.commute(cx0, cx1));
+    CHECK(dag.commute(cx0, z));
+    CHECK(dag.commute(cx0, cx2));
+    CHECK_FALSE(dag.commute(cx0, h));
+    CHECK_FALSE(dag.commute(cx0, u_rz));
+    CHECK(dag.commute(cx1, u_rx));
+    CHECK_FALSE(dag.commute(m0, m1));
+    CHECK(dag.commute(z, cx2));
+
+    std::vector<InstRef> predecessors;
+    dag.foreach_predecessor(
+      h, [&](InstRef ref) { predecessors.push_back(ref); });
+    CHECK(predecessors == std::vector<InstRef>({cx0, cx1, z}));
+    std::vector<InstRef> successors;
+    dag.foreach_successor(
+      cx2, [&](InstRef ref) { successors.push_back(ref); });
+    std::sort(successors.begin(), successors.end());
+    CHECK(successors == std::vector<InstRef>({u_rz, m0}));
+
+    // The group of the shared control
+    uint32_t const group = dag.groups(cx0)[0];
+    CHECK(dag.group_wire(group) == q0.uid());
+    CHECK(dag.group_action(group) == WireAction::diagonal);
+    CHECK(dag.members(group).size() == 3u);
+    CHECK(dag.next_group(group) == dag.groups(h)[0]);
+    CHECK(dag.previous_group(group) == CommutationDag::no_group);
+
+    std::vector<uint32_t> const levels = dag.levels();
+    CHECK(levels
+          == std::vector<uint32_t>({0u, 0u, 0u, 0u, 1u, 1u, 0u, 1u, 2u}));
+}
@@ -160,4 +160,22 @@ TEST_CASE("Compute intructions cuts with width 3", "[compute_cuts][analysis]")
         std::vector<Cut> computed = compute_cuts(circuit, 3u);
         CHECK(expected == computed);
     }
+    SECTION("Narrow cuts merge with the first cut that fits")
+    {
+        Qubit q3 = circuit.create_qubit();
+        Qubit q4 = circuit.create_qubit();
+        Qubit q5 = circuit.create_qubit();
+        circuit.apply_operator(Op::X(), {q0, q1});
+        circuit.apply_operator(Op::X(), {q2, q3});
+        circuit.apply_operator(Op::X(), {q4, q5});
+        circuit.apply_operator(Op::X(), {q5});
+        circuit.apply_operator(Op::X(), {q1, q2, q3});
+        std::vector<Cut> expected = {
+            Cut{{q0, q1}, {}, {InstRef(0)}},
+            Cut{{q1, q2, q3}, {}, {InstRef(1), InstRef(4)}},
+            Cut{{q4, q5}, {}, {InstRef(2), InstRef(3)}}
+        };
+        std::vector<Cut> computed = compute_cuts(circuit, 3u);
+        CHECK(expected == computed);
+    }
 }
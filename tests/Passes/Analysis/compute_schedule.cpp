@@ -0,0 +1,68 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/Passes/Analysis/compute_schedule.h"
+
+#include "tweedledum/IR/Circuit.h"
+#include "tweedledum/Operators/Standard.h"
+#include "tweedledum/Passes/Analysis/compute_depth.h"
+#include "tweedledum/Target/Device.h"
+
+#include <catch.hpp>
+#include <vector>
+
+TEST_CASE("Compute schedule", "[compute_schedule][analysis]")
+{
+    using namespace tweedledum;
+    Circuit circuit;
+    Qubit q0 = circuit.create_qubit();
+    Qubit q1 = circuit.create_qubit();
+    circuit.apply_operator(Op::H(), {q0});
+    circuit.apply_operator(Op::X(), {q1});
+    circuit.apply_operator(Op::X(), {q0, q1});
+    circuit.apply_operator(Op::H(), {q0});
+    circuit.apply_operator(Op::X(), {q1});
+
+    SECTION("Unit durations")
+    {
+        Schedule const schedule =
+          compute_schedule(circuit, [](Instruction const&) { return 1.0; });
+        CHECK(schedule.latency == compute_depth(circuit));
+        CHECK(schedule.start == std::vector<double>({0, 0, 1, 2, 2}));
+    }
+    SECTION("Operator and qubit durations")
+    {
+        Device device = Device::path(2u);
+        Durations& durations = device.durations();
+        durations.set("std.x", 2.0);
+        // A CX on (q0, q1), but not on (q1, q0)
+        durations.set("std.x", {0u, 1u}, 5.0);
+        Schedule const schedule = compute_schedule(circuit, device.durations());
+        CHECK(schedule.duration == std::vector<double>({1, 2, 5, 1, 2}));
+        CHECK(schedule.start == std::vector<double>({0, 0, 2, 7, 7}));
+        CHECK(schedule.slack == std::vector<double>({1, 0, 0, 1, 0}));
+        CHECK(schedule.latency == 9.0);
+        CHECK(schedule.finish(InstRef(3)) == 8.0);
+        std::vector<InstRef> const expected = {
+          InstRef(1), InstRef(2), InstRef(4)};
+        CHECK(schedule.critical_path == expected);
+
+        circuit.apply_operator(Op::X(), {q1, q0});
+        Schedule const longer = compute_schedule(circuit, device.durations());
+        CHECK(longer.duration.back() == 2.0);
+        CHECK(longer.latency == 11.0);
+    }
+    SECTION("Per-instruction durations")
+    {
+        InstructionTable<double>& durations = circuit.attribute("duration", 1.0);
+        durations[InstRef(0)] = 10.0;
+        Schedule const schedule = compute_schedule(circuit,
+          [&](InstRef ref, Instruction const&) { return durations[ref]; });
+        CHECK(schedule.latency == 12.0);
+        CHECK(schedule.slack.at(1) == 9.0);
+        std::vector<InstRef> const expected = {
+          InstRef(0), InstRef(2), InstRef(3)};
+        CHECK(schedule.critical_path == expected);
+    }
+}
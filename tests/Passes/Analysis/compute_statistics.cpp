@@ -0,0 +1,60 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/Passes/Analysis/compute_statistics.h"
+
+#include "tweedledum/IR/Circuit.h"
+#include "tweedledum/IR/OperatorKind.h"
+#include "tweedledum/IR/Parameter.h"
+#include "tweedledum/Operators/All.h"
+
+#include <catch.hpp>
+#include <vector>
+
+TEST_CASE("Compute statistics", "[compute_statistics][analysis]")
+{
+    using namespace tweedledum;
+    Circuit circuit;
+    Qubit q0 = circuit.create_qubit();
+    Qubit q1 = circuit.create_qubit();
+    Qubit q2 = circuit.create_qubit();
+    Cbit c0 = circuit.create_cbit();
+    circuit.apply_operator(Op::H(), {q0});
+    circuit.apply_operator(Op::T(), {q0});
+    circuit.apply_operator(Op::Tdg(), {q1});
+    circuit.apply_operator(Op::T(), {q0, q1});
+    circuit.apply_operator(Op::X(), {q0, q1});
+    circuit.apply_operator(Op::X(), {q0, q1, q2});
+    circuit.apply_operator(Op::Rz(0.5), {q2});
+    circuit.apply_operator(Op::Rxx(0.5), {q1, q2});
+    circuit.apply_operator(Op::Measure(), {q2}, {c0});
+
+    CircuitStatistics const stats = compute_statistics(circuit);
+    CHECK(stats.num_instructions == 9u);
+    CHECK(stats.count("std.x", 1u) == 1u);
+    CHECK(stats.count("std.x", 2u) == 1u);
+    CHECK(stats.count("std.x", 0u) == 0u);
+    CHECK(stats.count_all("std.x") == 2u);
+    CHECK(stats.count_all("std.t") == 2u);
+    CHECK(stats.count_all("std.y") == 0u);
+    // Querying unknown kinds does not register them
+    uint32_t const num_kinds = num_operator_kinds();
+    CHECK(stats.count("test.unknown_kind", 0u) == 0u);
+    CHECK(stats.count_all("test.unknown_kind") == 0u);
+    CHECK(num_operator_kinds() == num_kinds);
+    CHECK_FALSE(find_operator_kind("test.unknown_kind"));
+    CHECK(stats.by_qubit == std::vector<uint32_t>({5u, 5u, 4u}));
+    CHECK(stats.num_one_qubit == 5u);
+    CHECK(stats.num_two_qubit == 3u);
+    CHECK(stats.num_multi_qubit == 1u);
+    CHECK(stats.t_count == 2u);
+    CHECK(stats.num_rotations == 2u);
+
+    SECTION("Symbolic rotations")
+    {
+        circuit.apply_operator(
+          Op::Parametric::create<Op::Ry>(Parameter::symbol(0u)), {q0});
+        CHECK(compute_statistics(circuit).num_rotations == 3u);
+    }
+}
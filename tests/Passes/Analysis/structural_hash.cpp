@@ -0,0 +1,164 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/Passes/Analysis/structural_hash.h"
+
+#include "tweedledum/IR/Circuit.h"
+#include "tweedledum/Operators/Standard.h"
+#include "tweedledum/Utils/Cut.h"
+
+#include <catch.hpp>
+#include <unordered_map>
+
+TEST_CASE("Circuit structural hash", "[structural_hash][analysis]")
+{
+    using namespace tweedledum;
+    Circuit circuit;
+    Qubit q0 = circuit.create_qubit();
+    Qubit q1 = circuit.create_qubit();
+    Qubit q2 = circuit.create_qubit();
+    circuit.apply_operator(Op::H(), {q0});
+    circuit.apply_operator(Op::Rz(0.5), {q1});
+    circuit.apply_operator(Op::X(), {q0, q1});
+
+    // Independent instructions can be added in any order
+    Circuit reordered;
+    reordered.create_qubit();
+    reordered.create_qubit();
+    reordered.create_qubit();
+    reordered.apply_operator(Op::Rz(0.5), {q1});
+    reordered.apply_operator(Op::H(), {q0});
+    reordered.apply_operator(Op::X(), {q0, q1});
+    CHECK(circuit.structural_hash() == reordered.structural_hash());
+    CHECK(structurally_equal(circuit, reordered));
+
+    // The hash is kept up to date as instructions are added
+    circuit.apply_operator(Op::T(), {q2});
+    CHECK(circuit.structural_hash() != reordered.structural_hash());
+    CHECK_FALSE(structurally_equal(circuit, reordered));
+    reordered.apply_operator(Op::T(), {q2});
+    CHECK(circuit.structural_hash() == reordered.structural_hash());
+    CHECK(structurally_equal(circuit, reordered));
+
+    SECTION("Wires, parameters and controls matter")
+    {
+        Circuit other = reordered;
+        other.apply_operator(Op::H(), {q0});
+        circuit.apply_operator(Op::H(), {q1});
+        CHECK(circuit.structural_hash() != other.structural_hash());
+        CHECK_FALSE(structurally_equal(circuit, other));
+
+        Circuit swapped = reordered;
+        reordered.apply_operator(Op::X(), {q0, q2});
+        swapped.apply_operator(Op::X(), {q2, q0});
+        CHECK(reordered.structural_hash() != swapped.structural_hash());
+
+        Circuit negated = reordered;
+        reordered.apply_operator(Op::Rz(0.25), {q1});
+        negated.apply_operator(Op::Rz(-0.25), {q1});
+        CHECK(reordered.structural_hash() != negated.structural_hash());
+    }
+    SECTION("Position of the wire in the child")
+    {
+        // Same operators, but `H` acts on the control vs. target of `X`
+        Circuit other = reordered;
+        circuit.apply_operator(Op::H(), {q0});
+        other.apply_operator(Op::H(), {q1});
+        CHECK(circuit.structural_hash() != other.structural_hash());
+    }
+    SECTION("Global phase and wires")
+    {
+        Circuit other = reordered;
+        other.global_phase() += 0.5;
+        CHECK(circuit.structural_hash() != other.structural_hash());
+        CHECK_FALSE(structurally_equal(circuit, other));
+        reordered.create_cbit();
+        CHECK(circuit.structural_hash() != reordered.structural_hash());
+    }
+    SECTION("In-place edits")
+    {
+        InstRef const h = InstRef(0);
+        uint64_t const before = circuit.structural_hash();
+        uint64_t const h_hash = circuit.structural_hash(h);
+        circuit.insert_after(h, Op::S(), {q0});
+        CHECK(circuit.structural_hash() != before);
+        CHECK(circuit.structural_hash(h) == h_hash);
+        reordered.insert_after(InstRef(1), Op::S(), {q0});
+        CHECK(circuit.structural_hash() == reordered.structural_hash());
+        CHECK(structurally_equal(circuit, reordered));
+        circuit.compact();
+        CHECK(circuit.structural_hash() == reordered.structural_hash());
+    }
+}
+
+TEST_CASE("Structural hash of cuts", "[structural_hash][analysis]")
+{
+    using namespace tweedledum;
+    Circuit circuit;
+    Qubit q0 = circuit.create_qubit();
+    Qubit q1 = circuit.create_qubit();
+    Qubit q2 = circuit.create_qubit();
+    Qubit q3 = circuit.create_qubit();
+    std::vector<Cut> cuts;
+    auto block = [&](Qubit a, Qubit b) {
+        std::vector<InstRef> refs;
+        refs.push_back(circuit.apply_operator(Op::H(), {a}));
+        refs.push_back(circuit.apply_operator(Op::X(), {a, b}));
+        refs.push_back(circuit.apply_operator(Op::Rz(0.25), {b}));
+        refs.push_back(circuit.apply_operator(Op::X(), {a, b}));
+        cuts.emplace_back(
+          std::vector<Qubit>({a, b}), std::vector<Cbit>(), refs);
+    };
+    block(q0, q1);
+    block(q2, q3);
+    block(q1, q2);
+    InstRef const toffoli = circuit.apply_operator(Op::X(), {q0, q1, q2});
+    cuts.emplace_back(
+      std::vector<Qubit>({q0, q1, q2}), std::vector<Cbit>(), toffoli);
+    block(q3, q0);
+
+    std::unordered_map<uint64_t, std::vector<uint32_t>> cache;
+    for (uint32_t i = 0u; i < cuts.size(); ++i) {
+        cache[structural_hash(circuit, cuts.at(i))].push_back(i);
+    }
+    // The blocks on (q0, q1), (q2, q3) and (q1, q2) are identical, even though
+    // the last one follows other instructions.  The block on (q3, q0) acts on
+    // the wires of the cut (which are sorted) in the opposite order.
+    CHECK(cache.size() == 3u);
+    uint64_t const hash = structural_hash(circuit, cuts.at(0));
+    CHECK(cache.at(hash) == std::vector<uint32_t>({0u, 1u, 2u}));
+
+    // The hash of a cut is the hash of the circuit made of its instructions
+    Circuit expected;
+    Qubit a = expected.create_qubit();
+    Qubit b = expected.create_qubit();
+    expected.apply_operator(Op::H(), {a});
+    expected.apply_operator(Op::X(), {a, b});
+    expected.apply_operator(Op::Rz(0.25), {b});
+    expected.apply_operator(Op::X(), {a, b});
+    CHECK(expected.structural_hash() == hash);
+
+    // A cut with all instructions
+    std::vector<InstRef> all;
+    circuit.foreach_instruction([&](InstRef ref) { all.push_back(ref); });
+    Cut const whole(circuit.qubits(), circuit.cbits(), all);
+    CHECK(structural_hash(circuit, whole) == circuit.structural_hash());
+
+    // In an edited circuit, references don't follow the program order
+    Circuit edited;
+    Qubit const e0 = edited.create_qubit();
+    Qubit const e1 = edited.create_qubit();
+    InstRef const h = edited.apply_operator(Op::H(), {e0});
+    edited.apply_operator(Op::X(), {e0, e1});
+    edited.insert_after(h, Op::T(), {e0});
+    auto whole_cut = [](Circuit const& c) {
+        std::vector<InstRef> refs;
+        c.foreach_instruction([&](InstRef ref) { refs.push_back(ref); });
+        return Cut(c.qubits(), c.cbits(), refs);
+    };
+    uint64_t const edited_hash = structural_hash(edited, whole_cut(edited));
+    CHECK(edited_hash == edited.structural_hash());
+    edited.compact();
+    CHECK(structural_hash(edited, whole_cut(edited)) == edited_hash);
+}
@@ -0,0 +1,111 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/Passes/Decomposition/subcircuit_decomp.h"
+
+#include "tweedledum/IR/Circuit.h"
+#include "tweedledum/Operators/Extension/Subcircuit.h"
+#include "tweedledum/Operators/Standard.h"
+#include "tweedledum/Passes/Analysis/structural_hash.h"
+#include "tweedledum/Passes/Utility/inverse.h"
+
+#include <catch.hpp>
+#include <memory>
+
+using namespace tweedledum;
+
+namespace {
+// One (Grover-like) iteration
+Circuit iteration()
+{
+    Circuit circuit;
+    Qubit q0 = circuit.create_qubit();
+    Qubit q1 = circuit.create_qubit();
+    Qubit q2 = circuit.create_qubit();
+    circuit.apply_operator(Op::X(), {q0, q1, q2});
+    circuit.apply_operator(Op::H(), {q0});
+    circuit.apply_operator(Op::T(), {q1});
+    circuit.apply_operator(Op::Rz(0.3), {q2});
+    circuit.apply_operator(Op::X(), {q2, q0});
+    circuit.global_phase() = 0.25;
+    return circuit;
+}
+} // namespace
+
+TEST_CASE("Inline subcircuits", "[subcircuit_decomp][decomp]")
+{
+    Circuit const body = iteration();
+    Op::Subcircuit const subcircuit(body);
+
+    Circuit circuit;
+    Qubit q0 = circuit.create_qubit();
+    Qubit q1 = circuit.create_qubit();
+    Qubit q2 = circuit.create_qubit();
+    Circuit flat = circuit;
+    for (uint32_t i = 0u; i < 8u; ++i) {
+        circuit.apply_operator(subcircuit, {q0, q1, q2});
+        circuit.apply_operator(Op::H(), {q2});
+        flat.append(body, {q0, q1, q2}, {});
+        flat.global_phase() += body.global_phase();
+        flat.apply_operator(Op::H(), {q2});
+    }
+    CHECK(circuit.num_instructions() == 16u);
+    CHECK(subcircuit.shared_body().use_count() == 9);
+
+    Circuit decomposed = subcircuit_decomp(circuit);
+    CHECK(structurally_equal(decomposed, flat));
+    CHECK(decomposed.structural_hash() == flat.structural_hash());
+
+    SECTION("Adjoint")
+    {
+        std::optional<Circuit> adjoint = inverse(circuit);
+        REQUIRE(adjoint);
+        CHECK(adjoint->num_instructions() == 16u);
+        std::optional<Circuit> flat_adjoint = inverse(flat);
+        REQUIRE(flat_adjoint);
+        flat_adjoint->global_phase() = -flat.global_phase();
+        CHECK(structurally_equal(subcircuit_decomp(*adjoint), *flat_adjoint));
+    }
+    SECTION("Nested and permuted wires")
+    {
+        Circuit outer;
+        Qubit a = outer.create_qubit();
+        Qubit b = outer.create_qubit();
+        Qubit c = outer.create_qubit();
+        Qubit d = outer.create_qubit();
+        outer.apply_operator(
+          Op::Subcircuit(std::make_shared<Circuit const>(circuit)),
+          {d, a, c});
+        outer.apply_operator(subcircuit, {b, c, a});
+        outer.apply_operator(*subcircuit.adjoint(), {c, b, d});
+
+        Circuit expected;
+        for (uint32_t i = 0u; i < 4u; ++i) {
+            expected.create_qubit();
+        }
+        expected.append(flat, {d, a, c}, {});
+        expected.append(body, {b, c, a}, {});
+        expected.append(*inverse(body), {c, b, d}, {});
+        expected.global_phase() = flat.global_phase();
+
+        Circuit const decomposed_outer = subcircuit_decomp(outer);
+        CHECK(structurally_equal(decomposed_outer, expected));
+    }
+    SECTION("Operators without adjoint")
+    {
+        Circuit measured;
+        Qubit q = measured.create_qubit();
+        Cbit c = measured.create_cbit();
+        measured.apply_operator(Op::Measure(), {q}, {c});
+        Op::Subcircuit const measure(measured);
+        CHECK_FALSE(measure.adjoint());
+
+        Circuit other;
+        other.create_qubit();
+        other.create_cbit();
+        other.apply_operator(measure, {q}, {c});
+        CHECK_FALSE(inverse(other));
+        CHECK(structurally_equal(subcircuit_decomp(other), measured));
+    }
+}
@@ -0,0 +1,171 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/Passes/Optimization/commutative_cancellation.h"
+
+#include "tweedledum/IR/Circuit.h"
+#include "tweedledum/Operators/All.h"
+#include "tweedledum/Utils/Numbers.h"
+
+#include "../check_unitary.h"
+
+#include <catch.hpp>
+#include <random>
+
+using namespace tweedledum;
+
+TEST_CASE(
+  "Commutative cancellation", "[commutative_cancellation][optimization]")
+{
+    Circuit circuit;
+    Qubit q0 = circuit.create_qubit();
+    Qubit q1 = circuit.create_qubit();
+    Qubit q2 = circuit.create_qubit();
+    SECTION("Merge T powers across a control")
+    {
+        circuit.apply_operator(Op::T(), {q0});
+        circuit.apply_operator(Op::X(), {q0, q1});
+        circuit.apply_operator(Op::T(), {q0});
+        Circuit optimized = commutative_cancellation(circuit);
+        CHECK(optimized.num_instructions() == 2u);
+        CHECK(optimized.instruction(InstRef(0)).is_a<Op::S>());
+        CHECK(check_unitary(circuit, optimized));
+    }
+    SECTION("Cancel CX across a CX sharing the control")
+    {
+        circuit.apply_operator(Op::X(), {q0, q1});
+        circuit.apply_operator(Op::X(), {q0, q2});
+        circuit.apply_operator(Op::X(), {q0, q1});
+        Circuit optimized = commutative_cancellation(circuit);
+        CHECK(optimized.num_instructions() == 1u);
+        CHECK(check_unitary(circuit, optimized));
+    }
+    SECTION("Merge rotations")
+    {
+        circuit.apply_operator(Op::Rz(0.25), {q1});
+        circuit.apply_operator(Op::X(), {q1, q0});
+        circuit.apply_operator(Op::Rz(0.5), {q1});
+        circuit.apply_operator(Op::Rx(0.25), {q0});
+        circuit.apply_operator(Op::Rx(-0.25), {q0});
+        Circuit optimized = commutative_cancellation(circuit);
+        CHECK(optimized.num_instructions() == 2u);
+        CHECK(optimized.instruction(InstRef(0)).angle() == 0.75);
+        CHECK(check_unitary(circuit, optimized));
+    }
+    SECTION("Do not merge when the product is not a single gate")
+    {
+        circuit.apply_operator(Op::T(), {q0});
+        circuit.apply_operator(Op::S(), {q0});
+        Circuit optimized = commutative_cancellation(circuit);
+        CHECK(optimized.num_instructions() == 2u);
+    }
+    SECTION("Do not cancel across non-commuting instructions")
+    {
+        circuit.apply_operator(Op::T(), {q0});
+        circuit.apply_operator(Op::H(), {q0});
+        circuit.apply_operator(Op::Tdg(), {q0});
+        circuit.apply_operator(Op::X(), {q1, q0});
+        circuit.apply_operator(Op::Rx(0.5), {q1});
+        circuit.apply_operator(Op::X(), {q1, q0});
+        Circuit optimized = commutative_cancellation(circuit);
+        CHECK(optimized.num_instructions() == 6u);
+    }
+    SECTION("Fixed point")
+    {
+        // Cancelling the inner pair of H makes the outer CX pair cancel.
+        circuit.apply_operator(Op::X(), {q0, q1});
+        circuit.apply_operator(Op::H(), {q0});
+        circuit.apply_operator(Op::H(), {q0});
+        circuit.apply_operator(Op::X(), {q0, q1});
+        circuit.apply_operator(Op::Sx(), {q2});
+        circuit.apply_operator(Op::Sx(), {q2});
+        circuit.apply_operator(Op::X(), {q2});
+        Circuit optimized = commutative_cancellation(circuit);
+        CHECK(optimized.num_instructions() == 0u);
+        CHECK(check_unitary(circuit, optimized));
+    }
+    SECTION("Nested pairs")
+    {
+        // H·Y·H·Y···Y·H·Y·H: each pair only cancels once the pairs nested in
+        // it are gone.
+        constexpr uint32_t depth = 20000u;
+        for (uint32_t i = 0u; i < depth; ++i) {
+            if (i % 2u == 0u) {
+                circuit.apply_operator(Op::H(), {q0});
+            } else {
+                circuit.apply_operator(Op::Y(), {q0});
+            }
+        }
+        for (uint32_t i = depth; i-- > 0u;) {
+            if (i % 2u == 0u) {
+                circuit.apply_operator(Op::H(), {q0});
+            } else {
+                circuit.apply_operator(Op::Y(), {q0});
+            }
+        }
+        circuit.apply_operator(Op::T(), {q1});
+        Circuit optimized = commutative_cancellation(circuit);
+        CHECK(optimized.num_instructions() == 1u);
+    }
+    SECTION("Preserve global phase")
+    {
+        circuit.global_phase() = numbers::pi_div_4;
+        circuit.apply_operator(Op::P(numbers::pi), {q0});
+        circuit.apply_operator(Op::P(numbers::pi), {q0});
+        Circuit optimized = commutative_cancellation(circuit);
+        CHECK(optimized.num_instructions() == 0u);
+        CHECK(optimized.global_phase() == numbers::pi_div_4);
+    }
+    SECTION("Random circuits")
+    {
+        std::mt19937 rng(42u);
+        std::uniform_int_distribution<uint32_t> gate(0u, 9u);
+        std::uniform_int_distribution<uint32_t> qubit(0u, 2u);
+        for (uint32_t i = 0u; i < 100u; ++i) {
+            Circuit random;
+            random.create_qubit();
+            random.create_qubit();
+            random.create_qubit();
+            for (uint32_t j = 0u; j < 24u; ++j) {
+                Qubit const target(qubit(rng));
+                Qubit const control((target + 1u + (rng() % 2u)) % 3u);
+                switch (gate(rng)) {
+                case 0u:
+                    random.apply_operator(Op::T(), {target});
+                    break;
+                case 1u:
+                    random.apply_operator(Op::Tdg(), {target});
+                    break;
+                case 2u:
+                    random.apply_operator(Op::S(), {target});
+                    break;
+                case 3u:
+                    random.apply_operator(Op::H(), {target});
+                    break;
+                case 4u:
+                    random.apply_operator(Op::Sx(), {target});
+                    break;
+                case 5u:
+                    random.apply_operator(Op::Rz(0.5), {target});
+                    break;
+                case 6u:
+                    random.apply_operator(Op::Rx(0.25), {target});
+                    break;
+                case 7u:
+                    random.apply_operator(Op::Rzz(0.5), {control, target});
+                    break;
+                default:
+                    random.apply_operator(Op::X(), {control, target});
+                    break;
+                }
+            }
+            Circuit optimized = commutative_cancellation(random);
+            CHECK(optimized.num_instructions() <= random.num_instructions());
+            CHECK(check_unitary(random, optimized));
+            // A single pass reaches the fixed point
+            CHECK(commutative_cancellation(optimized).num_instructions()
+                  == optimized.num_instructions());
+        }
+    }
+}
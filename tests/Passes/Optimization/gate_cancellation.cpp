@@ -158,3 +158,20 @@ TEST_CASE("Inverted circuits.", "[gate_cancellation][optimization]")
         CHECK(optimized.num_instructions() == 0u);
     }
 }
+
+TEST_CASE("Gate cancellation of an edited circuit",
+  "[gate_cancellation][optimization]")
+{
+    Circuit circuit;
+    Qubit const q0 = circuit.create_qubit();
+    Qubit const q1 = circuit.create_qubit();
+    circuit.apply_operator(Op::H(), {q0});
+    InstRef const ref = circuit.apply_operator(Op::X(), {q0, q1});
+    circuit.apply_operator(Op::H(), {q0});
+    circuit.apply_operator(Op::T(), {q1});
+    circuit.remove_instruction(ref);
+    circuit.insert_after(InstRef(3), Op::Tdg(), {q1});
+    auto optimized = gate_cancellation(circuit);
+    CHECK(optimized.num_instructions() == 0);
+    CHECK(check_unitary(circuit, optimized));
+}
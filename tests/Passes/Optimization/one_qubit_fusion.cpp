@@ -0,0 +1,149 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/Passes/Optimization/one_qubit_fusion.h"
+
+#include "tweedledum/IR/Circuit.h"
+#include "tweedledum/Operators/All.h"
+
+#include "../check_unitary.h"
+
+#include <catch.hpp>
+#include <random>
+
+using namespace tweedledum;
+
+TEST_CASE("One qubit fusion", "[one_qubit_fusion][optimization]")
+{
+    Circuit circuit;
+    Qubit q0 = circuit.create_qubit();
+    Qubit q1 = circuit.create_qubit();
+    SECTION("Identity up to global phase")
+    {
+        circuit.apply_operator(Op::H(), {q0});
+        circuit.apply_operator(Op::S(), {q0});
+        circuit.apply_operator(Op::S(), {q0});
+        circuit.apply_operator(Op::H(), {q0});
+        circuit.apply_operator(Op::X(), {q0});
+        Circuit optimized = one_qubit_fusion(circuit);
+        CHECK(optimized.num_instructions() == 0u);
+        CHECK(check_unitary(circuit, optimized));
+    }
+    SECTION("Runs end at multi-qubit instructions")
+    {
+        circuit.apply_operator(Op::H(), {q0});
+        circuit.apply_operator(Op::T(), {q0});
+        circuit.apply_operator(Op::Sx(), {q0});
+        circuit.apply_operator(Op::Rz(0.3), {q0});
+        circuit.apply_operator(Op::T(), {q1});
+        circuit.apply_operator(Op::X(), {q0, q1});
+        circuit.apply_operator(Op::Tdg(), {q1});
+        circuit.apply_operator(Op::S(), {q1});
+        circuit.apply_operator(Op::H(), {q1});
+        Circuit optimized = one_qubit_fusion(circuit);
+        CHECK(optimized.num_instructions() <= 8u);
+        CHECK(check_unitary(circuit, optimized));
+    }
+    SECTION("Keep runs that are already short")
+    {
+        circuit.apply_operator(Op::H(), {q0});
+        circuit.apply_operator(Op::X(), {q0, q1});
+        circuit.apply_operator(Op::H(), {q0});
+        Circuit optimized = one_qubit_fusion(circuit);
+        CHECK(optimized.num_instructions() == 3u);
+        CHECK(optimized.instruction(InstRef(0)).is_a<Op::H>());
+    }
+    SECTION("Instructions without a matrix end runs")
+    {
+        circuit.apply_operator(Op::H(), {q0});
+        circuit.apply_operator(
+          Op::Parametric::create<Op::Rz>(Parameter::symbol(0u)), {q0});
+        circuit.apply_operator(Op::H(), {q0});
+        Circuit optimized = one_qubit_fusion(circuit);
+        CHECK(optimized.num_instructions() == 3u);
+    }
+    SECTION("Bases")
+    {
+        std::mt19937 rng(1u);
+        std::uniform_real_distribution<double> angle(-3.0, 3.0);
+        for (uint32_t i = 0u; i < 8u; ++i) {
+            circuit.apply_operator(Op::Rz(angle(rng)), {q0});
+            circuit.apply_operator(Op::H(), {q0});
+            circuit.apply_operator(Op::Ry(angle(rng)), {q0});
+            circuit.apply_operator(Op::Sx(), {q0});
+        }
+        std::vector<std::string> bases = {
+          "zyz", "zxz", "xyx", "px", "psx", "zsx"};
+        for (auto const& basis : bases) {
+            nlohmann::json config;
+            config["one_qubit_decomp"]["basis"] = basis;
+            Circuit optimized = one_qubit_fusion(circuit, config);
+            INFO("Basis is: " << basis);
+            CHECK(optimized.num_instructions() <= 5u);
+            CHECK(check_unitary(circuit, optimized));
+        }
+    }
+}
+
+TEST_CASE("One qubit fusion keeps the exact global phase",
+  "[one_qubit_fusion][optimization]")
+{
+    std::vector<std::string> bases = {"zyz", "zxz", "xyx", "px", "psx", "zsx"};
+    std::mt19937 rng(2u);
+    std::uniform_real_distribution<double> angle(-3.0, 3.0);
+    std::uniform_int_distribution<uint32_t> gate(0u, 7u);
+    auto add_gate = [&](Circuit& circuit, Qubit qubit, uint32_t kind) {
+        switch (kind) {
+        case 0u:
+            circuit.apply_operator(Op::H(), {qubit});
+            break;
+        case 1u:
+            circuit.apply_operator(Op::X(), {qubit});
+            break;
+        case 2u:
+            circuit.apply_operator(Op::Sx(), {qubit});
+            break;
+        case 3u:
+            circuit.apply_operator(Op::Ry(angle(rng)), {qubit});
+            break;
+        case 4u:
+            circuit.apply_operator(Op::Rx(angle(rng)), {qubit});
+            break;
+        case 5u:
+            circuit.apply_operator(Op::T(), {qubit});
+            break;
+        case 6u:
+            circuit.apply_operator(Op::Rz(angle(rng)), {qubit});
+            break;
+        default:
+            circuit.apply_operator(Op::P(angle(rng)), {qubit});
+            break;
+        }
+    };
+    for (auto const& basis : bases) {
+        INFO("Basis is: " << basis);
+        nlohmann::json config;
+        config["one_qubit_decomp"]["basis"] = basis;
+        // Diagonal runs
+        for (uint32_t i = 0u; i < 50u; ++i) {
+            Circuit circuit;
+            Qubit q0 = circuit.create_qubit();
+            for (uint32_t j = 0u; j < 4u; ++j) {
+                add_gate(circuit, q0, 5u + (gate(rng) % 3u));
+            }
+            Circuit optimized = one_qubit_fusion(circuit, config);
+            CHECK(check_unitary(circuit, optimized));
+        }
+        // Random runs
+        for (uint32_t i = 0u; i < 200u; ++i) {
+            Circuit circuit;
+            Qubit q0 = circuit.create_qubit();
+            for (uint32_t j = 0u; j < 4u; ++j) {
+                add_gate(circuit, q0, gate(rng));
+            }
+            Circuit optimized = one_qubit_fusion(circuit, config);
+            CHECK(check_unitary(circuit, optimized));
+        }
+    }
+}
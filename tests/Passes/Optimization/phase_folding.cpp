@@ -6,6 +6,8 @@
 
 #include "tweedledum/IR/Circuit.h"
 #include "tweedledum/Operators/All.h"
+#include "tweedledum/Passes/Analysis/compute_statistics.h"
+#include "tweedledum/Utils/Numbers.h"
 
 #include "../check_unitary.h"
 
@@ -40,4 +42,67 @@ TEST_CASE("Trivial phase folding", "[phase_folding][optimization]")
         CHECK(optimized.num_instructions() == 1u);
         CHECK(check_unitary(circuit, optimized));
     }
+    SECTION("Lone rotation")
+    {
+        Circuit circuit;
+        Qubit q0 = circuit.create_qubit();
+        circuit.apply_operator(Op::T(), {q0});
+
+        Circuit optimized = phase_folding(circuit);
+        CHECK(optimized.num_instructions() == 1u);
+        CHECK(check_unitary(circuit, optimized));
+    }
+    SECTION("Negated parity")
+    {
+        Circuit circuit;
+        Qubit q0 = circuit.create_qubit();
+        circuit.global_phase() = numbers::pi_div_4;
+        circuit.apply_operator(Op::X(), {q0});
+        circuit.apply_operator(Op::T(), {q0});
+        circuit.apply_operator(Op::X(), {q0});
+        circuit.apply_operator(Op::T(), {q0});
+
+        Circuit optimized = phase_folding(circuit);
+        CHECK(optimized.num_instructions() == 2u);
+        CHECK(check_unitary(circuit, optimized));
+    }
+}
+
+TEST_CASE("Phase folding through CX", "[phase_folding][optimization]")
+{
+    using namespace tweedledum;
+    Circuit circuit;
+    Qubit q0 = circuit.create_qubit();
+    Qubit q1 = circuit.create_qubit();
+    Qubit q2 = circuit.create_qubit();
+    SECTION("Fold")
+    {
+        circuit.apply_operator(Op::H(), {q0});
+        circuit.apply_operator(Op::X(), {q0, q1});
+        circuit.apply_operator(Op::T(), {q1});
+        circuit.apply_operator(Op::X(), {q0, q1});
+        circuit.apply_operator(Op::X(), {q1, q0});
+        circuit.apply_operator(Op::T(), {q0});
+        circuit.apply_operator(Op::Rz(0.25), {q2});
+        circuit.apply_operator(Op::H(), {q0});
+
+        Circuit optimized = phase_folding(circuit);
+        // Both T act on the same parity, so they become one S.
+        CHECK(optimized.num_instructions() == 7u);
+        CHECK(compute_statistics(optimized).count_all(Op::S::kind()) == 1u);
+        CHECK(check_unitary(circuit, optimized));
+    }
+    SECTION("Non-phase instructions")
+    {
+        circuit.apply_operator(Op::T(), {q2});
+        circuit.apply_operator(Op::X(), {q0, q1, q2});
+        circuit.apply_operator(Op::Tdg(), {q2});
+        circuit.apply_operator(Op::Rx(0.5), {q1});
+        circuit.apply_operator(Op::T(), {q1});
+        circuit.apply_operator(Op::Z(), {q0, q1});
+
+        Circuit optimized = phase_folding(circuit);
+        CHECK(optimized.num_instructions() == 6u);
+        CHECK(check_unitary(circuit, optimized));
+    }
 }
@@ -0,0 +1,187 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/Passes/Optimization/two_qubit_resynth.h"
+
+#include "tweedledum/Decomposition/TwoQubitDecomposer.h"
+#include "tweedledum/IR/Circuit.h"
+#include "tweedledum/Operators/All.h"
+#include "tweedledum/Passes/Analysis/compute_statistics.h"
+
+#include "../check_unitary.h"
+
+#include <catch.hpp>
+#include <random>
+#include <vector>
+
+using namespace tweedledum;
+
+namespace {
+
+uint32_t num_two_qubit(Circuit const& circuit)
+{
+    uint32_t count = 0u;
+    circuit.foreach_instruction([&](Instruction const& inst) {
+        count += inst.num_qubits() == 2u;
+    });
+    return count;
+}
+
+} // namespace
+
+TEST_CASE("Two-qubit decomposition", "[two_qubit_resynth][decomposition]")
+{
+    std::mt19937 rng(1u);
+    std::uniform_real_distribution<double> angle(-3.0, 3.0);
+    TwoQubitDecomposer decomposer;
+    Circuit circuit;
+    Qubit q0 = circuit.create_qubit();
+    Qubit q1 = circuit.create_qubit();
+    auto add_locals = [&]() {
+        circuit.apply_operator(Op::Rz(angle(rng)), {q0});
+        circuit.apply_operator(Op::Ry(angle(rng)), {q0});
+        circuit.apply_operator(Op::Rx(angle(rng)), {q1});
+        circuit.apply_operator(Op::Rz(angle(rng)), {q1});
+    };
+    uint32_t expected = 0u;
+    SECTION("Local")
+    {
+        add_locals();
+        add_locals();
+    }
+    SECTION("CX")
+    {
+        add_locals();
+        circuit.apply_operator(Op::X(), {q1, q0});
+        add_locals();
+        expected = 1u;
+    }
+    SECTION("Rzz")
+    {
+        add_locals();
+        circuit.apply_operator(Op::Rzz(angle(rng)), {q0, q1});
+        add_locals();
+        expected = 2u;
+    }
+    SECTION("Swap")
+    {
+        circuit.apply_operator(Op::Swap(), {q0, q1});
+        add_locals();
+        expected = 3u;
+    }
+    SECTION("Generic")
+    {
+        for (uint32_t i = 0u; i < 4u; ++i) {
+            add_locals();
+            circuit.apply_operator(Op::X(), {q0, q1});
+            circuit.apply_operator(Op::Ry(angle(rng)), {q1});
+            circuit.apply_operator(Op::X(), {q1, q0});
+        }
+        expected = 3u;
+    }
+    Op::UnitaryBuilder builder(2u, circuit.global_phase());
+    circuit.foreach_instruction([&](Instruction const& inst) {
+        builder.apply_operator(inst, inst.qubits());
+    });
+    UMatrix const matrix = builder.finished().matrix();
+    CHECK(decomposer.num_cx(matrix) == expected);
+
+    Circuit decomposed;
+    decomposed.create_qubit();
+    decomposed.create_qubit();
+    std::vector<Qubit> const qubits = {q0, q1};
+    Instruction const inst(Op::Unitary(matrix), qubits, {});
+    CHECK(decomposer.decompose(decomposed, inst));
+    CHECK(num_two_qubit(decomposed) == expected);
+    CHECK(check_unitary(circuit, decomposed));
+}
+
+TEST_CASE("Two-qubit resynthesis", "[two_qubit_resynth][optimization]")
+{
+    Circuit circuit;
+    Qubit q0 = circuit.create_qubit();
+    Qubit q1 = circuit.create_qubit();
+    Qubit q2 = circuit.create_qubit();
+    SECTION("Cancelling CX")
+    {
+        circuit.apply_operator(Op::X(), {q0, q1});
+        circuit.apply_operator(Op::Rz(0.3), {q0});
+        circuit.apply_operator(Op::X(), {q0, q1});
+        Circuit optimized = two_qubit_resynth(circuit);
+        CHECK(num_two_qubit(optimized) == 0u);
+        CHECK(check_unitary(circuit, optimized));
+    }
+    SECTION("Swap and CX")
+    {
+        circuit.apply_operator(Op::Swap(), {q0, q1});
+        circuit.apply_operator(Op::X(), {q0, q1});
+        Circuit optimized = two_qubit_resynth(circuit);
+        CHECK(compute_statistics(optimized).count_all(Op::X::kind()) == 2u);
+        CHECK(num_two_qubit(optimized) == 2u);
+        CHECK(check_unitary(circuit, optimized));
+    }
+    SECTION("Keep blocks that are already optimal")
+    {
+        circuit.apply_operator(Op::H(), {q0});
+        circuit.apply_operator(Op::X(), {q0, q1});
+        circuit.apply_operator(Op::X(), {q1, q2});
+        Circuit optimized = two_qubit_resynth(circuit);
+        CHECK(optimized.num_instructions() == 3u);
+        CHECK(check_unitary(circuit, optimized));
+    }
+    SECTION("Edited circuit")
+    {
+        circuit.apply_operator(Op::X(), {q0, q1});
+        InstRef const ref = circuit.apply_operator(Op::H(), {q2});
+        circuit.apply_operator(Op::X(), {q0, q1});
+        circuit.remove_instruction(ref);
+        circuit.insert_after(InstRef(0), Op::Rz(0.3), {q0});
+        Circuit optimized = two_qubit_resynth(circuit);
+        CHECK(num_two_qubit(optimized) == 0u);
+        CHECK(check_unitary(circuit, optimized));
+    }
+    SECTION("Negative controls")
+    {
+        circuit.apply_operator(Op::X(), {!q0, q1});
+        circuit.apply_operator(Op::X(), {q0, q1});
+        Circuit optimized = two_qubit_resynth(circuit);
+        CHECK(optimized.num_instructions() == 2u);
+    }
+    SECTION("Random circuits")
+    {
+        std::mt19937 rng(1u);
+        std::uniform_real_distribution<double> angle(-3.0, 3.0);
+        std::vector<Qubit> qubits = {q0, q1, q2};
+        for (uint32_t i = 0u; i < 50u; ++i) {
+            Circuit random;
+            random.create_qubit();
+            random.create_qubit();
+            random.create_qubit();
+            for (uint32_t j = 0u; j < 30u; ++j) {
+                Qubit const a = qubits.at(rng() % 3u);
+                Qubit const b = qubits.at((a + 1u + rng() % 2u) % 3u);
+                switch (rng() % 4u) {
+                case 0u:
+                    random.apply_operator(Op::X(), {a, b});
+                    break;
+
+                case 1u:
+                    random.apply_operator(Op::Rz(angle(rng)), {a});
+                    break;
+
+                case 2u:
+                    random.apply_operator(Op::H(), {a});
+                    break;
+
+                default:
+                    random.apply_operator(Op::Swap(), {a, b});
+                    break;
+                }
+            }
+            Circuit optimized = two_qubit_resynth(random);
+            CHECK(num_two_qubit(optimized) <= num_two_qubit(random));
+            CHECK(check_unitary(random, optimized));
+        }
+    }
+}
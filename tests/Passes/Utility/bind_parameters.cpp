@@ -0,0 +1,133 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/Passes/Utility/bind_parameters.h"
+
+#include "tweedledum/IR/Circuit.h"
+#include "tweedledum/Operators/All.h"
+#include "tweedledum/Passes/Mapping/sabre_map.h"
+#include "tweedledum/Passes/Utility/inverse.h"
+#include "tweedledum/Target/Device.h"
+
+#include "../check_inverse.h"
+
+#include <catch.hpp>
+
+namespace {
+using namespace tweedledum;
+
+Circuit parametric_circuit()
+{
+    Parameter const theta = Parameter::symbol(0);
+    Parameter const phi = Parameter::symbol(1);
+    Circuit circuit;
+    Qubit q0 = circuit.create_qubit();
+    Qubit q1 = circuit.create_qubit();
+    Qubit q2 = circuit.create_qubit();
+    Qubit q3 = circuit.create_qubit();
+    circuit.apply_operator(Op::H(), {q0});
+    circuit.apply_operator(Op::Parametric::create<Op::Rx>(theta), {q0});
+    circuit.apply_operator(Op::X(), {q0, q3});
+    circuit.apply_operator(
+      Op::Parametric::create<Op::U>(phi, theta * 2.0 + 1.0, 0.5), {q3});
+    circuit.apply_operator(Op::X(), {q1, q3});
+    circuit.apply_operator(Op::Parametric::create<Op::Rzz>(-phi), {q1, q2});
+    circuit.apply_operator(Op::Rz(0.25), {q2});
+    circuit.apply_operator(Op::X(), {q2, q0});
+    return circuit;
+}
+
+Operator const& operator_at(Circuit const& circuit, uint32_t const ref)
+{
+    return circuit.instruction(InstRef(ref));
+}
+
+void check_same(Circuit const& expected, Circuit const& actual)
+{
+    REQUIRE(expected.num_instructions() == actual.num_instructions());
+    expected.foreach_instruction([&](InstRef ref, Instruction const& inst) {
+        CHECK(inst == actual.instruction(ref));
+        CHECK(inst.qubits() == actual.instruction(ref).qubits());
+    });
+}
+} // namespace
+
+TEST_CASE("Parameters", "[bind_parameters][utility]")
+{
+    using namespace tweedledum;
+    std::vector<double> const values = {0.5, -2.0};
+    Parameter const x = Parameter::symbol(1);
+    CHECK(x.evaluate(values) == -2.0);
+    CHECK((-x).evaluate(values) == 2.0);
+    CHECK((x * 0.5 + 1.0).evaluate(values) == 0.0);
+    CHECK(Parameter(3.0).is_constant());
+    CHECK(Parameter(3.0).evaluate({}) == 3.0);
+
+    Op::Parametric const rx = Op::Parametric::create<Op::Rx>(x);
+    CHECK(rx.target_kind() == Op::Rx::kind());
+    CHECK(rx.bind(values) == Operator(Op::Rx(-2.0)));
+    CHECK(rx.adjoint().bind(values) == Operator(Op::Rx(2.0)));
+    CHECK(Op::Parametric::create<Op::Rxx>(x).num_targets() == 2u);
+}
+
+TEST_CASE("Bind parameters", "[bind_parameters][utility]")
+{
+    using namespace tweedledum;
+    Circuit const circuit = parametric_circuit();
+    CHECK(num_parameters(circuit) == 2u);
+
+    Circuit const bound = bind_parameters(circuit, {0.5, -2.0});
+    CHECK(operator_at(bound, 1) == Operator(Op::Rx(0.5)));
+    CHECK(operator_at(bound, 3) == Operator(Op::U(-2.0, 2.0, 0.5)));
+    CHECK(operator_at(bound, 5) == Operator(Op::Rzz(2.0)));
+    CHECK(operator_at(bound, 6) == operator_at(circuit, 6));
+    CHECK(num_parameters(bound) == 0u);
+
+    // Bind many times
+    std::vector<std::vector<double>> values;
+    for (uint32_t i = 0u; i < 8u; ++i) {
+        values.push_back({0.1 * i, -0.3 * i});
+    }
+    std::vector<Circuit> const batch = batch_bind_parameters(circuit, values);
+    REQUIRE(batch.size() == values.size());
+    for (uint32_t i = 0u; i < values.size(); ++i) {
+        check_same(bind_parameters(circuit, values.at(i)), batch.at(i));
+    }
+
+    // Taking the adjoint commutes with binding
+    std::optional<Circuit> adjoint = inverse(circuit);
+    REQUIRE(adjoint);
+    Circuit const bound_adjoint = bind_parameters(*adjoint, {0.5, -2.0});
+    CHECK(check_inverse(bound, bound_adjoint));
+}
+
+TEST_CASE("Bind mapped parametric circuits", "[bind_parameters][utility]")
+{
+    using namespace tweedledum;
+    Circuit const circuit = parametric_circuit();
+    Device const device = Device::path(circuit.num_qubits());
+    // Map once, bind many times
+    auto [mapped, mapping] = sabre_map(device, circuit);
+    std::vector<std::vector<double>> const values = {{0.5, -2.0}, {1., 3.}};
+    std::vector<Circuit> const batch = batch_bind_parameters(mapped, values);
+    for (uint32_t i = 0u; i < values.size(); ++i) {
+        Circuit const bound = bind_parameters(circuit, values.at(i));
+        auto [expected, expected_mapping] = sabre_map(device, bound);
+        CHECK(expected_mapping.init_placement == mapping.init_placement);
+        check_same(expected, batch.at(i));
+    }
+}
+
+TEST_CASE("Bind too few parameters", "[bind_parameters][utility]")
+{
+    using namespace tweedledum;
+    Circuit const circuit = parametric_circuit();
+    CHECK_THROWS_AS(bind_parameters(circuit, {0.5}), std::out_of_range);
+    CHECK_THROWS_AS(batch_bind_parameters(circuit, {{0.5, -2.0}, {}}),
+      std::out_of_range);
+    Op::Parametric const rx =
+      Op::Parametric::create<Op::Rx>(Parameter::symbol(2));
+    std::vector<double> const values = {0.5, -2.0};
+    CHECK_THROWS_AS(rx.bind(values), std::out_of_range);
+}
@@ -0,0 +1,87 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/Utils/LinPhasePoly.h"
+
+#include "tweedledum/Utils/ThreadPool.h"
+
+#include <algorithm>
+#include <catch.hpp>
+#include <utility>
+#include <vector>
+
+TEST_CASE("Add and extract terms", "[LinPhasePoly]")
+{
+    using namespace tweedledum;
+    LinPhasePoly poly;
+    poly.add_term(0b101u, 0.5);
+    poly.add_term({2u, 6u}, 0.25);
+    poly.add_term(0b010u, 1.0);
+    CHECK(poly.size() == 2u);
+
+    CHECK(poly.extract_phase({2u, 6u}) == 0.75);
+    CHECK(poly.size() == 1u);
+    CHECK(poly.extract_phase(0b101u) == 0.0);
+    CHECK(poly.extract_phase(0b001u) == 0.0);
+    CHECK(poly.extract_phase(0b010u) == 1.0);
+    CHECK(poly.size() == 0u);
+}
+
+TEST_CASE("Iterate in order of parity", "[LinPhasePoly]")
+{
+    using namespace tweedledum;
+    LinPhasePoly poly;
+    for (uint32_t i = 1u; i < 16u; ++i) {
+        poly.add_term(i, i);
+    }
+    poly.extract_phase(0b0001u);
+    poly.extract_phase(0b1010u);
+    poly.add_term(0b0001u, 1.0);
+
+    std::vector<LinPhasePoly::Parity> parities;
+    for (auto const& [parity, angle] : poly) {
+        (void) angle;
+        parities.push_back(parity);
+    }
+    CHECK(parities.size() == 14u);
+    CHECK(std::is_sorted(parities.begin(), parities.end()));
+    CHECK(poly.extract_phase(0b0011u) == 3.0);
+    CHECK(poly.extract_phase(0b0001u) == 1.0);
+    CHECK(poly.size() == 12u);
+}
+
+TEST_CASE("Copy, move and iterate concurrently", "[LinPhasePoly]")
+{
+    using namespace tweedledum;
+    LinPhasePoly poly;
+    for (uint32_t i = 255u; i > 0u; --i) {
+        poly.add_term(i, i);
+    }
+    LinPhasePoly const copy = poly;
+    CHECK(copy.size() == 255u);
+    CHECK(copy.begin()->first == LinPhasePoly::Parity({2u}));
+
+    // The moved polynomial is still unsorted: the first iterations race to
+    // sort it.
+    LinPhasePoly const moved = std::move(poly);
+    std::vector<uint8_t> sorted(16u, 0u);
+    ThreadPool pool(4u);
+    pool.parallel_for(0u, sorted.size(), [&](uint32_t const i) {
+        std::vector<LinPhasePoly::Parity> parities;
+        for (auto const& [parity, angle] : moved) {
+            (void) angle;
+            parities.push_back(parity);
+        }
+        sorted.at(i) = parities.size() == 255u
+                    && std::is_sorted(parities.begin(), parities.end());
+    });
+    CHECK(std::all_of(
+      sorted.begin(), sorted.end(), [](uint8_t ok) { return ok == 1u; }));
+
+    LinPhasePoly other = copy;
+    CHECK(other.extract_phase(0b1u) == 1.0);
+    CHECK(other.extract_phase({2u, 4u}) == 3.0);
+    CHECK(copy.size() == 255u);
+    CHECK(other.size() == 253u);
+}
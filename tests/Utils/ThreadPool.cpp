@@ -0,0 +1,59 @@
+/*------------------------------------------------------------------------------
+| Part of Tweedledum Project.  This file is distributed under the MIT License.
+| See accompanying file /LICENSE for details.
+*-----------------------------------------------------------------------------*/
+#include "tweedledum/Utils/ThreadPool.h"
+
+#include <algorithm>
+#include <atomic>
+#include <catch.hpp>
+#include <stdexcept>
+#include <vector>
+
+TEST_CASE("Thread pool parallel for", "[thread_pool][utils]")
+{
+    using namespace tweedledum;
+    for (uint32_t num_threads : {1u, 2u, 4u}) {
+        ThreadPool pool(num_threads);
+        CHECK(pool.num_threads() == num_threads);
+        // Each iteration is run exactly once, and all are done on return
+        for (uint32_t size : {0u, 1u, 7u, 1000u}) {
+            std::vector<uint32_t> hits(size, 0u);
+            pool.parallel_for(0u, size, [&](uint32_t i) { hits.at(i) += 1; });
+            CHECK(std::all_of(hits.begin(), hits.end(),
+              [](uint32_t h) { return h == 1u; }));
+        }
+        std::atomic<uint64_t> sum = 0u;
+        pool.parallel_for(10u, 110u, [&](uint32_t i) { sum += i; });
+        CHECK(sum == 5950u);
+    }
+}
+
+TEST_CASE("Thread pool exceptions", "[thread_pool][utils]")
+{
+    using namespace tweedledum;
+    for (uint32_t num_threads : {1u, 4u}) {
+        ThreadPool pool(num_threads);
+        // Every iteration throws, so the exception comes from the calling
+        // thread and from the workers.
+        std::atomic<uint32_t> calls = 0u;
+        CHECK_THROWS_AS(pool.parallel_for(0u, 1000u,
+                          [&](uint32_t) {
+                              ++calls;
+                              throw std::runtime_error("iteration");
+                          }),
+          std::runtime_error);
+        CHECK(calls <= 1000u);
+        CHECK_THROWS_AS(pool.parallel_for(0u, 1000u,
+                          [&](uint32_t i) {
+                              if (i == 999u) {
+                                  throw std::runtime_error("last");
+                              }
+                          }),
+          std::runtime_error);
+        // The pool remains usable
+        std::atomic<uint64_t> sum = 0u;
+        pool.parallel_for(10u, 110u, [&](uint32_t i) { sum += i; });
+        CHECK(sum == 5950u);
+    }
+}